@@ -0,0 +1,156 @@
+/**
+ * @brief accuracy and cost of each ENUM_GEO_PRECISION.
+ * @details Error is measured against Vincenty for points at 10 m to 1000 km in every direction.
+ * Cost is measured for batch and single point calls. Fails if an error exceeds the bound
+ * documented in gps_geodesy.hpp.
+ *
+ */
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/helpers/gps_geodesy.hpp"
+
+
+#define SPHERE_RADIUS           6372797.56085
+#define POINT_COUNT             4096
+#define BATCH_ROUNDS            200
+
+
+static const char* PRECISION_NAMES[] = {"LOCAL_ENU", "EQUIRECTANGULAR", "HAVERSINE", "VINCENTY"};
+
+
+/**
+ * @brief destination on sphere. Only used to place test points.
+ *
+ */
+static POINT_2D destination (const double lat, const double lng, const double bearing, const double distance)
+{
+    const double angle = distance / SPHERE_RADIUS;
+    const double lat1 = lat * M_PI / 180.0;
+    const double lat2 = asin(sin(lat1) * cos(angle) + cos(lat1) * sin(angle) * cos(bearing));
+    const double lng2 = atan2(sin(bearing) * sin(angle) * cos(lat1), cos(angle) - sin(lat1) * sin(lat2));
+
+    POINT_2D point;
+    point.latitude = lat2 * 180.0 / M_PI;
+    point.longitude = lng + lng2 * 180.0 / M_PI;
+    if (point.longitude > 180.0) point.longitude -= 360.0;
+    if (point.longitude < -180.0) point.longitude += 360.0;
+
+    return point;
+}
+
+
+/**
+ * @brief max relative error against Vincenty [%].
+ *
+ */
+static double maxError (const double lat, const double lng, const double distance, const ENUM_GEO_PRECISION precision)
+{
+    double max_error = 0;
+    for (int degrees = 0; degrees < 360; degrees += 15)
+    {
+        const POINT_2D point = destination(lat, lng, degrees * M_PI / 180.0, distance);
+        const double reference = calcVincentyDistance(lat, lng, point.latitude, point.longitude);
+        const double value = calcGPSDistance(lat, lng, point.latitude, point.longitude, precision);
+        max_error = std::max(max_error, fabs(value - reference) / reference * 100.0);
+    }
+
+    return max_error;
+}
+
+
+int main ()
+{
+    // error bound [%] up to max distance [m].
+    const struct { ENUM_GEO_PRECISION precision; double distance; double bound; } bounds[] = {
+        {GEO_PRECISION_LOCAL_ENU, 10000, 0.5},
+        {GEO_PRECISION_LOCAL_ENU, 100000, 1.0},
+        {GEO_PRECISION_EQUIRECTANGULAR, 1000000, 0.5},
+        {GEO_PRECISION_HAVERSINE, 1000000, 0.5}
+    };
+    const double distances[] = {10, 100, 1000, 10000, 100000, 1000000};
+
+    int failures = 0;
+
+    // longitude 179.5 so long legs cross the antimeridian.
+    for (const double lng : {10.0, 179.5})
+    {
+        for (const double lat : {30.0, 60.0})
+        {
+            printf("latitude %g longitude %g\n", lat, lng);
+            for (const double distance : distances)
+            {
+                printf("  %8g m:", distance);
+                std::string failed;
+                for (int precision = GEO_PRECISION_LOCAL_ENU; precision < GEO_PRECISION_VINCENTY; ++precision)
+                {
+                    const double error = maxError(lat, lng, distance, (ENUM_GEO_PRECISION) precision);
+                    printf("  %s %.3f%%", PRECISION_NAMES[precision], error);
+
+                    for (const auto& bound : bounds)
+                    {
+                        if ((bound.precision == precision) && (distance <= bound.distance) && (error > bound.bound))
+                        {
+                            failed += std::string("FAIL: ") + PRECISION_NAMES[precision] + " error above " + std::to_string(bound.bound) + "%\n";
+                            failures++;
+                            break;
+                        }
+                    }
+                }
+                printf("\n%s", failed.c_str());
+            }
+        }
+    }
+
+    // Vincenty reference: Flinders Peak to Buninyong is 54972.271 m.
+    const double vincenty = calcVincentyDistance(-37.95103342, 144.42486789, -37.65282114, 143.92649554);
+    if (fabs(vincenty - 54972.271) > 0.01)
+    {
+        std::cout << "FAIL: Vincenty distance " << vincenty << std::endl;
+        failures++;
+    }
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<double> uniform(-0.05, 0.05);
+    std::vector<POINT_2D> points(POINT_COUNT);
+    std::vector<double> distances_out(POINT_COUNT);
+    for (POINT_2D& point : points)
+    {
+        point.latitude = 30.0 + uniform(random);
+        point.longitude = 31.0 + uniform(random);
+    }
+
+    volatile double sum = 0;
+    for (int precision = GEO_PRECISION_LOCAL_ENU; precision <= GEO_PRECISION_VINCENTY; ++precision)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int round = 0; round < BATCH_ROUNDS; ++round)
+        {
+            calcGPSDistances(30.0, 31.0, points.data(), POINT_COUNT, distances_out.data(), (ENUM_GEO_PRECISION) precision);
+            sum = sum + distances_out[round % POINT_COUNT];
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        for (int round = 0; round < BATCH_ROUNDS; ++round)
+        {
+            for (int i = 0; i < POINT_COUNT; ++i)
+            {
+                distances_out[i] = calcGPSDistance(30.0, 31.0, points[i].latitude, points[i].longitude, (ENUM_GEO_PRECISION) precision);
+            }
+            sum = sum + distances_out[round % POINT_COUNT];
+        }
+        const auto t2 = std::chrono::steady_clock::now();
+
+        const double calls = (double) BATCH_ROUNDS * POINT_COUNT;
+        printf("%-16s batch %6.1f ns/point  single %6.1f ns/point\n", PRECISION_NAMES[precision],
+            std::chrono::duration<double, std::nano>(t1 - t0).count() / calls,
+            std::chrono::duration<double, std::nano>(t2 - t1).count() / calls);
+    }
+
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+/**
+ * @brief geofence hit testing of vehicle positions.
+ * @details Tests random positions against circle, polygon and line fences by calling isInside()
+ * on every fence, then on fences returned by CGeoFenceGridIndex only. Both should find the same hits.
+ *
+ */
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <all/mavlink.h>
+
+#include "../src/de_common/helpers/json_nlohmann.hpp"
+using Json_de = nlohmann::json;
+
+#include "../src/geofence/fcb_geo_fence_index.hpp"
+
+using namespace de::fcb::geofence;
+
+
+#define FENCE_COUNT             1000
+#define POSITION_COUNT          10000
+
+
+static std::unique_ptr<CGeoFenceBase> createFence (const int type, const std::string& name, const std::vector<POINT_2D>& points, const int radius)
+{
+    Json_de fence = {{"t", type}, {"n", name}, {"o", 1}, {"a", 0}, {"r", radius}, {"c", (int) points.size()}};
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        fence[std::to_string(i)] = {{"a", points[i].latitude}, {"g", points[i].longitude}};
+    }
+
+    return CGeoFenceFactory::getInstance().getGeoFenceObject(fence);
+}
+
+
+int main ()
+{
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> uniform(0, 1);
+
+    // fences scattered over 5 x 5 deg.
+    std::vector<std::unique_ptr<CGeoFenceBase>> fences;
+    for (int i = 0; i < FENCE_COUNT; ++i)
+    {
+        const double lat = 30.0 + 5.0 * uniform(random);
+        const double lng = 31.0 + 5.0 * uniform(random);
+        const std::string name = "fence_" + std::to_string(i);
+        std::vector<POINT_2D> points;
+
+        switch (i % 3)
+        {
+            case 0:
+                points.push_back({lat, lng});
+                fences.push_back(createFence(3, name, points, 2000));
+                break;
+
+            case 1:
+                for (int k = 0; k < 12; ++k)
+                {
+                    const double angle = k * 2 * M_PI / 12;
+                    const double radius = 0.01 + 0.01 * uniform(random);
+                    points.push_back({lat + radius * cos(angle), lng + radius * sin(angle)});
+                }
+                fences.push_back(createFence(2, name, points, 0));
+                break;
+
+            default:
+                for (int k = 0; k < 6; ++k)
+                {
+                    points.push_back({lat + 0.005 * k, lng + 0.004 * uniform(random)});
+                }
+                fences.push_back(createFence(1, name, points, 100));
+                break;
+        }
+    }
+
+    std::vector<POINT_2D> positions(POSITION_COUNT);
+    for (POINT_2D& position : positions)
+    {
+        position.latitude = 30.0 + 5.0 * uniform(random);
+        position.longitude = 31.0 + 5.0 * uniform(random);
+    }
+
+    std::vector<T_GEO_BOUNDING_BOX> boxes;
+    for (const std::unique_ptr<CGeoFenceBase>& fence : fences) boxes.push_back(fence->getBoundingBox());
+    CGeoFenceGridIndex fence_index;
+    fence_index.build(boxes);
+
+    std::vector<std::vector<int>> hits_all(POSITION_COUNT);
+    std::vector<std::vector<int>> hits_indexed(POSITION_COUNT);
+    std::vector<int> candidates;
+    std::size_t candidates_count = 0;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t p = 0; p < positions.size(); ++p)
+    {
+        for (std::size_t i = 0; i < fences.size(); ++i)
+        {
+            if (fences[i]->isInside(positions[p].latitude, positions[p].longitude, 0) <= 0) hits_all[p].push_back(i);
+        }
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    for (std::size_t p = 0; p < positions.size(); ++p)
+    {
+        fence_index.query(positions[p].latitude, positions[p].longitude, candidates);
+        candidates_count += candidates.size();
+        for (const int i : candidates)
+        {
+            if (fences[i]->isInside(positions[p].latitude, positions[p].longitude, 0) <= 0) hits_indexed[p].push_back(i);
+        }
+    }
+    const auto t2 = std::chrono::steady_clock::now();
+
+    int failures = 0;
+    std::size_t hits = 0;
+    for (std::size_t p = 0; p < positions.size(); ++p)
+    {
+        std::sort(hits_indexed[p].begin(), hits_indexed[p].end());
+        if (hits_all[p] != hits_indexed[p]) failures++;
+        hits += hits_all[p].size();
+    }
+
+    if (failures > 0)
+    {
+        std::cout << "FAIL: index misses hits at " << failures << " positions" << std::endl;
+    }
+
+    printf("fences: %d positions: %d hits: %zu candidates per position: %.2f\n",
+        FENCE_COUNT, POSITION_COUNT, hits, (double) candidates_count / POSITION_COUNT);
+    printf("every fence     %.2f us/position\n", std::chrono::duration<double, std::micro>(t1 - t0).count() / POSITION_COUNT);
+    printf("grid index      %.3f us/position\n", std::chrono::duration<double, std::micro>(t2 - t1).count() / POSITION_COUNT);
+
+    return (failures == 0) ? 0 : 1;
+}
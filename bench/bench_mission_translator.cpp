@@ -0,0 +1,165 @@
+/**
+ * @brief translation of large QGC plan and Mission Planner files.
+ * @details Generates a survey sized mission then times CMissionTranslator against a full
+ * nlohmann DOM parse of the same plan. Items are compared with those read from the DOM.
+ *
+ */
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <all/mavlink.h>
+
+#include "../src/de_common/helpers/json_nlohmann.hpp"
+using Json_de = nlohmann::json;
+
+#include "../src/de_common/de_databus/messages.hpp"
+#include "../src/mission/mission_translator.hpp"
+
+
+#define WAYPOINT_COUNT          10000
+#define COMPLEX_ITEM_EVERY      1000        // one complex item per this number of waypoints.
+#define TRANSLATE_ROUNDS        10
+
+
+static void buildPlans (std::string& qgc_plan, std::string& mp_plan)
+{
+    char buffer[512];
+
+    qgc_plan = "{\"fileType\":\"Plan\",\"groundStation\":\"QGroundControl\",\"version\":1,\"mission\":{\"cruiseSpeed\":15,\"items\":[";
+    mp_plan = "QGC WPL 110\n0\t1\t0\t16\t0\t0\t0\t0\t47.000000\t8.000000\t400.000000\t1\n";
+
+    for (int i = 0; i < WAYPOINT_COUNT; ++i)
+    {
+        const double lat = 47.0 + (i % 100) * 0.0001;
+        const double lng = 8.0 + (i / 100) * 0.0001;
+
+        if (i > 0) qgc_plan += ",";
+
+        if ((i % COMPLEX_ITEM_EVERY) == (COMPLEX_ITEM_EVERY - 1))
+        {
+            // survey with a single transect waypoint.
+            snprintf(buffer, sizeof(buffer),
+                "{\"TransectStyleComplexItem\":{\"CameraCalc\":{\"AdjustedFootprintFrontal\":25},\"Items\":["
+                "{\"autoContinue\":true,\"command\":16,\"frame\":3,\"params\":[0,0,0,null,%.7f,%.7f,50],\"type\":\"SimpleItem\"}]},"
+                "\"complexItemType\":\"survey\",\"polygon\":[[%.7f,%.7f]],\"type\":\"ComplexItem\",\"version\":5}",
+                lat, lng, lat, lng);
+        }
+        else
+        {
+            snprintf(buffer, sizeof(buffer),
+                "{\"autoContinue\":true,\"command\":16,\"doJumpId\":%d,\"frame\":3,\"params\":[0,0,0,null,%.7f,%.7f,50],\"type\":\"SimpleItem\"}",
+                i + 1, lat, lng);
+        }
+        qgc_plan += buffer;
+
+        snprintf(buffer, sizeof(buffer), "%d\t0\t3\t16\t0.000000\t0.000000\t0.000000\t0.000000\t%.7f\t%.7f\t50.000000\t1\n",
+            i + 1, lat, lng);
+        mp_plan += buffer;
+    }
+
+    qgc_plan += "],\"plannedHomePosition\":[47.0,8.0,400]}}";
+}
+
+
+/**
+ * @brief reads items the way translator did before it was streamed. Used as reference.
+ *
+ */
+static std::vector<mavlink_mission_item_int_t> readDOM (const Json_de& plan)
+{
+    std::vector<mavlink_mission_item_int_t> items;
+    items.push_back(mavlink_mission_item_int_t());
+
+    for (const Json_de& item : plan["mission"]["items"])
+    {
+        std::vector<const Json_de*> simple_items;
+        if (item["type"] == "ComplexItem")
+        {
+            for (const Json_de& complex_item : item["TransectStyleComplexItem"]["Items"]) simple_items.push_back(&complex_item);
+        }
+        else
+        {
+            simple_items.push_back(&item);
+        }
+
+        for (const Json_de* simple_item : simple_items)
+        {
+            mavlink_mission_item_int_t mavlink_mission_item = mavlink_mission_item_int_t();
+            mavlink_mission_item.seq = items.size();
+            mavlink_mission_item.command = (*simple_item)["command"].get<int>();
+            mavlink_mission_item.x = (*simple_item)["params"][4].get<double>() * 10000000;
+            mavlink_mission_item.y = (*simple_item)["params"][5].get<double>() * 10000000;
+            items.push_back(mavlink_mission_item);
+        }
+    }
+
+    return items;
+}
+
+
+static int compare (const char* name, const std::vector<mavlink_mission_item_int_t>& items, const std::vector<mavlink_mission_item_int_t>& reference)
+{
+    if (items.size() != reference.size())
+    {
+        std::cout << "FAIL: " << name << " has " << items.size() << " items instead of " << reference.size() << std::endl;
+        return 1;
+    }
+
+    for (std::size_t i = 1; i < items.size(); ++i)
+    {
+        if ((items[i].seq != i) || (items[i].command != reference[i].command)
+            || (std::abs(items[i].x - reference[i].x) > 1) || (std::abs(items[i].y - reference[i].y) > 1))
+        {
+            std::cout << "FAIL: " << name << " item " << i << " differs" << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+int main ()
+{
+    std::string qgc_plan;
+    std::string mp_plan;
+    buildPlans(qgc_plan, mp_plan);
+
+    de::fcb::mission::CMissionTranslator mission_translator;
+    std::vector<mavlink_mission_item_int_t> qgc_items;
+    std::vector<mavlink_mission_item_int_t> mp_items;
+    std::vector<mavlink_mission_item_int_t> reference;
+
+    int failures = 0;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int round = 0; round < TRANSLATE_ROUNDS; ++round)
+    {
+        if (!mission_translator.translateMissionText(qgc_plan, qgc_items)) failures++;
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    for (int round = 0; round < TRANSLATE_ROUNDS; ++round)
+    {
+        reference = readDOM(Json_de::parse(qgc_plan));
+    }
+    const auto t2 = std::chrono::steady_clock::now();
+    for (int round = 0; round < TRANSLATE_ROUNDS; ++round)
+    {
+        if (!mission_translator.translateMissionText(mp_plan, mp_items)) failures++;
+    }
+    const auto t3 = std::chrono::steady_clock::now();
+
+    failures += compare("QGC plan", qgc_items, reference);
+    failures += compare("Mission Planner file", mp_items, reference);
+
+    printf("waypoints: %d\n", WAYPOINT_COUNT);
+    printf("QGC plan            %.2f ms\n", std::chrono::duration<double, std::milli>(t1 - t0).count() / TRANSLATE_ROUNDS);
+    printf("QGC plan DOM        %.2f ms\n", std::chrono::duration<double, std::milli>(t2 - t1).count() / TRANSLATE_ROUNDS);
+    printf("Mission Planner     %.2f ms\n", std::chrono::duration<double, std::milli>(t3 - t2).count() / TRANSLATE_ROUNDS);
+
+    return (failures == 0) ? 0 : 1;
+}
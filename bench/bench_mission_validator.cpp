@@ -0,0 +1,137 @@
+/**
+ * @brief mission legs against geofences.
+ * @details Validates a random walk mission against small exclusion fences and one large
+ * inclusion fence, then tests every leg against every exclusion fence as reference.
+ *
+ */
+#include <iostream>
+#include <cstdio>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <all/mavlink.h>
+
+#include "../src/de_common/helpers/json_nlohmann.hpp"
+using Json_de = nlohmann::json;
+
+#include "../src/de_common/de_databus/messages.hpp"
+#include "../src/helpers/gps.hpp"
+#include "../src/geofence/fcb_geo_fence_mission_validator.hpp"
+
+using namespace de::fcb::geofence;
+
+
+#define LEG_COUNT               10000
+#define EXCLUSION_FENCES        500
+
+
+static std::unique_ptr<CGeoFenceBase> createCircle (const std::string& name, const double lat, const double lng, const int radius, const bool keep_outside)
+{
+    const Json_de fence = {{"t", 3}, {"n", name}, {"o", keep_outside ? 1 : 0}, {"a", 0}, {"r", radius},
+                           {"0", {{"a", lat}, {"g", lng}}}};
+
+    return CGeoFenceFactory::getInstance().getGeoFenceObject(fence);
+}
+
+
+static std::unique_ptr<CGeoFenceBase> createSquare (const std::string& name, const double lat, const double lng, const double size)
+{
+    const Json_de fence = {{"t", 2}, {"n", name}, {"o", 1}, {"a", 0}, {"r", 0}, {"c", 4},
+                           {"0", {{"a", lat}, {"g", lng}}},
+                           {"1", {{"a", lat}, {"g", lng + size}}},
+                           {"2", {{"a", lat + size}, {"g", lng + size}}},
+                           {"3", {{"a", lat + size}, {"g", lng}}}};
+
+    return CGeoFenceFactory::getInstance().getGeoFenceObject(fence);
+}
+
+
+int main ()
+{
+    std::mt19937 random(1);
+    std::uniform_real_distribution<double> uniform(0, 0.5);
+
+    // random walk inside a 0.5 x 0.5 deg square.
+    std::vector<de::fcb::mission::T_MISSION_LEG> legs(LEG_COUNT);
+    double lat = 30.0;
+    double lng = 31.0;
+    for (int i = 0; i < LEG_COUNT; ++i)
+    {
+        lat = std::min(30.5, std::max(30.0, lat + (uniform(random) - 0.25) * 0.01));
+        lng = std::min(31.5, std::max(31.0, lng + (uniform(random) - 0.25) * 0.01));
+
+        de::fcb::mission::T_MISSION_LEG& leg = legs[i];
+        leg.seq = i + 1;
+        leg.latitude = lat;
+        leg.longitude = lng;
+        leg.altitude = 50;
+        leg.length = 0;
+        leg.bearing = 0;
+        leg.altitude_change = 0;
+    }
+
+    std::vector<std::unique_ptr<CGeoFenceBase>> fences;
+    std::vector<CGeoFenceBase*> fence_pointers;
+    for (int i = 0; i < EXCLUSION_FENCES; ++i)
+    {
+        const std::string name = "fence_" + std::to_string(i);
+        if (i % 2)
+        {
+            fences.push_back(createCircle(name, 30.0 + uniform(random), 31.0 + uniform(random), 50, true));
+        }
+        else
+        {
+            fences.push_back(createSquare(name, 30.0 + uniform(random), 31.0 + uniform(random), 0.001));
+        }
+        fence_pointers.push_back(fences.back().get());
+    }
+    fences.push_back(createCircle("inclusion", 30.25, 31.25, 40000, false));
+    fence_pointers.push_back(fences.back().get());
+
+    std::vector<T_MISSION_FENCE_VIOLATION> violations;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    CGeoFenceMissionValidator().validate(legs, fence_pointers, violations);
+    const auto t1 = std::chrono::steady_clock::now();
+
+    std::set<std::pair<int, std::string>> reference;
+    for (std::size_t i = 0; i < legs.size(); ++i)
+    {
+        const de::fcb::mission::T_MISSION_LEG& from = legs[(i == 0) ? 0 : i - 1];
+        const de::fcb::mission::T_MISSION_LEG& to = legs[i];
+        for (CGeoFenceBase* fence : fence_pointers)
+        {
+            if (!fence->shouldKeepOutside()) continue;
+
+            double distance;
+            bool fully_inside;
+            if (!fence->testSegment(from.latitude, from.longitude, to.latitude, to.longitude, distance, fully_inside)) continue;
+            if (distance <= 0) reference.insert(std::make_pair(to.seq, fence->getName()));
+        }
+    }
+    const auto t2 = std::chrono::steady_clock::now();
+
+    std::set<std::pair<int, std::string>> found;
+    for (const T_MISSION_FENCE_VIOLATION& violation : violations)
+    {
+        if (violation.fence_name != "inclusion") found.insert(std::make_pair(violation.seq, violation.fence_name));
+    }
+
+    int failures = 0;
+    if (found != reference)
+    {
+        std::cout << "FAIL: validator found " << found.size() << " exclusion violations instead of " << reference.size() << std::endl;
+        failures++;
+    }
+
+    printf("legs: %d fences: %zu violations: %zu\n", LEG_COUNT, fence_pointers.size(), reference.size());
+    printf("validator       %.2f ms\n", std::chrono::duration<double, std::milli>(t1 - t0).count());
+    printf("every fence     %.2f ms\n", std::chrono::duration<double, std::milli>(t2 - t1).count());
+
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+/**
+ * @brief parameter lookup by name.
+ * @details Loads an ArduPilot sized parameter list into CMavlinkParameterManager then looks up
+ * every name in random order using findParameter() and a std::map<std::string> keyed by name.
+ *
+ */
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <all/mavlink.h>
+#include <mavlink_parameter_manager.h>
+
+
+#define PARAM_COUNT             1200
+#define LOOKUP_ROUNDS           200
+
+
+static const char* PARAM_PREFIXES[] = {"SERVO", "RC", "BATT", "COMPASS_OFS", "INS_ACC", "INS_GYR", "SR0_", "SR1_",
+                                       "EK3_SRC", "WPNAV_P", "ATC_RAT_", "PSC_VEL", "FENCE_", "MNT1_", "CAM", "LOG_"};
+
+
+int main ()
+{
+    mavlinksdk::CCallBack_Parameter callback_parameter;
+    mavlinksdk::CMavlinkParameterManager& parameter_manager = mavlinksdk::CMavlinkParameterManager::getInstance();
+    parameter_manager.set_callback_parameter(&callback_parameter);
+
+    std::vector<std::string> names;
+    std::map<std::string, mavlink_param_value_t> parameters_map;
+
+    for (uint16_t i = 0; i < PARAM_COUNT; ++i)
+    {
+        mavlink_param_value_t param_value = {0};
+        snprintf(param_value.param_id, sizeof(param_value.param_id), "%s%u",
+            PARAM_PREFIXES[i % (sizeof(PARAM_PREFIXES) / sizeof(PARAM_PREFIXES[0]))], i);
+        param_value.param_value = i;
+        param_value.param_type = MAV_PARAM_TYPE_REAL32;
+        param_value.param_count = PARAM_COUNT;
+        param_value.param_index = i;
+
+        parameter_manager.handle_param_value(param_value);
+
+        const std::string name = std::string(param_value.param_id, strnlen(param_value.param_id, 16));
+        names.push_back(name);
+        parameters_map[name] = param_value;
+    }
+
+    std::mt19937 random(1);
+    std::shuffle(names.begin(), names.end(), random);
+
+    int failures = 0;
+    volatile float sum = 0;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int round = 0; round < LOOKUP_ROUNDS; ++round)
+    {
+        for (const std::string& name : names)
+        {
+            const mavlink_param_value_t* parameter = parameter_manager.findParameter(name.c_str());
+            if (parameter == nullptr)
+            {
+                failures++;
+                continue;
+            }
+            sum = sum + parameter->param_value;
+        }
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    for (int round = 0; round < LOOKUP_ROUNDS; ++round)
+    {
+        for (const std::string& name : names)
+        {
+            // old table was keyed by std::string built from 16 char param_id.
+            const auto it = parameters_map.find(std::string(name.c_str()));
+            if (it == parameters_map.end())
+            {
+                failures++;
+                continue;
+            }
+            sum = sum + it->second.param_value;
+        }
+    }
+    const auto t2 = std::chrono::steady_clock::now();
+
+    for (const std::string& name : names)
+    {
+        const mavlink_param_value_t* parameter = parameter_manager.findParameter(name.c_str());
+        if ((parameter == nullptr) || (parameter->param_value != parameters_map[name].param_value))
+        {
+            std::cout << "FAIL: " << name << " resolves to wrong parameter" << std::endl;
+            failures++;
+        }
+    }
+
+    if (parameter_manager.findParameter("NOT_A_PARAM") != nullptr)
+    {
+        std::cout << "FAIL: unknown name resolves" << std::endl;
+        failures++;
+    }
+
+    const double lookups = (double) LOOKUP_ROUNDS * PARAM_COUNT;
+    printf("parameters: %d\n", PARAM_COUNT);
+    printf("findParameter  %.1f ns/lookup\n", std::chrono::duration<double, std::nano>(t1 - t0).count() / lookups);
+    printf("std::map       %.1f ns/lookup\n", std::chrono::duration<double, std::nano>(t2 - t1).count() / lookups);
+
+    return (failures == 0) ? 0 : 1;
+}
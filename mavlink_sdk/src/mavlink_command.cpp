@@ -97,6 +97,78 @@ void CMavlinkCommand::sendIntCommand (const uint16_t& command,
 
 
 
+/**
+ * @brief sends long command and tracks its ACK. Command is resent if not acknowledged.
+ * @see CMavlinkCommandEngine
+ * 
+ * @param command 
+ * @param param1 .. param7
+ * @param callback optional. called with final result and with each MAV_RESULT_IN_PROGRESS.
+ * @param policy timeout & retries.
+ * @return std::shared_future<T_COMMAND_RESULT> final result.
+ */
+std::shared_future<T_COMMAND_RESULT> CMavlinkCommand::sendLongCommandAsync (const uint16_t& command,
+                const float& param1,
+                const float& param2,
+                const float& param3,
+                const float& param4,
+                const float& param5,
+                const float& param6,
+                const float& param7,
+                COMMAND_RESULT_CALLBACK callback,
+                const T_COMMAND_RETRY_POLICY& policy) const
+{
+	mavlink_command_long_t msg = { 0 };
+	msg.target_system    = m_vehicle.getSysId();
+	msg.target_component = m_vehicle.getCompId();
+	msg.command          = command;
+	
+    msg.param1           = param1;
+    msg.param2           = param2;
+    msg.param3           = param3;
+	msg.param4           = param4;
+	msg.param5           = param5;
+	msg.param6           = param6;
+	msg.param7           = param7;
+
+	return CMavlinkCommandEngine::getInstance().sendLongCommand(msg, policy, callback);
+}
+
+
+/**
+ * @brief sends int command and tracks its ACK. Command is resent if not acknowledged.
+ * @see CMavlinkCommandEngine
+ */
+std::shared_future<T_COMMAND_RESULT> CMavlinkCommand::sendIntCommandAsync (const uint16_t& command,
+				const uint8_t& frame,
+                const float& param1,
+                const float& param2,
+                const float& param3,
+                const float& param4,
+                const int32_t& x,
+                const int32_t& y,
+                const float& z,
+                COMMAND_RESULT_CALLBACK callback,
+                const T_COMMAND_RETRY_POLICY& policy) const
+{
+	mavlink_command_int_t msg = { 0 };
+	msg.target_system    = m_vehicle.getSysId();
+	msg.target_component = m_vehicle.getCompId();
+	msg.command          = command;
+	msg.frame     		 = frame;
+	
+    msg.param1           = param1;
+    msg.param2           = param2;
+    msg.param3           = param3;
+	msg.param4           = param4;
+	msg.x           	 = x;
+	msg.y           	 = y;
+	msg.z           	 = z;
+
+	return CMavlinkCommandEngine::getInstance().sendIntCommand(msg, policy, callback);
+}
+
+
 /**
  * @brief forward any mavlink message to FCB. No previous processing
  * 
@@ -127,7 +199,7 @@ void CMavlinkCommand::requestMessageEmit(const uint32_t message_id) const
 
 	
 	sendLongCommand (MAV_CMD_REQUEST_MESSAGE, false,
-		MAVLINK_MSG_ID_WIND,  // use specified location . if 1 then use current location.
+		message_id,  // requested message id.
 		0,  // unused
 		0,  // unused
 		0,
@@ -199,7 +271,8 @@ void CMavlinkCommand::doArmDisarm (const bool& arm, const bool& force)  const
 		}
 	}
 
-	sendLongCommand (MAV_CMD_COMPONENT_ARM_DISARM, true,
+	// resent if FCB does not acknowledge. result is reported via OnACK.
+	sendLongCommandAsync (MAV_CMD_COMPONENT_ARM_DISARM,
 		(float) flagArm, 
 		forceArm);
 
@@ -214,7 +287,8 @@ void CMavlinkCommand::doArmDisarm (const bool& arm, const bool& force)  const
 void CMavlinkCommand::doSetMode (const int& mode, const int& custom_mode, const int& custom_sub_mode)  const
 {
     
-	sendLongCommand (MAV_CMD_DO_SET_MODE, true,
+	// resent if FCB does not acknowledge. result is reported via OnACK.
+	sendLongCommandAsync (MAV_CMD_DO_SET_MODE,
 		(float) mode,
 		(float) custom_mode,
 		(float) custom_sub_mode);
@@ -399,7 +473,7 @@ void CMavlinkCommand::setNavigationSpeed ( const int& speed_type, const double&
  * @brief Accept message received from FCB.
  * 
  */
-void CMavlinkCommand::sendMissionAck (const  uint8_t target_system, uint8_t target_component, const  uint8_t result) const
+void CMavlinkCommand::sendMissionAck (const  uint8_t target_system, uint8_t target_component, const  uint8_t result, MAV_MISSION_TYPE mission_type) const
 {
 	#ifdef DEBUG
     std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: sendMissionAck " << _NORMAL_CONSOLE_TEXT_ << std::endl;
@@ -409,6 +483,7 @@ void CMavlinkCommand::sendMissionAck (const  uint8_t target_system, uint8_t targ
 	mission_ack.type = result;
 	mission_ack.target_system = target_system;
 	mission_ack.target_component = target_component;
+	mission_ack.mission_type = mission_type;
 	// Encode
 	mavlink_message_t mavlink_message;
 	mavlink_msg_mission_ack_encode(255,190, &mavlink_message, &mission_ack);
@@ -427,7 +502,7 @@ void CMavlinkCommand::reloadWayPoints () const
 }
 
 
-void CMavlinkCommand::getWayPointByNumber (const int& mission_number) const
+void CMavlinkCommand::getWayPointByNumber (const int& mission_number, MAV_MISSION_TYPE mission_type) const
 {
 	#ifdef DEBUG
     std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: getWayPointByNumber " << std::to_string(mission_number) << _NORMAL_CONSOLE_TEXT_ << std::endl;
@@ -440,7 +515,7 @@ void CMavlinkCommand::getWayPointByNumber (const int& mission_number) const
 
 	mission_request.target_system = m_vehicle.getSysId();
 	mission_request.target_component = m_vehicle.getCompId();
-	mission_request.mission_type = MAV_MISSION_TYPE_MISSION;
+	mission_request.mission_type = mission_type;
 	mission_request.seq = mission_number;
 	
 	
@@ -488,15 +563,6 @@ void CMavlinkCommand::setCurrentMission (const int& mission_number) const
     #endif
     
 
-	mavlink_mission_set_current_t mission_current ={0};
-
-	
-	mission_current.target_system = m_vehicle.getSysId();
-	mission_current.target_component = m_vehicle.getCompId();
-	mission_current.seq = mission_number;
-
-	// Encode
-	
 	sendLongCommand (MAV_CMD_DO_SET_MISSION_CURRENT, true,
 		(float) mission_number,
 		(float) 1);
@@ -505,7 +571,7 @@ void CMavlinkCommand::setCurrentMission (const int& mission_number) const
 }
 
 
-void CMavlinkCommand::requestMissionList () const
+void CMavlinkCommand::requestMissionList (MAV_MISSION_TYPE mission_type) const
 {
 	#ifdef DEBUG
     std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: requestMissionList"  << _NORMAL_CONSOLE_TEXT_ << std::endl;
@@ -517,7 +583,7 @@ void CMavlinkCommand::requestMissionList () const
 	
 	mission_request_list.target_system = m_vehicle.getSysId();
 	mission_request_list.target_component = m_vehicle.getCompId();
-	mission_request_list.mission_type = MAV_MISSION_TYPE_MISSION;
+	mission_request_list.mission_type = mission_type;
 
 	// Encode
 	mavlink_message_t mavlink_message;
@@ -561,7 +627,37 @@ void CMavlinkCommand::setMissionCount (const int& mission_count, MAV_MISSION_TYP
 }
 
 
-void CMavlinkCommand::writeMission (std::map <int, mavlink_mission_item_int_t> mavlink_mission) const
+/**
+ * @brief Start writing items from start_index to end_index inclusive over existing mission.
+ * Autopilot requests these items then sends MISSION_ACK.
+ * * This method is called internally by CMavlinkWayPointManager.
+ *
+ */
+void CMavlinkCommand::setMissionPartialList (const uint16_t& start_index, const uint16_t& end_index, MAV_MISSION_TYPE mission_type) const
+{
+	#ifdef DEBUG
+    std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: setMissionPartialList " << std::to_string(start_index) << "-" << std::to_string(end_index) << _NORMAL_CONSOLE_TEXT_ << std::endl;
+    #endif
+    
+	mavlink_mission_write_partial_list_t mission_write_partial_list = {0};
+
+	mission_write_partial_list.target_system = m_vehicle.getSysId();
+	mission_write_partial_list.target_component = m_vehicle.getCompId();
+	mission_write_partial_list.mission_type = mission_type;
+	mission_write_partial_list.start_index = start_index;
+	mission_write_partial_list.end_index = end_index;
+
+	// Encode
+	mavlink_message_t mavlink_message;
+	mavlink_msg_mission_write_partial_list_encode(255,190, &mavlink_message, &mission_write_partial_list);
+
+    m_mavlink_sdk.sendMavlinkMessage(mavlink_message);
+
+	return ;
+}
+
+
+void CMavlinkCommand::writeMission (const std::map <int, mavlink_mission_item_int_t>& mavlink_mission) const
 {
 	mavlinksdk::CMavlinkWayPointManager::getInstance().saveWayPoints(mavlink_mission, MAV_MISSION_TYPE::MAV_MISSION_TYPE_MISSION);	
 
@@ -667,26 +763,22 @@ void CMavlinkCommand::requestExtParametersList () const
  */
 void CMavlinkCommand::writeParameter (const std::string& param_name, const double &value)  const
 {
-	//TODO to be implemented	
-	
-	const std::map<std::string, mavlink_param_value_t>& parameters_list = mavlinksdk::CMavlinkParameterManager::getInstance().getParametersList();
-	
-
-	mavlink_param_set_t mavlink_param;
+	const mavlink_param_value_t* parameter = mavlinksdk::CMavlinkParameterManager::getInstance().findParameter(param_name.c_str());
 	
-	auto it = parameters_list.find(param_name);
-
-	if (it != parameters_list.end())
+	if (parameter == nullptr)
 	{
 		return ; // not found
 	} 
+
+	mavlink_param_set_t mavlink_param;
 	
 	mavlink_param.target_system = m_vehicle.getSysId();
 	mavlink_param.target_component = m_vehicle.getCompId();
 	
 	mavlink_param.param_value = value;
-	mavlink_param.param_type = it->second.param_type;
-	memcpy (mavlink_param.param_id, it->first.c_str(), 16);
+	mavlink_param.param_type = parameter->param_type;
+	memset (mavlink_param.param_id, 0, 16);
+	memcpy (mavlink_param.param_id, param_name.c_str(), param_name.length() < 16 ? param_name.length() : 16);
 	
 	// Encode
 	mavlink_message_t mavlink_message;
@@ -699,29 +791,19 @@ void CMavlinkCommand::writeParameter (const std::string& param_name, const doubl
 
 
 /**
- * @brief 
- * ! Not Tested
- * @param param_name name is saved in parameters_list = mavlinksdk::CVehicle::getInstance().getParametersList()
+ * @brief request a parameter by name using PARAM_REQUEST_READ.
+ * 
+ * @param param_name up to 16 chars.
  */
 void CMavlinkCommand::readParameter (const std::string& param_name) const
 {
-	//TODO to be implemented	
-	
-	const std::map<std::string, mavlink_param_value_t>& parameters_list = mavlinksdk::CMavlinkParameterManager::getInstance().getParametersList();
-	
-
+	// parameter may not be in the list yet such as _HASH_CHECK.
 	mavlink_param_request_read_t mavlink_param;
 	
-	auto it = parameters_list.find(param_name);
-
-	if (it != parameters_list.end())
-	{
-		return ; // not found
-	} 
-	
 	mavlink_param.target_system = m_vehicle.getSysId();
 	mavlink_param.target_component = m_vehicle.getCompId();
-	memcpy (mavlink_param.param_id, it->first.c_str(), 16);
+	memset (mavlink_param.param_id, 0, 16);
+	memcpy (mavlink_param.param_id, param_name.c_str(), param_name.length() < 16 ? param_name.length() : 16);
 	mavlink_param.param_index = -1; //Send -1 to use the param ID field as identifier (else the param id will be ignored)
 	
 	// Encode
@@ -6,6 +6,7 @@
 #include <ardupilotmega/ardupilotmega.h>
 #include "mavlink_sdk.h"
 #include "vehicle.h"
+#include "mavlink_command_engine.h"
 
 #define MAX_RC_CHANNELS     18
 
@@ -65,13 +66,14 @@ class CMavlinkCommand
         void reloadWayPoints () const;
         void clearWayPoints () const;
         void setCurrentMission (const int& mission_number) const;
-        void requestMissionList () const;
-        void getWayPointByNumber (const int& mission_number) const;
+        void requestMissionList (MAV_MISSION_TYPE mission_type = MAV_MISSION_TYPE_MISSION) const;
+        void getWayPointByNumber (const int& mission_number, MAV_MISSION_TYPE mission_type = MAV_MISSION_TYPE_MISSION) const;
         void setMissionCount (const int& mission_count, MAV_MISSION_TYPE mission_type) const;
-        void writeMission (std::map <int, mavlink_mission_item_int_t> mavlink_mission) const;
+        void setMissionPartialList (const uint16_t& start_index, const uint16_t& end_index, MAV_MISSION_TYPE mission_type) const;
+        void writeMission (const std::map <int, mavlink_mission_item_int_t>& mavlink_mission) const;
         void writeMissionItem (mavlink_mission_item_int_t mavlink_mission) const;
         void writeMissionItem (mavlink_mission_item_t mavlink_mission) const;
-        void sendMissionAck (const  uint8_t target_system, const uint8_t target_component, const uint8_t result) const;
+        void sendMissionAck (const  uint8_t target_system, const uint8_t target_component, const uint8_t result, MAV_MISSION_TYPE mission_type = MAV_MISSION_TYPE_MISSION) const;
         void writeParameter (const std::string& param_name, const double &value) const;
         void readParameter (const std::string& param_name) const;
         void readParameterByIndex (const uint16_t& param_index) const;
@@ -90,6 +92,29 @@ class CMavlinkCommand
         void requestHomeLocation () const;
 
         void sendNative(const mavlink_message_t mavlink_message) const;
+
+        std::shared_future<T_COMMAND_RESULT> sendLongCommandAsync (const uint16_t& command,
+                const float& param1 = 0.0f,
+                const float& param2 = 0.0f,
+                const float& param3 = 0.0f,
+                const float& param4 = 0.0f,
+                const float& param5 = 0.0f,
+                const float& param6 = 0.0f,
+                const float& param7 = 0.0f,
+                COMMAND_RESULT_CALLBACK callback = nullptr,
+                const T_COMMAND_RETRY_POLICY& policy = T_COMMAND_RETRY_POLICY()) const;
+
+        std::shared_future<T_COMMAND_RESULT> sendIntCommandAsync (const uint16_t& command,
+				const uint8_t& frame,
+                const float& param1,
+                const float& param2,
+                const float& param3,
+                const float& param4,
+                const int32_t& x,
+                const int32_t& y,
+                const float& z,
+                COMMAND_RESULT_CALLBACK callback = nullptr,
+                const T_COMMAND_RETRY_POLICY& policy = T_COMMAND_RETRY_POLICY()) const;
     protected:
         void gotoGuidedPoint_default (const double& latitude, const double& longitude, const double& relative_altitude) const;
         void gotoGuidedPoint_px4 (const double& latitude, const double& longitude, const double& relative_altitude) const;
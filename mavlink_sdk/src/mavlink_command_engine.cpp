@@ -0,0 +1,327 @@
+#include <iostream>
+#include <vector>
+
+#include "./helpers/colors.h"
+#include "./helpers/utils.h"
+#include "mavlink_sdk.h"
+#include "mavlink_command_engine.h"
+
+
+using namespace mavlinksdk;
+
+#define GCS_SYSID 255
+
+
+mavlinksdk::CMavlinkCommandEngine::~CMavlinkCommandEngine ()
+{
+	m_exit_thread = true;
+	if (m_timeout_thread.joinable())
+	{
+		m_timeout_thread.join();
+	}
+}
+
+
+/**
+ * @brief sends COMMAND_LONG and tracks its ACK.
+ * @details confirmation field is set by the engine and incremented with each retransmission.
+ *
+ * @param command_long target_system & target_component should be set by caller.
+ * @param policy timeout & retries.
+ * @param callback optional. called with final result and with each MAV_RESULT_IN_PROGRESS.
+ * @return std::shared_future<T_COMMAND_RESULT> ready when ACK is received or all retries timed out.
+ */
+std::shared_future<T_COMMAND_RESULT> mavlinksdk::CMavlinkCommandEngine::sendLongCommand (const mavlink_command_long_t& command_long, const T_COMMAND_RETRY_POLICY& policy, COMMAND_RESULT_CALLBACK callback)
+{
+	T_PENDING_COMMAND pending_command;
+	pending_command.is_int = false;
+	pending_command.command_long = command_long;
+	pending_command.command_long.confirmation = 0;
+	pending_command.policy = policy;
+	pending_command.callback = callback;
+
+	return addPendingCommand (getKey(command_long.target_system, command_long.target_component, command_long.command), std::move(pending_command));
+}
+
+
+/**
+ * @brief sends COMMAND_INT and tracks its ACK.
+ * @details COMMAND_INT has no confirmation field so retransmissions are identical.
+ *
+ * @param command_int target_system & target_component should be set by caller.
+ * @param policy timeout & retries.
+ * @param callback optional. called with final result and with each MAV_RESULT_IN_PROGRESS.
+ * @return std::shared_future<T_COMMAND_RESULT> ready when ACK is received or all retries timed out.
+ */
+std::shared_future<T_COMMAND_RESULT> mavlinksdk::CMavlinkCommandEngine::sendIntCommand (const mavlink_command_int_t& command_int, const T_COMMAND_RETRY_POLICY& policy, COMMAND_RESULT_CALLBACK callback)
+{
+	T_PENDING_COMMAND pending_command;
+	pending_command.is_int = true;
+	pending_command.command_int = command_int;
+	pending_command.policy = policy;
+	pending_command.callback = callback;
+
+	return addPendingCommand (getKey(command_int.target_system, command_int.target_component, command_int.command), std::move(pending_command));
+}
+
+
+std::shared_future<T_COMMAND_RESULT> mavlinksdk::CMavlinkCommandEngine::addPendingCommand (const uint32_t key, T_PENDING_COMMAND&& pending_command)
+{
+	std::shared_future<T_COMMAND_RESULT> future = pending_command.promise.get_future().share();
+	mavlink_message_t mavlink_message;
+	T_COMMAND_RESULT superseded_result;
+	T_PENDING_COMMAND superseded;
+	bool has_superseded = false;
+
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+
+		auto it = m_pending_commands.find(key);
+		if (it != m_pending_commands.end())
+		{
+			// mavlink allows one in-flight command of the same id per target.
+			// newer command wins so that an emergency RTL or LAND is never blocked by an older request.
+			#ifdef DEBUG
+				std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: Command " << std::to_string(key & 0xffff) << " supersedes pending one" << _NORMAL_CONSOLE_TEXT_ << std::endl;
+			#endif
+
+			superseded_result.command = key & 0xffff;
+			superseded_result.target_system = (key >> 24) & 0xff;
+			superseded_result.target_component = (key >> 16) & 0xff;
+			superseded_result.result = COMMAND_ENGINE_RESULT_SUPERSEDED;
+			superseded_result.progress = it->second.progress;
+			superseded_result.attempts = it->second.attempts;
+			superseded_result.latency_us = get_time_usec() - it->second.time_first_sent;
+
+			superseded = std::move(it->second);
+			has_superseded = true;
+			m_pending_commands.erase(it);
+		}
+
+		it = m_pending_commands.emplace(key, std::move(pending_command)).first;
+
+		T_PENDING_COMMAND& pending = it->second;
+		pending.time_first_sent = get_time_usec();
+		encode (pending, mavlink_message);
+
+		if (!m_timeout_thread_started)
+		{
+			m_timeout_thread_started = true;
+			m_timeout_thread = std::thread{[&](){ loopTimeouts(); }};
+		}
+	}
+
+	// sending & callbacks are outside lock so they can send other commands.
+	mavlinksdk::CMavlinkSDK::getInstance().sendMavlinkMessage(mavlink_message);
+
+	if (has_superseded)
+	{
+		if (superseded.callback) superseded.callback (superseded_result);
+		superseded.promise.set_value(superseded_result);
+	}
+
+	return future;
+}
+
+
+/**
+ * @brief encode pending command and count it as a transmission. Caller should hold m_lock
+ * and send the message after releasing it.
+ *
+ * @param pending_command
+ * @param mavlink_message [out]
+ */
+void mavlinksdk::CMavlinkCommandEngine::encode (T_PENDING_COMMAND& pending_command, mavlink_message_t& mavlink_message)
+{
+	if (pending_command.is_int)
+	{
+		mavlink_msg_command_int_encode(GCS_SYSID, 190, &mavlink_message, &pending_command.command_int);
+	}
+	else
+	{
+		// confirmation: 0: First transmission of this command. 1-255: Confirmation transmissions.
+		pending_command.command_long.confirmation = pending_command.attempts;
+		mavlink_msg_command_long_encode(GCS_SYSID, 190, &mavlink_message, &pending_command.command_long);
+	}
+
+	pending_command.attempts++;
+	pending_command.time_last_sent = get_time_usec();
+}
+
+
+/**
+ * @brief match COMMAND_ACK with a pending command.
+ *
+ * @param sysid system id of ACK sender.
+ * @param compid component id of ACK sender.
+ * @param command_ack
+ */
+void mavlinksdk::CMavlinkCommandEngine::handle_cmd_ack (const uint8_t& sysid, const uint8_t& compid, const mavlink_command_ack_t& command_ack)
+{
+	T_COMMAND_RESULT command_result;
+	COMMAND_RESULT_CALLBACK callback;
+	std::promise<T_COMMAND_RESULT> promise;
+	bool completed = false;
+
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+
+		auto it = m_pending_commands.find(getKey(sysid, compid, command_ack.command));
+		if (it == m_pending_commands.end())
+		{
+			// command was sent to all components of target system.
+			it = m_pending_commands.find(getKey(sysid, 0, command_ack.command));
+		}
+		if (it == m_pending_commands.end()) return ;
+
+		T_PENDING_COMMAND& pending = it->second;
+		const uint64_t now = get_time_usec();
+
+		command_result.command = command_ack.command;
+		command_result.target_system = (it->first >> 24) & 0xff;
+		command_result.target_component = (it->first >> 16) & 0xff;
+		command_result.result = command_ack.result;
+		command_result.progress = command_ack.progress;
+		command_result.result_param2 = command_ack.result_param2;
+		command_result.attempts = pending.attempts;
+		command_result.latency_us = now - pending.time_first_sent;
+		callback = pending.callback;
+
+		if (command_ack.result == MAV_RESULT_IN_PROGRESS)
+		{
+			// no more retransmissions. wait for final result.
+			pending.in_progress = true;
+			pending.progress = command_ack.progress;
+			pending.time_last_sent = now;
+		}
+		else
+		{
+			completed = true;
+			promise = std::move(pending.promise);
+			m_pending_commands.erase(it);
+			updateStats (command_result);
+		}
+	}
+
+	// callbacks are called outside lock so they can send other commands.
+	if (callback) callback (command_result);
+	if (completed) promise.set_value(command_result);
+}
+
+
+/**
+ * @brief resend commands that are not acknowledged and fail commands that exceeded all retries.
+ *
+ */
+void mavlinksdk::CMavlinkCommandEngine::checkTimeouts ()
+{
+	std::vector<std::pair<T_COMMAND_RESULT, T_PENDING_COMMAND>> timed_out;
+	std::vector<mavlink_message_t> retransmissions;
+
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+
+		const uint64_t now = get_time_usec();
+		auto it = m_pending_commands.begin();
+		while (it != m_pending_commands.end())
+		{
+			T_PENDING_COMMAND& pending = it->second;
+			const uint64_t timeout = pending.in_progress ? pending.policy.in_progress_timeout_us : pending.policy.timeout_us;
+
+			if ((now - pending.time_last_sent) < timeout)
+			{
+				++it;
+				continue;
+			}
+
+			if ((!pending.in_progress) && (pending.attempts <= pending.policy.max_retries))
+			{
+				#ifdef DEBUG
+					std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: Resend Command " << std::to_string(it->first & 0xffff) << " attempt:" << std::to_string(pending.attempts) << _NORMAL_CONSOLE_TEXT_ << std::endl;
+				#endif
+
+				mavlink_message_t mavlink_message;
+				encode (pending, mavlink_message);
+				retransmissions.push_back(mavlink_message);
+				m_command_stats[it->first & 0xffff].retransmissions++;
+				++it;
+				continue;
+			}
+
+			T_COMMAND_RESULT command_result;
+			command_result.command = it->first & 0xffff;
+			command_result.target_system = (it->first >> 24) & 0xff;
+			command_result.target_component = (it->first >> 16) & 0xff;
+			command_result.result = COMMAND_ENGINE_RESULT_TIMEOUT;
+			command_result.progress = pending.progress;
+			command_result.attempts = pending.attempts;
+			command_result.latency_us = now - pending.time_first_sent;
+			updateStats (command_result);
+
+			timed_out.push_back(std::make_pair(command_result, std::move(pending)));
+			it = m_pending_commands.erase(it);
+		}
+	}
+
+	for (const mavlink_message_t& mavlink_message : retransmissions)
+	{
+		mavlinksdk::CMavlinkSDK::getInstance().sendMavlinkMessage(mavlink_message);
+	}
+
+	for (auto& item : timed_out)
+	{
+		if (item.second.callback) item.second.callback (item.first);
+		item.second.promise.set_value(item.first);
+	}
+}
+
+
+void mavlinksdk::CMavlinkCommandEngine::loopTimeouts ()
+{
+	while (!m_exit_thread)
+	{
+		// timer each 50m sec.
+		wait_time_nsec(0, 50000000);
+
+		checkTimeouts();
+	}
+}
+
+
+/**
+ * @brief update latency statistics. Caller should hold m_lock.
+ *
+ * @param command_result
+ */
+void mavlinksdk::CMavlinkCommandEngine::updateStats (const T_COMMAND_RESULT& command_result)
+{
+	T_COMMAND_STATS& stats = m_command_stats[command_result.command];
+	stats.count++;
+
+	if (command_result.result == COMMAND_ENGINE_RESULT_TIMEOUT)
+	{
+		stats.timeouts++;
+		return ;
+	}
+
+	stats.last_latency_us = command_result.latency_us;
+	stats.total_latency_us += command_result.latency_us;
+	if (command_result.latency_us > stats.max_latency_us)
+	{
+		stats.max_latency_us = command_result.latency_us;
+	}
+}
+
+
+const T_COMMAND_STATS mavlinksdk::CMavlinkCommandEngine::getCommandStats (const uint16_t& command) const
+{
+	const std::lock_guard<std::mutex> lock(m_lock);
+
+	auto it = m_command_stats.find(command);
+	if (it == m_command_stats.end())
+	{
+		return T_COMMAND_STATS();
+	}
+
+	return it->second;
+}
@@ -0,0 +1,163 @@
+#ifndef MAVLINK_COMMAND_ENGINE_H_
+#define MAVLINK_COMMAND_ENGINE_H_
+
+#include <map>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <future>
+#include <functional>
+#include <cstdint>
+#include <all/mavlink.h>
+
+namespace mavlinksdk
+{
+
+#define COMMAND_ENGINE_DEFAULT_TIMEOUT          1500000     // usec to wait for COMMAND_ACK before resending.
+#define COMMAND_ENGINE_DEFAULT_RETRIES          3           // resends after first transmission.
+#define COMMAND_ENGINE_IN_PROGRESS_TIMEOUT      10000000    // usec to wait for final ACK after last MAV_RESULT_IN_PROGRESS.
+
+/**
+ * @brief not a MAV_RESULT. Used when no ACK is received after all retries.
+ *
+ */
+#define COMMAND_ENGINE_RESULT_TIMEOUT           255
+
+/**
+ * @brief not a MAV_RESULT. Used when a newer command of the same id to the same target replaced
+ * this one before it was acknowledged.
+ *
+ */
+#define COMMAND_ENGINE_RESULT_SUPERSEDED        254
+
+
+typedef struct T_COMMAND_RETRY_POLICY {
+        uint64_t timeout_us             = COMMAND_ENGINE_DEFAULT_TIMEOUT;
+        uint8_t  max_retries            = COMMAND_ENGINE_DEFAULT_RETRIES;
+        uint64_t in_progress_timeout_us = COMMAND_ENGINE_IN_PROGRESS_TIMEOUT;
+    } T_COMMAND_RETRY_POLICY;
+
+
+typedef struct T_COMMAND_RESULT {
+        uint16_t command            = 0;
+        uint8_t  target_system      = 0;
+        uint8_t  target_component   = 0;
+        uint8_t  result             = COMMAND_ENGINE_RESULT_TIMEOUT;   // MAV_RESULT, COMMAND_ENGINE_RESULT_TIMEOUT or COMMAND_ENGINE_RESULT_SUPERSEDED
+        uint8_t  progress           = 0;        // valid when result is MAV_RESULT_IN_PROGRESS
+        int32_t  result_param2      = 0;
+        uint8_t  attempts           = 0;        // number of transmissions
+        uint64_t latency_us         = 0;        // from first transmission to final ACK
+    } T_COMMAND_RESULT;
+
+
+typedef std::function<void (const T_COMMAND_RESULT& command_result)> COMMAND_RESULT_CALLBACK;
+
+
+typedef struct T_PENDING_COMMAND {
+        bool is_int = false;
+        mavlink_command_long_t command_long;
+        mavlink_command_int_t command_int;
+        T_COMMAND_RETRY_POLICY policy;
+        uint8_t attempts = 0;
+        bool in_progress = false;
+        uint8_t progress = 0;
+        uint64_t time_first_sent = 0;
+        uint64_t time_last_sent = 0;
+        std::promise<T_COMMAND_RESULT> promise;
+        COMMAND_RESULT_CALLBACK callback;
+    } T_PENDING_COMMAND;
+
+
+typedef struct T_COMMAND_STATS {
+        uint32_t count = 0;             // completed commands either acked or timed out.
+        uint32_t timeouts = 0;
+        uint32_t retransmissions = 0;
+        uint64_t last_latency_us = 0;
+        uint64_t max_latency_us = 0;
+        uint64_t total_latency_us = 0;  // of acked commands only.
+    } T_COMMAND_STATS;
+
+
+/**
+ * @brief Sends COMMAND_LONG & COMMAND_INT and tracks them till COMMAND_ACK is received.
+ * @details Pending commands are keyed by (target_system, target_component, command) as
+ * mavlink allows only one in-flight command of the same id per target. A new command replaces a pending one
+ * with the same key so that a newer mode or arm request is never blocked by an older one. Commands are resent with incremented
+ * confirmation if no ACK is received within policy timeout. MAV_RESULT_IN_PROGRESS extends the deadline.
+ * Result is returned as a future and optionally a callback.
+ * @see https://mavlink.io/en/services/command.html
+ *
+ */
+class CMavlinkCommandEngine
+{
+    public:
+        //https://stackoverflow.com/questions/1008019/c-singleton-design-pattern
+        static CMavlinkCommandEngine& getInstance()
+        {
+            static CMavlinkCommandEngine instance;
+
+            return instance;
+        };
+
+        CMavlinkCommandEngine(CMavlinkCommandEngine const&)       = delete;
+        void operator=(CMavlinkCommandEngine const&)              = delete;
+
+
+        // Note: Scott Meyers mentions in his Effective Modern
+        //       C++ book, that deleted functions should generally
+        //       be public as it results in better error messages
+        //       due to the compilers behavior to check accessibility
+        //       before deleted status
+
+    private:
+
+        CMavlinkCommandEngine()
+        {
+        };
+
+    public:
+
+        ~CMavlinkCommandEngine ();
+
+    public:
+
+        std::shared_future<T_COMMAND_RESULT> sendLongCommand (const mavlink_command_long_t& command_long, const T_COMMAND_RETRY_POLICY& policy, COMMAND_RESULT_CALLBACK callback = nullptr);
+        std::shared_future<T_COMMAND_RESULT> sendIntCommand (const mavlink_command_int_t& command_int, const T_COMMAND_RETRY_POLICY& policy, COMMAND_RESULT_CALLBACK callback = nullptr);
+
+        void handle_cmd_ack (const uint8_t& sysid, const uint8_t& compid, const mavlink_command_ack_t& command_ack);
+
+        const T_COMMAND_STATS getCommandStats (const uint16_t& command) const;
+
+        const std::size_t getPendingCount () const
+        {
+            const std::lock_guard<std::mutex> lock(m_lock);
+            return m_pending_commands.size();
+        }
+
+    protected:
+
+        std::shared_future<T_COMMAND_RESULT> addPendingCommand (const uint32_t key, T_PENDING_COMMAND&& pending_command);
+        void encode (T_PENDING_COMMAND& pending_command, mavlink_message_t& mavlink_message);
+        void checkTimeouts ();
+        void loopTimeouts ();
+        void updateStats (const T_COMMAND_RESULT& command_result);
+
+        static inline uint32_t getKey (const uint8_t target_system, const uint8_t target_component, const uint16_t command)
+        {
+            return ((uint32_t)target_system << 24) | ((uint32_t)target_component << 16) | command;
+        }
+
+    protected:
+
+        std::map<uint32_t, T_PENDING_COMMAND> m_pending_commands;
+        std::map<uint16_t, T_COMMAND_STATS> m_command_stats;
+        mutable std::mutex m_lock;
+
+        std::thread m_timeout_thread;
+        bool m_timeout_thread_started = false;
+        std::atomic<bool> m_exit_thread{false};
+};
+
+}
+
+#endif
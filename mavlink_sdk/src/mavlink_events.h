@@ -45,6 +45,8 @@ namespace mavlinksdk
         virtual void OnWaypointReached(const int& seq)                                                                      {};
         virtual void OnWayPointReceived(const mavlink_mission_item_int_t& mission_item_int)                                 {};
         virtual void OnWayPointsLoadingCompleted ()                                                                         {};
+        virtual void OnWayPointsLoadingProgress (const uint16_t& received, const uint16_t& count)                          {};
+        virtual void OnWayPointsLoadingFailed ()                                                                            {};
         virtual void OnMissionSaveFinished (const int& result, const int& mission_type, const std::string& result_msg)      {};
         virtual void OnMissionACK (const int& result, const int& mission_type, const std::string& result_msg)               {}; 
         virtual void OnMissionCurrentChanged (const mavlink_mission_current_t& mission_current)                             {};
@@ -1,35 +1,689 @@
 #include <iostream>
+#include <cstring>
 
 
 #include "./helpers/colors.h"
+#include "./helpers/utils.h"
 #include "mavlink_command.h"
 #include "mavlink_sdk.h"
 #include "vehicle.h"
+#include "mavlink_parameter_manager.h"
 #include "mavlink_ftp_manager.h"
 
 
+using namespace mavlinksdk;
+
+#define GCS_SYSID 255
+
+// offsets of fields inside FILE_TRANSFER_PROTOCOL payload.
+#define FTP_PAYLOAD_SEQ_NUMBER      0
+#define FTP_PAYLOAD_SESSION         2
+#define FTP_PAYLOAD_OPCODE          3
+#define FTP_PAYLOAD_SIZE            4
+#define FTP_PAYLOAD_REQ_OPCODE      5
+#define FTP_PAYLOAD_BURST_COMPLETE  6
+#define FTP_PAYLOAD_OFFSET          8
+#define FTP_PAYLOAD_DATA            12
+
+
+mavlinksdk::CMavlinkFTPManager::~CMavlinkFTPManager ()
+{
+	m_exit_thread = true;
+	if (m_timeout_thread.joinable())
+	{
+		m_timeout_thread.join();
+	}
+}
+
+
 void mavlinksdk::CMavlinkFTPManager::requestMavFTPParamList()
 {
+	#ifdef DEBUG
     std::cout << __FILE__ << "." << __FUNCTION__ <<  " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG:requestMavFTPParamList"  << _NORMAL_CONSOLE_TEXT_ << std::endl;
+	#endif
+
+	const bool started = readFile(FTP_PARAM_FILE, [](const FTP_RESULT result, const FTP_ERROR error, const std::vector<uint8_t>& data)
+	{
+		mavlinksdk::CMavlinkParameterManager& parameter_manager = mavlinksdk::CMavlinkParameterManager::getInstance();
+
+		if ((result == FTP_RESULT::Success) && (parameter_manager.handle_param_pck(data)))
+		{
+			return ;
+		}
+
+		std::cout << _INFO_CONSOLE_TEXT << "FTP parameters not available [" << std::to_string((int)result) << ":" << std::to_string((int)error) << "] - using PARAM_REQUEST_LIST" << _NORMAL_CONSOLE_TEXT_ << std::endl;
+		// timeouts are reported on FTP thread while parser thread may be handling PARAM_VALUE.
+		parameter_manager.postFTPLoadFailed();
+	});
+
+	if (!started)
+	{
+		mavlinksdk::CMavlinkParameterManager::getInstance().reloadParemeters();
+	}
+
+	return ;
+}
+
+
+/**
+ * @brief standard CRC32 as used by ArduPilot for CalcFileCRC32.
+ *
+ */
+uint32_t mavlinksdk::CMavlinkFTPManager::crc32 (const uint8_t* buffer, const std::size_t length, uint32_t crc)
+{
+	for (std::size_t i = 0; i < length; ++i)
+	{
+		crc ^= buffer[i];
+		for (int bit = 0; bit < 8; ++bit)
+		{
+			crc = (crc >> 1) ^ (0xEDB88320 & (-(int32_t)(crc & 1)));
+		}
+	}
+
+	return crc;
+}
+
+
+bool mavlinksdk::CMavlinkFTPManager::readFile (const std::string& path, FTP_DATA_CALLBACK callback)
+{
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+
+		if (!beginOperation(FTP_OPERATION::ReadFile, path)) return false;
+		m_operation.data_callback = callback;
+
+		sendRequest(FTP_OP::OpenFileRO, 0, 0, (const uint8_t*)path.c_str(), path.length());
+	}
+
+	return true;
+}
+
+
+bool mavlinksdk::CMavlinkFTPManager::listDirectory (const std::string& path, FTP_LIST_CALLBACK callback)
+{
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+
+		if (!beginOperation(FTP_OPERATION::ListDirectory, path)) return false;
+		m_operation.list_callback = callback;
+
+		sendRequest(FTP_OP::ListDirectory, 0, 0, (const uint8_t*)path.c_str(), path.length());
+	}
+
+	return true;
+}
+
+
+bool mavlinksdk::CMavlinkFTPManager::calcFileCRC32 (const std::string& path, FTP_CRC_CALLBACK callback)
+{
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+
+		if (!beginOperation(FTP_OPERATION::CalcFileCRC32, path)) return false;
+		m_operation.crc_callback = callback;
+
+		sendRequest(FTP_OP::CalcFileCRC32, 0, 0, (const uint8_t*)path.c_str(), path.length());
+	}
+
+	return true;
+}
+
+
+bool mavlinksdk::CMavlinkFTPManager::writeFile (const std::string& path, const std::vector<uint8_t>& data, FTP_RESULT_CALLBACK callback)
+{
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+
+		if (!beginOperation(FTP_OPERATION::WriteFile, path)) return false;
+		m_operation.result_callback = callback;
+		m_operation.data = data;
+
+		sendRequest(FTP_OP::CreateFile, 0, 0, (const uint8_t*)path.c_str(), path.length());
+	}
+
+	return true;
+}
+
+
+bool mavlinksdk::CMavlinkFTPManager::removeFile (const std::string& path, FTP_RESULT_CALLBACK callback)
+{
+	return singleRequest(FTP_OP::RemoveFile, path, 0, (const uint8_t*)path.c_str(), path.length(), callback);
+}
+
+
+bool mavlinksdk::CMavlinkFTPManager::truncateFile (const std::string& path, const uint32_t length, FTP_RESULT_CALLBACK callback)
+{
+	return singleRequest(FTP_OP::TruncateFile, path, length, (const uint8_t*)path.c_str(), path.length(), callback);
+}
+
+
+bool mavlinksdk::CMavlinkFTPManager::createDirectory (const std::string& path, FTP_RESULT_CALLBACK callback)
+{
+	return singleRequest(FTP_OP::CreateDirectory, path, 0, (const uint8_t*)path.c_str(), path.length(), callback);
+}
+
+
+bool mavlinksdk::CMavlinkFTPManager::removeDirectory (const std::string& path, FTP_RESULT_CALLBACK callback)
+{
+	return singleRequest(FTP_OP::RemoveDirectory, path, 0, (const uint8_t*)path.c_str(), path.length(), callback);
+}
+
+
+/**
+ * @brief data is path_from\0path_to
+ *
+ */
+bool mavlinksdk::CMavlinkFTPManager::rename (const std::string& path_from, const std::string& path_to, FTP_RESULT_CALLBACK callback)
+{
+	std::string paths = path_from;
+	paths.push_back('\0');
+	paths.append(path_to);
+
+	return singleRequest(FTP_OP::Rename, path_from, 0, (const uint8_t*)paths.c_str(), paths.length(), callback);
+}
+
+
+bool mavlinksdk::CMavlinkFTPManager::resetSessions (FTP_RESULT_CALLBACK callback)
+{
+	return singleRequest(FTP_OP::ResetSessions, std::string(), 0, nullptr, 0, callback);
+}
+
+
+/**
+ * @brief initialize m_operation. Caller should hold m_lock.
+ *
+ * @return false if another operation is active or path does not fit in a single request.
+ */
+bool mavlinksdk::CMavlinkFTPManager::beginOperation (const FTP_OPERATION type, const std::string& path)
+{
+	if (m_operation.type != FTP_OPERATION::None) return false;
+	if (path.length() > FTP_MAX_DATA_LENGTH) return false;
+
+	m_operation = T_FTP_OPERATION();
+	m_operation.type = type;
+	m_operation.path = path;
+	m_retries = 0;
+
+	if (!m_timeout_thread_started)
+	{
+		m_timeout_thread_started = true;
+		m_timeout_thread = std::thread{[&](){ loopTimeout(); }};
+	}
+
+	return true;
+}
+
+
+bool mavlinksdk::CMavlinkFTPManager::singleRequest (const FTP_OP opcode, const std::string& path, const uint32_t offset, const uint8_t* data, const uint8_t size, FTP_RESULT_CALLBACK callback)
+{
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+
+		if (size > FTP_MAX_DATA_LENGTH) return false;
+		if (!beginOperation(FTP_OPERATION::Single, path)) return false;
+		m_operation.result_callback = callback;
+
+		sendRequest(opcode, 0, offset, data, size);
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief encode & send a request and keep it in m_last_request. Caller should hold m_lock.
+ *
+ */
+void mavlinksdk::CMavlinkFTPManager::sendRequest (const FTP_OP opcode, const uint8_t session, const uint32_t offset, const uint8_t* data, const uint8_t size)
+{
+	m_last_request.seq_number = ++m_seq_number;
+	m_last_request.session = session;
+	m_last_request.opcode = opcode;
+	m_last_request.req_opcode = FTP_OP::None;
+	m_last_request.burst_complete = false;
+	m_last_request.offset = offset;
+	m_last_request.size = size;
+	if ((data != nullptr) && (size > 0))
+	{
+		memcpy(m_last_request.data, data, size);
+	}
+
+	m_retries = 0;
+	resendRequest();
+}
 
-    mavlink_file_transfer_protocol_t mavlink_ftp;
 
+/**
+ * @brief send m_last_request as is. Caller should hold m_lock.
+ *
+ */
+void mavlinksdk::CMavlinkFTPManager::resendRequest ()
+{
 	mavlinksdk::CVehicle &vehicle =  mavlinksdk::CVehicle::getInstance();
-	mavlinksdk::CMavlinkSDK& mavlink_sdk = mavlinksdk::CMavlinkSDK::getInstance();
-	
+
+	mavlink_file_transfer_protocol_t mavlink_ftp = {0};
+	mavlink_ftp.target_network = 0;
 	mavlink_ftp.target_system = vehicle.getSysId();
 	mavlink_ftp.target_component = vehicle.getCompId();
-	mavlink_ftp.target_network = 0;
 
-	
+	uint8_t* payload = mavlink_ftp.payload;
+	memcpy(&payload[FTP_PAYLOAD_SEQ_NUMBER], &m_last_request.seq_number, sizeof(uint16_t));
+	payload[FTP_PAYLOAD_SESSION] = m_last_request.session;
+	payload[FTP_PAYLOAD_OPCODE] = (uint8_t) m_last_request.opcode;
+	payload[FTP_PAYLOAD_SIZE] = m_last_request.size;
+	payload[FTP_PAYLOAD_REQ_OPCODE] = 0;
+	payload[FTP_PAYLOAD_BURST_COMPLETE] = 0;
+	memcpy(&payload[FTP_PAYLOAD_OFFSET], &m_last_request.offset, sizeof(uint32_t));
+	memcpy(&payload[FTP_PAYLOAD_DATA], m_last_request.data, m_last_request.size);
 
-	
-	
 	// Encode
 	mavlink_message_t mavlink_message;
-	mavlink_msg_file_transfer_protocol_encode(vehicle.getSysId(), vehicle.getCompId(), &mavlink_message, &mavlink_ftp);
+	mavlink_msg_file_transfer_protocol_encode(GCS_SYSID, 190, &mavlink_message, &mavlink_ftp);
 
-    mavlink_sdk.sendMavlinkMessage(mavlink_message);
+	m_last_activity_time = get_time_usec();
 
-	return ;
-}
\ No newline at end of file
+	mavlinksdk::CMavlinkSDK::getInstance().sendMavlinkMessage(mavlink_message);
+}
+
+
+/**
+ * @brief request next burst or fill gaps of previous bursts. Caller should hold m_lock.
+ *
+ */
+void mavlinksdk::CMavlinkFTPManager::continueRead ()
+{
+	if ((!m_operation.eof) && ((m_operation.file_size == 0) || (m_operation.offset < m_operation.file_size)))
+	{
+		sendRequest(FTP_OP::BurstReadFile, m_operation.session, m_operation.offset, nullptr, FTP_MAX_DATA_LENGTH);
+		return ;
+	}
+
+	if (!m_operation.gaps.empty())
+	{
+		const std::pair<uint32_t, uint32_t>& gap = m_operation.gaps.front();
+		const uint8_t size = gap.second > FTP_MAX_DATA_LENGTH ? FTP_MAX_DATA_LENGTH : (uint8_t) gap.second;
+		sendRequest(FTP_OP::ReadFile, m_operation.session, gap.first, nullptr, size);
+		return ;
+	}
+
+	if (m_operation.file_size != 0)
+	{
+		m_operation.data.resize(m_operation.file_size);
+	}
+
+	terminate(FTP_RESULT::Success, FTP_ERROR::None);
+}
+
+
+/**
+ * @brief write next chunk or close file. Caller should hold m_lock.
+ *
+ */
+void mavlinksdk::CMavlinkFTPManager::continueWrite ()
+{
+	if (m_operation.offset >= m_operation.data.size())
+	{
+		terminate(FTP_RESULT::Success, FTP_ERROR::None);
+		return ;
+	}
+
+	const std::size_t remaining = m_operation.data.size() - m_operation.offset;
+	const uint8_t size = remaining > FTP_MAX_DATA_LENGTH ? FTP_MAX_DATA_LENGTH : (uint8_t) remaining;
+	sendRequest(FTP_OP::WriteFile, m_operation.session, m_operation.offset, &m_operation.data[m_operation.offset], size);
+}
+
+
+/**
+ * @brief close session if open then finish. Caller should hold m_lock.
+ *
+ */
+void mavlinksdk::CMavlinkFTPManager::terminate (const FTP_RESULT result, const FTP_ERROR error)
+{
+	m_operation.result = result;
+	m_operation.error = error;
+
+	if (m_operation.session_open)
+	{
+		m_operation.session_open = false;
+		sendRequest(FTP_OP::TerminateSession, m_operation.session, 0, nullptr, 0);
+		return ;
+	}
+
+	finish(result, error);
+}
+
+
+/**
+ * @brief prepare callback of the operation into m_completion and release the operation.
+ * Caller should hold m_lock and call runCompletion after releasing it.
+ *
+ */
+void mavlinksdk::CMavlinkFTPManager::finish (const FTP_RESULT result, const FTP_ERROR error)
+{
+	T_FTP_OPERATION operation = std::move(m_operation);
+	m_operation = T_FTP_OPERATION();
+
+	switch (operation.type)
+	{
+		case FTP_OPERATION::ReadFile:
+			if (operation.data_callback)
+			{
+				std::vector<uint8_t> data = std::move(operation.data);
+				FTP_DATA_CALLBACK callback = operation.data_callback;
+				m_completion = [=]() { callback(result, error, data); };
+			}
+			break;
+
+		case FTP_OPERATION::ListDirectory:
+			if (operation.list_callback)
+			{
+				std::vector<std::string> entries = std::move(operation.entries);
+				FTP_LIST_CALLBACK callback = operation.list_callback;
+				m_completion = [=]() { callback(result, error, entries); };
+			}
+			break;
+
+		case FTP_OPERATION::CalcFileCRC32:
+			if (operation.crc_callback)
+			{
+				const uint32_t crc = operation.crc32;
+				FTP_CRC_CALLBACK callback = operation.crc_callback;
+				m_completion = [=]() { callback(result, error, crc); };
+			}
+			break;
+
+		default:
+			if (operation.result_callback)
+			{
+				FTP_RESULT_CALLBACK callback = operation.result_callback;
+				m_completion = [=]() { callback(result, error); };
+			}
+			break;
+	}
+}
+
+
+void mavlinksdk::CMavlinkFTPManager::runCompletion ()
+{
+	std::function<void ()> completion;
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+		completion = std::move(m_completion);
+		m_completion = nullptr;
+	}
+
+	if (completion) completion();
+}
+
+
+void mavlinksdk::CMavlinkFTPManager::handle_file_transfer_protocol (const mavlink_file_transfer_protocol_t& file_transfer_protocol)
+{
+	if (file_transfer_protocol.target_system != GCS_SYSID) return ;
+
+	const uint8_t* payload = file_transfer_protocol.payload;
+
+	T_PENDING_FTP reply;
+	memcpy(&reply.seq_number, &payload[FTP_PAYLOAD_SEQ_NUMBER], sizeof(uint16_t));
+	reply.session = payload[FTP_PAYLOAD_SESSION];
+	reply.opcode = (FTP_OP) payload[FTP_PAYLOAD_OPCODE];
+	reply.size = payload[FTP_PAYLOAD_SIZE];
+	reply.req_opcode = (FTP_OP) payload[FTP_PAYLOAD_REQ_OPCODE];
+	reply.burst_complete = payload[FTP_PAYLOAD_BURST_COMPLETE] != 0;
+	memcpy(&reply.offset, &payload[FTP_PAYLOAD_OFFSET], sizeof(uint32_t));
+	if (reply.size > FTP_MAX_DATA_LENGTH) reply.size = FTP_MAX_DATA_LENGTH;
+	memcpy(reply.data, &payload[FTP_PAYLOAD_DATA], reply.size);
+
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+
+		if (m_operation.type == FTP_OPERATION::None) return ;
+
+		// reply of an older request.
+		if (reply.req_opcode != m_last_request.opcode) return ;
+		if ((reply.req_opcode != FTP_OP::BurstReadFile) && (reply.seq_number != (uint16_t)(m_last_request.seq_number + 1))) return ;
+
+		m_last_activity_time = get_time_usec();
+
+		if (reply.opcode == FTP_OP::Ack)
+		{
+			handleAck(reply);
+		}
+		else if (reply.opcode == FTP_OP::Nack)
+		{
+			handleNack(reply);
+		}
+	}
+
+	runCompletion();
+}
+
+
+/**
+ * @brief Caller should hold m_lock.
+ *
+ */
+void mavlinksdk::CMavlinkFTPManager::handleAck (const T_PENDING_FTP& reply)
+{
+	switch (reply.req_opcode)
+	{
+		case FTP_OP::OpenFileRO:
+		{
+			m_operation.session = reply.session;
+			m_operation.session_open = true;
+			if (reply.size >= sizeof(uint32_t))
+			{
+				memcpy(&m_operation.file_size, reply.data, sizeof(uint32_t));
+				m_operation.data.reserve(m_operation.file_size);
+			}
+			continueRead();
+		}
+		break;
+
+		case FTP_OP::BurstReadFile:
+		case FTP_OP::ReadFile:
+		{
+			const uint32_t end = reply.offset + reply.size;
+			if (m_operation.data.size() < end)
+			{
+				m_operation.data.resize(end);
+			}
+			memcpy(&m_operation.data[reply.offset], reply.data, reply.size);
+
+			if (reply.req_opcode == FTP_OP::BurstReadFile)
+			{
+				// lost packets inside a burst are filled later.
+				if (reply.offset > m_operation.offset)
+				{
+					m_operation.gaps.push_back(std::make_pair(m_operation.offset, reply.offset - m_operation.offset));
+				}
+				if (end > m_operation.offset)
+				{
+					m_operation.offset = end;
+				}
+				if (!reply.burst_complete) return ;
+			}
+			else if (!m_operation.gaps.empty())
+			{
+				std::pair<uint32_t, uint32_t>& gap = m_operation.gaps.front();
+				if ((reply.offset == gap.first) && (reply.size > 0))
+				{
+					const uint32_t filled = reply.size > gap.second ? gap.second : reply.size;
+					gap.first += filled;
+					gap.second -= filled;
+				}
+				if (gap.second == 0)
+				{
+					m_operation.gaps.erase(m_operation.gaps.begin());
+				}
+			}
+
+			continueRead();
+		}
+		break;
+
+		case FTP_OP::ListDirectory:
+		{
+			// entries are separated by \0. Format: F<name>\t<size> | D<name> | S (skip)
+			uint8_t i = 0;
+			while (i < reply.size)
+			{
+				const char* entry = (const char*) &reply.data[i];
+				const std::size_t length = strnlen(entry, reply.size - i);
+				if (length == 0) break;
+
+				m_operation.entries_count++;
+				if (entry[0] != 'S')
+				{
+					m_operation.entries.push_back(std::string(entry, length));
+				}
+				i += length + 1;
+			}
+
+			sendRequest(FTP_OP::ListDirectory, 0, m_operation.entries_count, (const uint8_t*)m_operation.path.c_str(), m_operation.path.length());
+		}
+		break;
+
+		case FTP_OP::CalcFileCRC32:
+		{
+			if (reply.size >= sizeof(uint32_t))
+			{
+				memcpy(&m_operation.crc32, reply.data, sizeof(uint32_t));
+			}
+			finish(FTP_RESULT::Success, FTP_ERROR::None);
+		}
+		break;
+
+		case FTP_OP::CreateFile:
+		{
+			m_operation.session = reply.session;
+			m_operation.session_open = true;
+			m_operation.offset = 0;
+			continueWrite();
+		}
+		break;
+
+		case FTP_OP::WriteFile:
+		{
+			if (reply.offset != m_last_request.offset) return ;
+			m_operation.offset += m_last_request.size;
+			continueWrite();
+		}
+		break;
+
+		case FTP_OP::TerminateSession:
+		{
+			finish(m_operation.result, m_operation.error);
+		}
+		break;
+
+		default:
+		{
+			// RemoveFile, Rename, TruncateFile, CreateDirectory, RemoveDirectory, ResetSessions
+			finish(FTP_RESULT::Success, FTP_ERROR::None);
+		}
+		break;
+	}
+}
+
+
+/**
+ * @brief Caller should hold m_lock.
+ *
+ */
+void mavlinksdk::CMavlinkFTPManager::handleNack (const T_PENDING_FTP& reply)
+{
+	const FTP_ERROR error = reply.size > 0 ? (FTP_ERROR) reply.data[0] : FTP_ERROR::Fail;
+
+	#ifdef DEBUG
+		std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: FTP Nack req_opcode:" << std::to_string((int)reply.req_opcode) << " error:" << std::to_string((int)error) << _NORMAL_CONSOLE_TEXT_ << std::endl;
+	#endif
+
+	switch (reply.req_opcode)
+	{
+		case FTP_OP::BurstReadFile:
+		case FTP_OP::ReadFile:
+			if (error == FTP_ERROR::EndOfFile)
+			{
+				if (reply.req_opcode == FTP_OP::BurstReadFile)
+				{
+					m_operation.eof = true;
+				}
+				else if (!m_operation.gaps.empty())
+				{
+					// nothing to fill beyond end of file.
+					m_operation.gaps.erase(m_operation.gaps.begin());
+				}
+				continueRead();
+				return ;
+			}
+			break;
+
+		case FTP_OP::ListDirectory:
+			if (error == FTP_ERROR::EndOfFile)
+			{
+				finish(FTP_RESULT::Success, FTP_ERROR::None);
+				return ;
+			}
+			break;
+
+		case FTP_OP::TerminateSession:
+			finish(m_operation.result, m_operation.error);
+			return ;
+
+		default:
+			break;
+	}
+
+	terminate(FTP_RESULT::Nack, error);
+}
+
+
+/**
+ * @brief resend last request if no reply is received. Fail operation after FTP_MAX_RETRIES.
+ *
+ */
+void mavlinksdk::CMavlinkFTPManager::checkTimeout ()
+{
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+
+		if (m_operation.type == FTP_OPERATION::None) return ;
+		if ((get_time_usec() - m_last_activity_time) < FTP_REPLY_TIMEOUT) return ;
+
+		if (m_retries >= FTP_MAX_RETRIES)
+		{
+			std::cout << _ERROR_CONSOLE_TEXT_ << "FTP Timeout: " << m_operation.path << _NORMAL_CONSOLE_TEXT_ << std::endl;
+
+			// do not wait for TerminateSession reply as link is not responding.
+			finish(FTP_RESULT::Timeout, FTP_ERROR::None);
+		}
+		else
+		{
+			const uint8_t retries = m_retries + 1;
+			if (m_last_request.opcode == FTP_OP::BurstReadFile)
+			{
+				// continue burst from last received offset.
+				continueRead();
+			}
+			else
+			{
+				resendRequest();
+			}
+			m_retries = retries;
+		}
+	}
+
+	runCompletion();
+}
+
+
+void mavlinksdk::CMavlinkFTPManager::loopTimeout ()
+{
+	while (!m_exit_thread)
+	{
+		// timer each 100m sec.
+		wait_time_nsec(0, 100000000);
+
+		checkTimeout();
+	}
+}
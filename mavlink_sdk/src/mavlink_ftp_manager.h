@@ -1,12 +1,24 @@
 #ifndef MAVLINK_FTP_MANAGER_H_
 #define MAVLINK_FTP_MANAGER_H_
 
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <functional>
 #include <all/mavlink.h>
 #include <ardupilotmega/ardupilotmega.h>
 
 namespace mavlinksdk
 {
 
+#define FTP_MAX_DATA_LENGTH         239         // data bytes in a single FTP payload.
+#define FTP_REPLY_TIMEOUT           500000      // usec without reply before resending last request.
+#define FTP_MAX_RETRIES             5
+#define FTP_PARAM_FILE              "@PARAM/param.pck"
+
+
  enum class FTP_OP : uint8_t {
         None = 0,
         TerminateSession = 1,
@@ -28,9 +40,34 @@ namespace mavlinksdk
         Nack = 129,
     };
 
+/**
+ * @brief error code sent in data[0] of a Nack.
+ *
+ */
+ enum class FTP_ERROR : uint8_t {
+        None = 0,
+        Fail = 1,
+        FailErrno = 2,
+        InvalidDataSize = 3,
+        InvalidSession = 4,
+        NoSessionsAvailable = 5,
+        EndOfFile = 6,
+        UnknownCommand = 8,
+        FileExists = 9,
+        FileProtected = 10,
+        FileNotFound = 11,
+    };
+
+ enum class FTP_RESULT : uint8_t {
+        Success = 0,
+        Nack = 1,           // error code is FTP_ERROR
+        Timeout = 2,
+        Busy = 3,           // another operation is in progress.
+    };
+
 typedef struct T_PENDING_FTP {
         uint32_t offset;
-        mavlink_channel_t chan;        
+        mavlink_channel_t chan;
         uint16_t seq_number;
         mavlinksdk::FTP_OP opcode;
         mavlinksdk::FTP_OP req_opcode;
@@ -42,6 +79,56 @@ typedef struct T_PENDING_FTP {
         uint8_t data[239];
     } T_PENDING_FTP;
 
+
+typedef std::function<void (const FTP_RESULT result, const FTP_ERROR error)> FTP_RESULT_CALLBACK;
+typedef std::function<void (const FTP_RESULT result, const FTP_ERROR error, const std::vector<uint8_t>& data)> FTP_DATA_CALLBACK;
+typedef std::function<void (const FTP_RESULT result, const FTP_ERROR error, const std::vector<std::string>& entries)> FTP_LIST_CALLBACK;
+typedef std::function<void (const FTP_RESULT result, const FTP_ERROR error, const uint32_t crc32)> FTP_CRC_CALLBACK;
+
+
+ enum class FTP_OPERATION : uint8_t {
+        None = 0,
+        ReadFile,
+        ListDirectory,
+        CalcFileCRC32,
+        WriteFile,
+        Single,             // operations of a single request/reply. RemoveFile, Rename ...etc.
+    };
+
+
+/**
+ * @brief State of the active FTP operation.
+ *
+ */
+typedef struct T_FTP_OPERATION {
+        FTP_OPERATION type = FTP_OPERATION::None;
+        std::string path;
+        uint8_t session = 0;
+        bool session_open = false;
+        bool eof = false;
+        uint32_t file_size = 0;
+        uint32_t offset = 0;                                // ReadFile: next expected offset. WriteFile: next offset to write.
+        std::vector<std::pair<uint32_t, uint32_t>> gaps;    // ReadFile: missing [offset, length) ranges of burst reads.
+        std::vector<uint8_t> data;                          // ReadFile: received file. WriteFile: file to write.
+        std::vector<std::string> entries;
+        uint32_t entries_count = 0;                         // ListDirectory: offset of next request including skipped entries.
+        uint32_t crc32 = 0;
+        FTP_RESULT result = FTP_RESULT::Success;
+        FTP_ERROR error = FTP_ERROR::None;
+        FTP_RESULT_CALLBACK result_callback;
+        FTP_DATA_CALLBACK data_callback;
+        FTP_LIST_CALLBACK list_callback;
+        FTP_CRC_CALLBACK crc_callback;
+    } T_FTP_OPERATION;
+
+
+/**
+ * @brief MAVLink FTP client.
+ * @details Only one operation is active at a time. Requests are resent if no reply is received within FTP_REPLY_TIMEOUT.
+ * Files are read using BurstReadFile, missing ranges are re-requested using ReadFile.
+ * @see https://mavlink.io/en/services/ftp.html
+ *
+ */
 class CMavlinkFTPManager
 {
     public:
@@ -55,7 +142,7 @@ class CMavlinkFTPManager
             CMavlinkFTPManager(CMavlinkFTPManager const&)               = delete;
             void operator=(CMavlinkFTPManager const&)                   = delete;
 
-        
+
             // Note: Scott Meyers mentions in his Effective Modern
             //       C++ book, that deleted functions should generally
             //       be public as it results in better error messages
@@ -67,18 +154,82 @@ class CMavlinkFTPManager
             CMavlinkFTPManager() {};
 
         public:
-            
-            ~CMavlinkFTPManager ()
-            {
 
-            }
+            ~CMavlinkFTPManager ();
 
         public:
 
+            /**
+             * @brief download @PARAM/param.pck and load it into CMavlinkParameterManager.
+             * Falls back to PARAM_REQUEST_LIST if FTP is not supported or download fails.
+             *
+             */
             void requestMavFTPParamList();
 
-};
+            bool readFile (const std::string& path, FTP_DATA_CALLBACK callback);
+            bool listDirectory (const std::string& path, FTP_LIST_CALLBACK callback);
+            bool calcFileCRC32 (const std::string& path, FTP_CRC_CALLBACK callback);
+            bool writeFile (const std::string& path, const std::vector<uint8_t>& data, FTP_RESULT_CALLBACK callback);
+            bool removeFile (const std::string& path, FTP_RESULT_CALLBACK callback);
+            bool truncateFile (const std::string& path, const uint32_t length, FTP_RESULT_CALLBACK callback);
+            bool createDirectory (const std::string& path, FTP_RESULT_CALLBACK callback);
+            bool removeDirectory (const std::string& path, FTP_RESULT_CALLBACK callback);
+            bool rename (const std::string& path_from, const std::string& path_to, FTP_RESULT_CALLBACK callback);
+            bool resetSessions (FTP_RESULT_CALLBACK callback);
+
+            const bool isBusy () const
+            {
+                const std::lock_guard<std::mutex> lock(m_lock);
+                return m_operation.type != FTP_OPERATION::None;
+            }
 
+        public:
+
+            void handle_file_transfer_protocol (const mavlink_file_transfer_protocol_t& file_transfer_protocol);
+
+            static uint32_t crc32 (const uint8_t* buffer, const std::size_t length, uint32_t crc = 0);
+
+        protected:
+
+            bool beginOperation (const FTP_OPERATION type, const std::string& path);
+            bool singleRequest (const FTP_OP opcode, const std::string& path, const uint32_t offset, const uint8_t* data, const uint8_t size, FTP_RESULT_CALLBACK callback);
+            void sendRequest (const FTP_OP opcode, const uint8_t session, const uint32_t offset, const uint8_t* data, const uint8_t size);
+            void resendRequest ();
+            void continueRead ();
+            void continueWrite ();
+            void terminate (const FTP_RESULT result, const FTP_ERROR error);
+            void finish (const FTP_RESULT result, const FTP_ERROR error);
+            void handleAck (const T_PENDING_FTP& reply);
+            void handleNack (const T_PENDING_FTP& reply);
+            void checkTimeout ();
+            void loopTimeout ();
+            void runCompletion ();
+
+        protected:
+
+            T_FTP_OPERATION m_operation;
+
+            /**
+             * @brief last request sent. It is resent on timeout.
+             *
+             */
+            T_PENDING_FTP m_last_request;
+            uint16_t m_seq_number = 0;
+            uint64_t m_last_activity_time = 0;
+            uint8_t m_retries = 0;
+
+            /**
+             * @brief callback of finished operation. It is called after m_lock is released.
+             *
+             */
+            std::function<void ()> m_completion;
+
+            mutable std::mutex m_lock;
+            std::thread m_timeout_thread;
+            bool m_timeout_thread_started = false;
+            std::atomic<bool> m_exit_thread{false};
 };
 
+}
+
 #endif
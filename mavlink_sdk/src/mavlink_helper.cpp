@@ -1,3 +1,4 @@
+#include <cstring>
 #include <ardupilotmega/mavlink.h>
 
 #include "./helpers/colors.h"
@@ -123,3 +124,21 @@ std::string CMavlinkHelper::getACKError (const int& result)
 }
 
 
+/**
+ * @brief read uint32 extension field that is not known to the bundled message definitions
+ * e.g. opaque_id of MISSION_COUNT, MISSION_ACK & MISSION_CURRENT.
+ * MAVLink2 trims trailing zero bytes of payload so missing bytes are zeros.
+ * 
+ * @param offset byte offset of field in payload.
+ * @return 0 if field is not sent.
+ */
+uint32_t CMavlinkHelper::getExtensionUInt32 (const mavlink_message_t& mavlink_message, const uint8_t offset)
+{
+    if (mavlink_message.len <= offset) return 0;
+
+    uint8_t bytes[4] = {0};
+    const uint8_t length = (mavlink_message.len - offset) < 4 ? (mavlink_message.len - offset) : 4;
+    memcpy(bytes, _MAV_PAYLOAD(&mavlink_message) + offset, length);
+    
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <string>
+#include <all/mavlink.h>
 
 namespace mavlinksdk
 {
@@ -19,6 +20,8 @@ namespace mavlinksdk
             static std::string getMissionACKResult (const int& result);
 
             static std::string getACKError (const int& result);        
+
+            static uint32_t getExtensionUInt32 (const mavlink_message_t& mavlink_message, const uint8_t offset);
             
     };
 
@@ -0,0 +1,419 @@
+#include <iostream>
+#include <cstring>
+
+
+#include "./helpers/colors.h"
+#include "./helpers/utils.h"
+#include "mavlink_sdk.h"
+#include "vehicle.h"
+#include "mavlink_log_manager.h"
+
+
+using namespace mavlinksdk;
+
+#define GCS_SYSID 255
+
+// progress callback is called each this number of chunks.
+#define LOG_PROGRESS_CHUNKS         256
+
+
+mavlinksdk::CMavlinkLogManager::~CMavlinkLogManager ()
+{
+	m_exit_thread = true;
+	if (m_timeout_thread.joinable())
+	{
+		m_timeout_thread.join();
+	}
+}
+
+
+bool mavlinksdk::CMavlinkLogManager::requestLogList (LOG_LIST_CALLBACK callback)
+{
+	const std::lock_guard<std::mutex> lock(m_lock);
+
+	if (m_list_active || m_download.active) return false;
+
+	m_list_active = true;
+	m_entries.clear();
+	m_list_callback = callback;
+	m_last_activity_time = get_time_usec();
+
+	startTimeoutThread();
+	sendLogRequestList();
+
+	return true;
+}
+
+
+bool mavlinksdk::CMavlinkLogManager::downloadLog (const uint16_t id, const uint32_t size, const std::string& file_path, LOG_DOWNLOAD_CALLBACK callback, LOG_PROGRESS_CALLBACK progress_callback)
+{
+	const std::lock_guard<std::mutex> lock(m_lock);
+
+	if (m_list_active || m_download.active) return false;
+	if (size == 0) return false;
+
+	m_download = T_LOG_DOWNLOAD();
+	// buffer should be set before opening file.
+	m_download.file.rdbuf()->pubsetbuf(m_file_buffer, LOG_FILE_BUFFER_SIZE);
+	m_download.file.open(file_path, std::ios::binary | std::ios::out | std::ios::trunc);
+	if (!m_download.file.is_open())
+	{
+		std::cout << _ERROR_CONSOLE_TEXT_ << "Cannot create log file: " << file_path << _NORMAL_CONSOLE_TEXT_ << std::endl;
+		return false;
+	}
+
+	m_download.active = true;
+	m_download.id = id;
+	m_download.size = size;
+	m_download.file_path = file_path;
+	m_download.chunks.assign((size + LOG_DATA_CHUNK_LENGTH - 1) / LOG_DATA_CHUNK_LENGTH, false);
+	m_download.callback = callback;
+	m_download.progress_callback = progress_callback;
+	m_download.start_time = get_time_usec();
+	m_last_activity_time = m_download.start_time;
+
+	startTimeoutThread();
+
+	// stream whole log. missing chunks are requested later.
+	m_download.request_offset = 0;
+	m_download.request_end = size;
+	sendLogRequestData(id, 0, size);
+
+	return true;
+}
+
+
+void mavlinksdk::CMavlinkLogManager::cancel ()
+{
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+
+		if (m_download.active)
+		{
+			finishDownload(LOG_RESULT::Cancelled);
+		}
+		else if (m_list_active)
+		{
+			finishList(LOG_RESULT::Cancelled);
+		}
+	}
+
+	runCompletion();
+}
+
+
+/**
+ * @brief Caller should hold m_lock.
+ *
+ */
+void mavlinksdk::CMavlinkLogManager::startTimeoutThread ()
+{
+	if (m_timeout_thread_started) return ;
+
+	m_timeout_thread_started = true;
+	m_timeout_thread = std::thread{[&](){ loopTimeout(); }};
+}
+
+
+void mavlinksdk::CMavlinkLogManager::sendLogRequestList () const
+{
+	const mavlinksdk::CVehicle &vehicle =  mavlinksdk::CVehicle::getInstance();
+
+	mavlink_log_request_list_t log_request_list;
+	log_request_list.target_system = vehicle.getSysId();
+	log_request_list.target_component = vehicle.getCompId();
+	log_request_list.start = 0;
+	log_request_list.end = 0xffff;
+
+	mavlink_message_t mavlink_message;
+	mavlink_msg_log_request_list_encode(GCS_SYSID, 190, &mavlink_message, &log_request_list);
+
+	mavlinksdk::CMavlinkSDK::getInstance().sendMavlinkMessage(mavlink_message);
+}
+
+
+void mavlinksdk::CMavlinkLogManager::sendLogRequestData (const uint16_t id, const uint32_t offset, const uint32_t count) const
+{
+	#ifdef DEBUG
+		std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: LOG_REQUEST_DATA ofs:" << std::to_string(offset) << " count:" << std::to_string(count) << _NORMAL_CONSOLE_TEXT_ << std::endl;
+	#endif
+
+	const mavlinksdk::CVehicle &vehicle =  mavlinksdk::CVehicle::getInstance();
+
+	mavlink_log_request_data_t log_request_data;
+	log_request_data.target_system = vehicle.getSysId();
+	log_request_data.target_component = vehicle.getCompId();
+	log_request_data.id = id;
+	log_request_data.ofs = offset;
+	log_request_data.count = count;
+
+	mavlink_message_t mavlink_message;
+	mavlink_msg_log_request_data_encode(GCS_SYSID, 190, &mavlink_message, &log_request_data);
+
+	mavlinksdk::CMavlinkSDK::getInstance().sendMavlinkMessage(mavlink_message);
+}
+
+
+/**
+ * @brief ends log transfer mode in autopilot.
+ *
+ */
+void mavlinksdk::CMavlinkLogManager::sendLogRequestEnd () const
+{
+	const mavlinksdk::CVehicle &vehicle =  mavlinksdk::CVehicle::getInstance();
+
+	mavlink_log_request_end_t log_request_end;
+	log_request_end.target_system = vehicle.getSysId();
+	log_request_end.target_component = vehicle.getCompId();
+
+	mavlink_message_t mavlink_message;
+	mavlink_msg_log_request_end_encode(GCS_SYSID, 190, &mavlink_message, &log_request_end);
+
+	mavlinksdk::CMavlinkSDK::getInstance().sendMavlinkMessage(mavlink_message);
+}
+
+
+/**
+ * @brief request first run of missing chunks. Caller should hold m_lock.
+ *
+ * @return false if no chunk is missing.
+ */
+bool mavlinksdk::CMavlinkLogManager::requestNextGap ()
+{
+	const std::vector<bool>& chunks = m_download.chunks;
+	const uint32_t count = chunks.size();
+
+	// called once per request not per chunk, so a scan is cheap.
+	uint32_t first = 0;
+	while ((first < count) && chunks[first]) ++first;
+	if (first >= count) return false;
+
+	uint32_t last = first;
+	while ((last < count) && !chunks[last]) ++last;
+
+	m_download.request_offset = first * LOG_DATA_CHUNK_LENGTH;
+	m_download.request_end = last * LOG_DATA_CHUNK_LENGTH;
+	if (m_download.request_end > m_download.size) m_download.request_end = m_download.size;
+
+	sendLogRequestData(m_download.id, m_download.request_offset, m_download.request_end - m_download.request_offset);
+
+	return true;
+}
+
+
+/**
+ * @brief write chunk at its offset. Sequential chunks do not seek so they stay in stream buffer.
+ * Caller should hold m_lock.
+ *
+ */
+void mavlinksdk::CMavlinkLogManager::writeChunk (const uint32_t offset, const uint8_t* data, const uint8_t count)
+{
+	if (m_download.file_position != offset)
+	{
+		m_download.file.seekp(offset);
+		m_download.file_position = offset;
+	}
+
+	m_download.file.write((const char*) data, count);
+	m_download.file_position += count;
+}
+
+
+void mavlinksdk::CMavlinkLogManager::handle_log_entry (const mavlink_log_entry_t& log_entry)
+{
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+
+		if (!m_list_active) return ;
+
+		m_last_activity_time = get_time_usec();
+
+		if (log_entry.num_logs == 0)
+		{
+			// no logs on board.
+			m_entries.clear();
+			finishList(LOG_RESULT::Success);
+		}
+		else
+		{
+			bool found = false;
+			for (const mavlink_log_entry_t& entry : m_entries)
+			{
+				if (entry.id == log_entry.id)
+				{
+					found = true;
+					break;
+				}
+			}
+			if (!found) m_entries.push_back(log_entry);
+
+			if (m_entries.size() >= log_entry.num_logs)
+			{
+				finishList(LOG_RESULT::Success);
+			}
+		}
+	}
+
+	runCompletion();
+}
+
+
+void mavlinksdk::CMavlinkLogManager::handle_log_data (const mavlink_log_data_t& log_data)
+{
+	LOG_PROGRESS_CALLBACK progress_callback;
+	uint32_t received = 0;
+	uint32_t size = 0;
+
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+
+		if ((!m_download.active) || (log_data.id != m_download.id)) return ;
+
+		m_last_activity_time = get_time_usec();
+		m_download.retries = 0;
+
+		if (log_data.count > 0)
+		{
+			const uint32_t chunk = log_data.ofs / LOG_DATA_CHUNK_LENGTH;
+			if ((log_data.ofs % LOG_DATA_CHUNK_LENGTH != 0) || (chunk >= m_download.chunks.size())) return ;
+
+			if (!m_download.chunks[chunk])
+			{
+				const uint8_t count = log_data.count > LOG_DATA_CHUNK_LENGTH ? LOG_DATA_CHUNK_LENGTH : log_data.count;
+				writeChunk(log_data.ofs, log_data.data, count);
+				m_download.chunks[chunk] = true;
+				m_download.chunks_received++;
+
+				if ((m_download.progress_callback) && ((m_download.chunks_received % LOG_PROGRESS_CHUNKS) == 0))
+				{
+					progress_callback = m_download.progress_callback;
+					received = m_download.chunks_received * LOG_DATA_CHUNK_LENGTH;
+					size = m_download.size;
+				}
+			}
+		}
+
+		if (!m_download.file)
+		{
+			finishDownload(LOG_RESULT::FileError);
+		}
+		else if (m_download.chunks_received == m_download.chunks.size())
+		{
+			finishDownload(LOG_RESULT::Success);
+		}
+		else if ((log_data.count == 0) || ((log_data.ofs + log_data.count) >= m_download.request_end))
+		{
+			// active request is done. request what was missed.
+			requestNextGap();
+		}
+	}
+
+	if (progress_callback) progress_callback(received, size);
+
+	runCompletion();
+}
+
+
+/**
+ * @brief Caller should hold m_lock and call runCompletion after releasing it.
+ *
+ */
+void mavlinksdk::CMavlinkLogManager::finishList (const LOG_RESULT result)
+{
+	m_list_active = false;
+
+	if (m_list_callback)
+	{
+		LOG_LIST_CALLBACK callback = m_list_callback;
+		std::vector<mavlink_log_entry_t> entries = m_entries;
+		m_completion = [=]() { callback(result, entries); };
+	}
+	m_list_callback = nullptr;
+}
+
+
+/**
+ * @brief Caller should hold m_lock and call runCompletion after releasing it.
+ *
+ */
+void mavlinksdk::CMavlinkLogManager::finishDownload (const LOG_RESULT result)
+{
+	m_download.file.close();
+	m_download.active = false;
+
+	sendLogRequestEnd();
+
+	const uint64_t duration = get_time_usec() - m_download.start_time;
+
+	std::cout << _INFO_CONSOLE_TEXT << "Log " << std::to_string(m_download.id) << " download finished [" << std::to_string((int)result) << "] "
+			  << std::to_string(m_download.size) << " bytes in " << std::to_string(duration / 1000) << " ms" << _NORMAL_CONSOLE_TEXT_ << std::endl;
+
+	if (m_download.callback)
+	{
+		LOG_DOWNLOAD_CALLBACK callback = m_download.callback;
+		const std::string file_path = m_download.file_path;
+		const uint32_t size = m_download.size;
+		m_completion = [=]() { callback(result, file_path, size, duration); };
+	}
+
+	m_download.chunks.clear();
+	m_download.chunks.shrink_to_fit();
+	m_download.callback = nullptr;
+	m_download.progress_callback = nullptr;
+}
+
+
+void mavlinksdk::CMavlinkLogManager::runCompletion ()
+{
+	std::function<void ()> completion;
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+		completion = std::move(m_completion);
+		m_completion = nullptr;
+	}
+
+	if (completion) completion();
+}
+
+
+void mavlinksdk::CMavlinkLogManager::checkTimeout ()
+{
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+
+		const uint64_t now = get_time_usec();
+
+		if (m_list_active && ((now - m_last_activity_time) > LOG_LIST_TIMEOUT))
+		{
+			finishList(m_entries.empty() ? LOG_RESULT::Timeout : LOG_RESULT::Success);
+		}
+		else if (m_download.active && ((now - m_last_activity_time) > LOG_DATA_TIMEOUT))
+		{
+			m_download.retries++;
+			if (m_download.retries > LOG_MAX_RETRIES)
+			{
+				finishDownload(LOG_RESULT::Timeout);
+			}
+			else
+			{
+				// stream stalled or last request is lost.
+				m_last_activity_time = now;
+				requestNextGap();
+			}
+		}
+	}
+
+	runCompletion();
+}
+
+
+void mavlinksdk::CMavlinkLogManager::loopTimeout ()
+{
+	while (!m_exit_thread)
+	{
+		// timer each 100m sec.
+		wait_time_nsec(0, 100000000);
+
+		checkTimeout();
+	}
+}
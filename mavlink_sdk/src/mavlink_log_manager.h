@@ -0,0 +1,158 @@
+#ifndef MAVLINK_LOG_MANAGER_H_
+#define MAVLINK_LOG_MANAGER_H_
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <functional>
+#include <all/mavlink.h>
+
+namespace mavlinksdk
+{
+
+#define LOG_DATA_CHUNK_LENGTH       90          // data bytes in a single LOG_DATA.
+#define LOG_LIST_TIMEOUT            1000000     // usec without LOG_ENTRY before list is considered complete.
+#define LOG_DATA_TIMEOUT            500000      // usec without LOG_DATA before requesting missing chunks.
+#define LOG_MAX_RETRIES             10          // consecutive timeouts without progress before failing.
+#define LOG_FILE_BUFFER_SIZE        65536
+
+
+ enum class LOG_RESULT : uint8_t {
+        Success = 0,
+        Timeout = 1,
+        FileError = 2,
+        Cancelled = 3,
+    };
+
+
+typedef std::function<void (const LOG_RESULT result, const std::vector<mavlink_log_entry_t>& entries)> LOG_LIST_CALLBACK;
+typedef std::function<void (const LOG_RESULT result, const std::string& file_path, const uint32_t size, const uint64_t duration_us)> LOG_DOWNLOAD_CALLBACK;
+typedef std::function<void (const uint32_t received, const uint32_t size)> LOG_PROGRESS_CALLBACK;
+
+
+/**
+ * @brief State of active log download.
+ *
+ */
+typedef struct T_LOG_DOWNLOAD {
+        bool active = false;
+        uint16_t id = 0;
+        uint32_t size = 0;
+        std::string file_path;
+        std::ofstream file;
+        uint64_t file_position = 0;                 // position of file put pointer. Avoids seekp for sequential chunks.
+        std::vector<bool> chunks;                   // bit per LOG_DATA_CHUNK_LENGTH bytes. true if received.
+        uint32_t chunks_received = 0;
+        uint32_t request_offset = 0;                // offset of active LOG_REQUEST_DATA.
+        uint32_t request_end = 0;                   // end offset of active LOG_REQUEST_DATA.
+        uint64_t start_time = 0;
+        uint8_t retries = 0;
+        LOG_DOWNLOAD_CALLBACK callback;
+        LOG_PROGRESS_CALLBACK progress_callback;
+    } T_LOG_DOWNLOAD;
+
+
+/**
+ * @brief Downloads onboard (dataflash) logs using LOG_REQUEST_LIST, LOG_REQUEST_DATA & LOG_DATA.
+ * @details Autopilot serves a single LOG_REQUEST_DATA at a time, so the whole log is requested in one
+ * streaming request and received chunks are tracked in a bitmap. When the stream ends or stalls missing
+ * ranges are requested one after another. Data is written directly to file through a buffered stream.
+ * @see https://mavlink.io/en/services/log_transfer.html
+ *
+ */
+class CMavlinkLogManager
+{
+    public:
+            //https://stackoverflow.com/questions/1008019/c-singleton-design-pattern
+            static CMavlinkLogManager& getInstance()
+            {
+                static CMavlinkLogManager instance;
+                return instance;
+            }
+
+            CMavlinkLogManager(CMavlinkLogManager const&)               = delete;
+            void operator=(CMavlinkLogManager const&)                   = delete;
+
+
+            // Note: Scott Meyers mentions in his Effective Modern
+            //       C++ book, that deleted functions should generally
+            //       be public as it results in better error messages
+            //       due to the compilers behavior to check accessibility
+            //       before deleted status
+
+        private:
+
+            CMavlinkLogManager() {};
+
+        public:
+
+            ~CMavlinkLogManager ();
+
+        public:
+
+            bool requestLogList (LOG_LIST_CALLBACK callback);
+
+            /**
+             * @brief download log to file_path.
+             *
+             * @param id log id as in LOG_ENTRY.
+             * @param size log size as in LOG_ENTRY.
+             * @return false if another download is active or file cannot be created.
+             */
+            bool downloadLog (const uint16_t id, const uint32_t size, const std::string& file_path, LOG_DOWNLOAD_CALLBACK callback, LOG_PROGRESS_CALLBACK progress_callback = nullptr);
+            void cancel ();
+
+            const bool isBusy () const
+            {
+                const std::lock_guard<std::mutex> lock(m_lock);
+                return m_list_active || m_download.active;
+            }
+
+        public:
+
+            void handle_log_entry (const mavlink_log_entry_t& log_entry);
+            void handle_log_data (const mavlink_log_data_t& log_data);
+
+        protected:
+
+            void startTimeoutThread ();
+            void sendLogRequestList () const;
+            void sendLogRequestData (const uint16_t id, const uint32_t offset, const uint32_t count) const;
+            void sendLogRequestEnd () const;
+            bool requestNextGap ();
+            void writeChunk (const uint32_t offset, const uint8_t* data, const uint8_t count);
+            void finishList (const LOG_RESULT result);
+            void finishDownload (const LOG_RESULT result);
+            void checkTimeout ();
+            void loopTimeout ();
+            void runCompletion ();
+
+        protected:
+
+            bool m_list_active = false;
+            std::vector<mavlink_log_entry_t> m_entries;
+            LOG_LIST_CALLBACK m_list_callback;
+
+            T_LOG_DOWNLOAD m_download;
+            char m_file_buffer[LOG_FILE_BUFFER_SIZE];
+
+            uint64_t m_last_activity_time = 0;
+
+            /**
+             * @brief callback of finished operation. It is called after m_lock is released.
+             *
+             */
+            std::function<void ()> m_completion;
+
+            mutable std::mutex m_lock;
+            std::thread m_timeout_thread;
+            bool m_timeout_thread_started = false;
+            std::atomic<bool> m_exit_thread{false};
+};
+
+}
+
+#endif
@@ -1,9 +1,18 @@
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
 #include "./helpers/colors.h"
 #include "./helpers/utils.h"
 #include "mavlink_helper.h"
 #include "mavlink_command.h"
 #include "mavlink_parameter_manager.h"
+#include "mavlink_ftp_manager.h"
+#include "vehicle.h"
 
 
 
@@ -30,11 +39,20 @@ void mavlinksdk::CMavlinkParameterManager::set_callback_parameter (mavlinksdk::C
 void mavlinksdk::CMavlinkParameterManager::reloadParemeters ()
 {
 	m_parameter_read_mode = mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_LOAD_ALL_INIT;
+	m_parameter_requests.clear();
 
     mavlinksdk::CMavlinkCommand::getInstance().requestParametersList();
 }
 
 
+void mavlinksdk::CMavlinkParameterManager::setRequestWindow (const uint16_t window)
+{
+	m_request_window = window;
+	if (m_request_window == 0) m_request_window = 1;
+	if (m_request_window > PARAM_REQUEST_WINDOW_MAX) m_request_window = PARAM_REQUEST_WINDOW_MAX;
+}
+
+
 
 /**
  * @brief List of all parameters as a response of PARAM_REQUEST_LIST
@@ -51,21 +69,37 @@ void mavlinksdk::CMavlinkParameterManager::handle_param_value (const mavlink_par
 	memcpy((void *)&param_id[0], param_message.param_id,16);
 	std::string param_name = std::string(param_id);
 
-	auto it = m_parameters_list.find(param_name);
+	if (param_name == PARAM_HASH_CHECK)
+	{
+		handle_hash_check(param_message);
+		return ;
+	}
+
+	const bool fresh = (param_message.param_index < param_message.param_count);
+	if (fresh && (m_parameters.size() != param_message.param_count))
+	{
+		// first parameter or FCB parameters count changed.
+		resizeStore(param_message.param_count);
+	}
 
-	// search for parameter in the received list and check if undapted or not.
-	if (it != m_parameters_list.end()) 
+	//IMPORTANT: param_index is 65535 when value is re-read.
+	const int32_t index = fresh ? param_message.param_index : findIndex(param_message.param_id);
+	if (index >= 0)
 	{
-		changed = (it->second.param_value != param_message.param_value);
-		if (changed) 
+		changed = storeParameter(param_message, (uint16_t) index);
+
 		{
-			it->second.param_value = param_message.param_value;
-			//IMPORTANT: param_index is 65535 when value is re-read.
+			const std::lock_guard<std::mutex> lock(m_write_lock);
+			if (!m_write_batch.outstanding.empty())
+			{
+				handle_write_echo((uint16_t) index, param_message);
+			}
 		}
-	} 
+		runWriteCallback();
+	}
 	
 	// if param_index is value then it is a new parameter.
-	if (param_message.param_index < param_message.param_count)
+	if (fresh)
 	{ 
 		// fresh account with index valid.
 		#ifdef DEBUG
@@ -77,44 +111,38 @@ void mavlinksdk::CMavlinkParameterManager::handle_param_value (const mavlink_par
 		m_parameters_last_receive_time =  get_time_usec();
 		m_parameter_read_count = param_message.param_count;
 		m_parameters_last_index_read = param_message.param_index;
-		m_parameters_list.insert(std::make_pair(param_name, param_message));
 
-		bool bFound = false;
-		for(auto itr=m_parameters_id.begin(); itr !=m_parameters_id.end(); itr++)
-		{
-        	if (*itr == param_message.param_index)
-			{
-				bFound = true;
-				break;
-			}
-		}
-
-		if (!bFound)
-		{
-			m_parameters_id.push_back(param_message.param_index);
-		}
+		markParameterReceived(param_message.param_index, param_message.param_count);
 	}
 
 	m_callback_parameter->OnParamReceived (param_name, param_message, changed, m_load_parameters_1st_iteration);
 
-	// if last parameter has been received then this is the last parameter
-	if (param_message.param_index == (param_message.param_count-1)) 
+	if (m_parameter_read_mode == mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_LIST_LOADED) return ;
+
+	// all indices are received.
+	if ((m_parameter_read_count > 0) && (m_parameters_received_count == m_parameter_read_count))
 	{ 
 		m_parameter_read_mode = mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_LIST_LOADED;
+		m_parameter_requests.clear();
 		std::cout << _SUCCESS_CONSOLE_BOLD_TEXT_ << "* Parameter LOADED " << _NORMAL_CONSOLE_TEXT_ << std::endl;
 		
 		m_callback_parameter->OnParamReceivedCompleted();
 		
 		m_load_parameters_1st_iteration = false;
+
+		saveCache();
+		if ((!m_cache_folder.empty()) && (m_hash_check == 0))
+		{
+			// PX4 reports a hash of its parameters. Ignored by ArduPilot.
+			mavlinksdk::CMavlinkCommand::getInstance().readParameter(PARAM_HASH_CHECK);
+		}
+
+		return ;
 	}
 
 	if (m_parameter_read_mode == mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_ONE_BY_ONE)
 	{
-		if (m_parameters_last_index_read < m_parameter_read_count)
-		{
-			// request next parameter index
-			mavlinksdk::CMavlinkCommand::getInstance().readParameterByIndex(m_parameters_last_index_read+1);
-		}
+		fillRequestWindow();
 	}
  	
 
@@ -130,118 +158,1125 @@ void mavlinksdk::CMavlinkParameterManager::handle_param_value (const mavlink_par
 
 
 /**
- * @brief parameters are loaded.
- * @details first time a request to load all parameters is reloadParemeters() then if timeout and not all
- * parameters are received then a one-by-one call is executed untill all parameters are received. m_parameter_read_mode is used to store status.
- * @callgraph
- * @param heartbeat mavlink message
+ * @brief FNV-1a of parameter name up to 16 chars.
+ *
  */
-void mavlinksdk::CMavlinkParameterManager::handle_heart_beat (const mavlink_heartbeat_t& heartbeat)
+uint32_t mavlinksdk::CMavlinkParameterManager::hashParameterName (const char* param_name)
 {
-    const uint64_t now = get_time_usec();
+	uint32_t hash = 2166136261u;
+	for (int i=0; (i<16) && (param_name[i] != 0); ++i)
+	{
+		hash ^= (uint8_t) param_name[i];
+		hash *= 16777619u;
+	}
 
-    #ifdef DEBUG
-	#ifdef DEBUG_DETAILED
-	 	std::cout << "Timeout readings: " << std::to_string((now - m_parameters_last_receive_time)) << std::endl;
-	#endif 
-	#endif
-	// Initialize request all poarameters
-	if (m_parameter_read_mode == mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_LIST_EMPTY)
+	return hash;
+}
+
+
+/**
+ * @brief clear store and allocate a slot per parameter.
+ *
+ */
+void mavlinksdk::CMavlinkParameterManager::resizeStore (const uint16_t param_count)
+{
+	m_parameters.assign(param_count, T_PARAMETER_SLOT());
+
+	std::size_t size = 16;
+	while (size < (2 * (std::size_t) param_count)) size <<= 1;
+	m_parameters_hash.assign(size, 0);
+
+	m_parameters_version++;
+
+	// time based so that a restarted module does not reuse epoch of a previous run.
+	const uint64_t now = get_time_usec();
+	const uint32_t epoch = (uint32_t) (now ^ (now >> 32));
+	m_parameters_epoch = ((epoch == 0) || (epoch == m_parameters_epoch)) ? epoch + 1 : epoch;
+}
+
+
+void mavlinksdk::CMavlinkParameterManager::rebuildHashIndex ()
+{
+	std::fill(m_parameters_hash.begin(), m_parameters_hash.end(), 0);
+
+	for (std::size_t i=0; i<m_parameters.size(); ++i)
 	{
-		reloadParemeters();
+		if (m_parameters[i].valid) insertHashIndex((uint16_t) i);
+	}
+}
 
-		return ;
+
+void mavlinksdk::CMavlinkParameterManager::insertHashIndex (const uint16_t param_index)
+{
+	const std::size_t mask = m_parameters_hash.size() - 1;
+	std::size_t bucket = hashParameterName(m_parameters[param_index].message.param_id) & mask;
+
+	while (m_parameters_hash[bucket] != 0)
+	{
+		if (m_parameters_hash[bucket] == param_index + 1) return ;
+		bucket = (bucket + 1) & mask;
 	}
 
-	// no parameter has been received yet.
-	if ((m_parameters_last_receive_time==0) 
-	&& (m_parameter_read_mode == mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_LOAD_ALL_INIT) // redundant condition flor clarity only.
-	&& ((now - m_parameters_last_receive_time) >  300000l))
+	m_parameters_hash[bucket] = param_index + 1;
+}
+
+
+/**
+ * @return param_index or -1 if not found.
+ */
+int32_t mavlinksdk::CMavlinkParameterManager::findIndex (const char* param_name) const
+{
+	if (m_parameters_hash.empty()) return -1;
+
+	const std::size_t mask = m_parameters_hash.size() - 1;
+	std::size_t bucket = hashParameterName(param_name) & mask;
+
+	for (std::size_t probe=0; probe<m_parameters_hash.size(); ++probe)
 	{
-		// Load all parameters at first
-		reloadParemeters();
+		const uint16_t entry = m_parameters_hash[bucket];
+		if (entry == 0) return -1;
 
-		return ;
+		const T_PARAMETER_SLOT& slot = m_parameters[entry - 1];
+		if (slot.valid && (strncmp(slot.message.param_id, param_name, 16) == 0)) return entry - 1;
+
+		bucket = (bucket + 1) & mask;
 	}
-		
 
-	// If still loading & timeout then load one-by-one.
-	if ((m_parameter_read_mode != mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_LIST_LOADED)  
-		 && ((now - m_parameters_last_receive_time) >  300000l))
+	return -1;
+}
+
+
+/**
+ * @brief store parameter in its slot.
+ *
+ * @param param_message if param_index is not valid only value is updated.
+ * @return true if an existing parameter with same name changed value.
+ */
+bool mavlinksdk::CMavlinkParameterManager::storeParameter (const mavlink_param_value_t& param_message, const uint16_t param_index)
+{
+	T_PARAMETER_SLOT& slot = m_parameters[param_index];
+
+	const bool same_name = slot.valid && (strncmp(slot.message.param_id, param_message.param_id, 16) == 0);
+	const bool changed = same_name && (slot.message.param_value != param_message.param_value);
+	const bool is_new = !same_name && (param_message.param_index < param_message.param_count);
+
+	if (param_message.param_index < param_message.param_count)
 	{
-		if (m_parameters_last_receive_time==0)
+		const bool had_other_name = slot.valid && !same_name;
+
+		slot.message = param_message;
+		slot.valid = true;
+
+		if (had_other_name)
 		{
-			// Load all parameters at first
-			reloadParemeters();
+			rebuildHashIndex();
 		}
-		else
+		else if (!same_name)
 		{
-			#ifdef DEBUG
-			#ifdef DEBUG_PARAM
-				std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  
-				<< _LOG_CONSOLE_TEXT << "DEBUG: MISSING PARAMs m_parameters_last_index_read:" << std::to_string(m_parameters_last_index_read) 
-				<< std::endl;
-			#endif
-			#endif
-			m_parameter_read_mode = mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_ONE_BY_ONE;
-			
-			const uint16_t index = getFirstMissingParameterByIndex();
-			if (index<m_parameter_read_count) 
-			{
-				mavlinksdk::CMavlinkCommand::getInstance().readParameterByIndex(index);
-			}
+			insertHashIndex(param_index);
 		}
 	}
+	else
+	{
+		slot.message.param_value = param_message.param_value;
+	}
+
+	if (changed || is_new)
+	{
+		m_parameters_version++;
+		slot.version = m_parameters_version;
+	}
+
+	return changed;
 }
 
-uint16_t mavlinksdk::CMavlinkParameterManager::getFirstMissingParameterByIndex()
+
+/**
+ * @brief decode @PARAM/param.pck downloaded by MAVLink FTP and feed parameters to handle_param_value.
+ * @details format: header [magic:16][num_params:16][total_params:16] then for each parameter
+ * [type:4 flags:4][common_len:4 name_len-1:4][name suffix][value][default value if flags & 1].
+ * Zero bytes are padding. Name shares common_len leading chars with previous parameter name.
+ * @see https://ardupilot.org/dev/docs/mavlink-get-set-params.html
+ *
+ * @param param_pck file contents.
+ * @return false if file is not valid.
+ */
+bool mavlinksdk::CMavlinkParameterManager::handle_param_pck (const std::vector<uint8_t>& param_pck)
 {
-	bool bFound;
+	if (param_pck.size() < 6) return false;
+
+	// same CRC autopilot reports for CalcFileCRC32 of this file. It identifies parameter set in cache.
+	m_param_pck_crc = mavlinksdk::CMavlinkFTPManager::crc32(param_pck.data(), param_pck.size());
+
+	const uint8_t* buffer = param_pck.data();
+	const std::size_t length = param_pck.size();
+
+	uint16_t magic, num_params, total_params;
+	memcpy(&magic, &buffer[0], sizeof(uint16_t));
+	memcpy(&num_params, &buffer[2], sizeof(uint16_t));
+	memcpy(&total_params, &buffer[4], sizeof(uint16_t));
+
+	const bool with_defaults = (magic == 0x671c);
+	if ((magic != 0x671b) && (!with_defaults)) return false;
+	if (num_params > total_params) return false;
+
+	std::cout << _INFO_CONSOLE_TEXT << "FTP Parameters: " << std::to_string(num_params) << " of " << std::to_string(total_params) << _NORMAL_CONSOLE_TEXT_ << std::endl;
+
+	char name[17] = {0};
 	uint16_t index = 0;
-	for (int i=0; i< m_parameter_read_count; ++i)
+	std::size_t i = 6;
+	while ((i < length) && (index < num_params))
 	{
-		bFound = false;
-		for(auto itr=m_parameters_id.begin(); itr !=m_parameters_id.end(); itr++)
+		if (buffer[i] == 0)
 		{
-			if (i==*itr)
-			{
-				bFound = true;
+			// padding
+			++i;
+			continue;
+		}
+
+		if (i + 2 > length) return false;
+
+		const uint8_t type = buffer[i] & 0x0F;
+		const uint8_t flags = buffer[i] >> 4;
+		const uint8_t common_len = buffer[i+1] & 0x0F;
+		const uint8_t name_len = (buffer[i+1] >> 4) + 1;
+		i += 2;
+
+		if ((common_len + name_len) > 16) return false;
+		if (i + name_len > length) return false;
+
+		memcpy(&name[common_len], &buffer[i], name_len);
+		name[common_len + name_len] = 0;
+		i += name_len;
+
+		mavlink_param_value_t param_message = {0};
+		std::size_t value_size;
+		switch (type)
+		{
+			case 1: // AP_PARAM_INT8
+				value_size = 1;
+				if (i + value_size > length) return false;
+				param_message.param_type = MAV_PARAM_TYPE_INT8;
+				param_message.param_value = (float)(int8_t)buffer[i];
 				break;
+
+			case 2: // AP_PARAM_INT16
+			{
+				value_size = 2;
+				if (i + value_size > length) return false;
+				int16_t value;
+				memcpy(&value, &buffer[i], value_size);
+				param_message.param_type = MAV_PARAM_TYPE_INT16;
+				param_message.param_value = (float)value;
 			}
+			break;
+
+			case 3: // AP_PARAM_INT32
+			{
+				value_size = 4;
+				if (i + value_size > length) return false;
+				int32_t value;
+				memcpy(&value, &buffer[i], value_size);
+				param_message.param_type = MAV_PARAM_TYPE_INT32;
+				param_message.param_value = (float)value;
+			}
+			break;
+
+			case 4: // AP_PARAM_FLOAT
+				value_size = 4;
+				if (i + value_size > length) return false;
+				param_message.param_type = MAV_PARAM_TYPE_REAL32;
+				memcpy(&param_message.param_value, &buffer[i], value_size);
+				break;
+
+			default:
+				return false;
 		}
-		
-		if (!bFound) 
+
+		i += value_size;
+		if (with_defaults && (flags & 0x01))
 		{
-			std::cout<<"\n index:"<<index<<std::endl;
-			return i;
+			// default value is not used.
+			i += value_size;
 		}
+
+		memset(param_message.param_id, 0, 16);
+		memcpy(param_message.param_id, name, std::min(strlen(name), (size_t)16));
+		param_message.param_index = index;
+		param_message.param_count = total_params;
+
+		handle_param_value(param_message);
+
+		++index;
 	}
 
-	
-	return m_parameter_read_count;
+	if (m_parameter_read_mode != mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_LIST_LOADED)
+	{
+		// file has less parameters than total. let handle_heart_beat timeout request missing ones.
+		m_parameter_read_mode = mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_LOAD_ALL_INIT;
+	}
+
+	return index > 0;
 }
 
+
 /**
- * @brief returns parameter by name. This is a helper function can be used by other modules.
- * 
- * @param pram_name 
- * @callgraph
- * @return const mavlink_param_value_t if mavlink_param_value_t.param_index=-1 then parameter is not found.
+ * @brief autopilot UID identifies vehicle in parameter cache.
+ *
  */
-const mavlink_param_value_t mavlinksdk::CMavlinkParameterManager::getParameterByName(const std::string param_name) const 
+void mavlinksdk::CMavlinkParameterManager::handle_autopilot_version (const mavlink_autopilot_version_t& autopilot_version)
 {
-	const std::map<std::string, mavlink_param_value_t>& parameters_list = getParametersList();
-	
-	auto it = parameters_list.find(param_name);
+	std::ostringstream uid;
+	uid << std::hex << std::setfill('0');
 
-	if (it == parameters_list.end())
+	if (autopilot_version.uid != 0)
 	{
-		mavlink_param_value_t t;
-		t.param_index = -1;
+		uid << std::setw(16) << autopilot_version.uid;
+	}
+	else
+	{
+		bool valid = false;
+		for (int i=0; i<18; ++i)
+		{
+			valid |= (autopilot_version.uid2[i] != 0);
+			uid << std::setw(2) << (int)autopilot_version.uid2[i];
+		}
+		if (!valid) return ;
+	}
+
+	m_autopilot_uid = uid.str();
+}
+
+
+/**
+ * @brief _HASH_CHECK is a hash of all parameters reported by PX4.
+ *
+ */
+void mavlinksdk::CMavlinkParameterManager::handle_hash_check (const mavlink_param_value_t& param_message)
+{
+	memcpy(&m_hash_check, &param_message.param_value, sizeof(uint32_t));
+
+	if (m_parameter_read_mode == mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_CACHE_CHECK)
+	{
+		if (m_cache_hash_check == 0) return ;
+
+		if (m_hash_check == m_cache_hash_check)
+		{
+			onCacheValid();
+		}
+		else
+		{
+			onCacheInvalid();
+		}
+	}
+	else if (m_parameter_read_mode == mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_LIST_LOADED)
+	{
+		saveCache();
+	}
+}
+
+
+void mavlinksdk::CMavlinkParameterManager::enableCache (const std::string& folder)
+{
+	m_cache_folder = folder;
+	if ((!m_cache_folder.empty()) && (m_cache_folder.back() != '/'))
+	{
+		m_cache_folder.push_back('/');
+	}
+}
+
+
+const std::string mavlinksdk::CMavlinkParameterManager::getCacheFileName () const
+{
+	return m_cache_folder + "param_" + std::to_string(mavlinksdk::CVehicle::getInstance().getSysId()) + "_" + m_autopilot_uid + ".cache";
+}
+
+
+/**
+ * @brief read cache file of current vehicle into m_cache_parameters.
+ * @details format: header line, then [sysid uid pck_crc hash_check count], then a line [name type value_bits] per parameter.
+ *
+ * @return false if no cache file or file is corrupted.
+ */
+bool mavlinksdk::CMavlinkParameterManager::loadCache ()
+{
+	m_cache_parameters.clear();
+
+	if (m_cache_folder.empty() || m_autopilot_uid.empty()) return false;
+
+	std::ifstream file (getCacheFileName());
+	if (!file.is_open()) return false;
+
+	std::string header, uid;
+	int sysid;
+	uint32_t count;
+	file >> header >> sysid >> uid >> std::hex >> m_cache_pck_crc >> m_cache_hash_check >> std::dec >> count;
+	if ((!file) || (header != "DE_PARAM_CACHE_1") || (uid != m_autopilot_uid) || (count == 0)) return false;
+
+	m_cache_parameters.reserve(count);
+	for (uint32_t i=0; i<count; ++i)
+	{
+		std::string name;
+		int type;
+		uint32_t value_bits;
+		file >> name >> std::dec >> type >> std::hex >> value_bits;
+		if ((!file) || (name.length() > 16))
+		{
+			m_cache_parameters.clear();
+			return false;
+		}
+
+		mavlink_param_value_t param_message = {0};
+		memset(param_message.param_id, 0, 16);
+		memcpy(param_message.param_id, name.c_str(), std::min(name.length(), (size_t)16));
+		param_message.param_type = (uint8_t) type;
+		memcpy(&param_message.param_value, &value_bits, sizeof(float));
+		param_message.param_index = (uint16_t) i;
+		param_message.param_count = (uint16_t) count;
+		m_cache_parameters.push_back(param_message);
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief write loaded parameters ordered by index. File is replaced atomically.
+ *
+ */
+void mavlinksdk::CMavlinkParameterManager::saveCache () const
+{
+	if (m_cache_folder.empty() || m_autopilot_uid.empty()) return ;
+	if ((m_param_pck_crc == 0) && (m_hash_check == 0)) return ; // cannot be validated later.
+	if (m_parameter_read_count == 0) return ;
+
+	if (m_parameters.size() != (std::size_t) m_parameter_read_count) return ;
+
+	const std::string file_name = getCacheFileName();
+	const std::string temp_file_name = file_name + ".tmp";
+	{
+		std::ofstream file (temp_file_name, std::ios::trunc);
+		if (!file.is_open()) return ;
+
+		file << "DE_PARAM_CACHE_1" << "\n"
+			 << std::to_string(mavlinksdk::CVehicle::getInstance().getSysId()) << " " << m_autopilot_uid << " "
+			 << std::hex << m_param_pck_crc << " " << m_hash_check << " " << std::dec << m_parameter_read_count << "\n";
 		
-		return t; // not found
-	} 
+		for (const T_PARAMETER_SLOT& slot : m_parameters)
+		{
+			if (!slot.valid) return ; // incomplete. temp file is left unused.
+			const mavlink_param_value_t* parameter = &slot.message;
+
+			char param_id[17];
+			param_id[16] = 0;
+			memcpy(param_id, parameter->param_id, 16);
+			uint32_t value_bits;
+			memcpy(&value_bits, &parameter->param_value, sizeof(uint32_t));
+
+			file << param_id << " " << std::dec << (int)parameter->param_type << " " << std::hex << value_bits << "\n";
+		}
+
+		if (!file) return ;
+	}
+
+	std::rename(temp_file_name.c_str(), file_name.c_str());
+}
+
+
+/**
+ * @brief ask autopilot for identity of its parameter set and compare it with cache.
+ * @details ArduPilot: CRC32 of @PARAM/param.pck using FTP. PX4: _HASH_CHECK parameter.
+ * Replies are handled by onCacheValid, onCacheInvalid or heartbeat timeout.
+ */
+void mavlinksdk::CMavlinkParameterManager::validateCache ()
+{
+	m_cache_check_time = get_time_usec();
+	m_cache_crc_failed = (m_cache_pck_crc == 0);
+
+	if (m_cache_hash_check != 0)
+	{
+		mavlinksdk::CMavlinkCommand::getInstance().readParameter(PARAM_HASH_CHECK);
+	}
+
+	if (m_cache_pck_crc != 0)
+	{
+		const bool started = mavlinksdk::CMavlinkFTPManager::getInstance().calcFileCRC32(FTP_PARAM_FILE, [this](const FTP_RESULT result, const FTP_ERROR error, const uint32_t crc32)
+		{
+			if (m_parameter_read_mode != mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_CACHE_CHECK) return ;
+
+			if (result == FTP_RESULT::Success)
+			{
+				m_param_pck_crc = crc32;
+				if (crc32 == m_cache_pck_crc)
+				{
+					onCacheValid();
+				}
+				else
+				{
+					onCacheInvalid();
+				}
+				return ;
+			}
+
+			// may be called on FTP thread. handle_heart_beat falls back to download.
+			m_cache_crc_failed = true;
+		});
+
+		if (!started) m_cache_crc_failed = true;
+	}
+
+	if (m_cache_crc_failed && (m_cache_hash_check == 0))
+	{
+		onCacheInvalid();
+	}
+}
+
+
+/**
+ * @brief cached parameters match autopilot. Load them as if received.
+ *
+ */
+void mavlinksdk::CMavlinkParameterManager::onCacheValid ()
+{
+	std::cout << _SUCCESS_CONSOLE_BOLD_TEXT_ << "* Parameters loaded from cache " << _NORMAL_CONSOLE_TEXT_ << std::endl;
+
+	m_parameter_read_mode = mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_LOAD_ALL_INIT;
+
+	const std::vector<mavlink_param_value_t> cache_parameters = std::move(m_cache_parameters);
+	m_cache_parameters.clear();
+	for (const mavlink_param_value_t& param_message : cache_parameters)
+	{
+		handle_param_value(param_message);
+	}
+}
+
+
+/**
+ * @brief parameters changed since cache is saved. Cached values are kept as initial values
+ * so only changed parameters are reported as changed when downloading.
+ *
+ */
+void mavlinksdk::CMavlinkParameterManager::onCacheInvalid ()
+{
+	std::cout << _INFO_CONSOLE_TEXT << "Parameters cache is outdated - downloading" << _NORMAL_CONSOLE_TEXT_ << std::endl;
+
+	if (!m_cache_parameters.empty())
+	{
+		resizeStore(m_cache_parameters.size());
+		for (const mavlink_param_value_t& param_message : m_cache_parameters)
+		{
+			storeParameter(param_message, param_message.param_index);
+		}
+		m_cache_parameters.clear();
+	}
+
+	m_parameter_read_mode = mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_FTP;
+	mavlinksdk::CMavlinkFTPManager::getInstance().requestMavFTPParamList();
+}
+
+
+/**
+ * @brief parameters are loaded.
+ * @details first time a request to load all parameters is reloadParemeters() then if timeout and not all
+ * parameters are received then a one-by-one call is executed untill all parameters are received. m_parameter_read_mode is used to store status.
+ * @callgraph
+ * @param heartbeat mavlink message
+ */
+void mavlinksdk::CMavlinkParameterManager::handle_heart_beat (const mavlink_heartbeat_t& heartbeat)
+{
+    const uint64_t now = get_time_usec();
+
+    #ifdef DEBUG
+	#ifdef DEBUG_DETAILED
+	 	std::cout << "Timeout readings: " << std::to_string((now - m_parameters_last_receive_time)) << std::endl;
+	#endif 
+	#endif
+	// Initialize request all poarameters
+	if (m_parameter_read_mode == mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_LIST_EMPTY)
+	{
+		if (!m_cache_folder.empty())
+		{
+			if (m_autopilot_uid.empty() && (m_autopilot_version_requests < PARAM_CACHE_VERSION_REQUESTS))
+			{
+				// AUTOPILOT_VERSION is requested by vehicle on first heartbeat. Repeat in case it is lost.
+				if (m_autopilot_version_requests > 0)
+				{
+					mavlinksdk::CMavlinkCommand::getInstance().requestMessageEmit(MAVLINK_MSG_ID_AUTOPILOT_VERSION);
+				}
+				m_autopilot_version_requests++;
+				
+				return ;
+			}
+
+			if (loadCache())
+			{
+				m_parameter_read_mode = mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_CACHE_CHECK;
+				validateCache();
+
+				return ;
+			}
+		}
+
+		// try FTP first. It falls back to reloadParemeters() if not supported.
+		m_parameter_read_mode = mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_FTP;
+		mavlinksdk::CMavlinkFTPManager::getInstance().requestMavFTPParamList();
+
+		return ;
+	}
+
+	// FTP manager handles its own timeouts and reports failure via postFTPLoadFailed().
+	if (m_parameter_read_mode == mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_FTP)
+	{
+		if (m_ftp_load_failed.exchange(false))
+		{
+			reloadParemeters();
+		}
+
+		return ;
+	}
+
+	if (m_parameter_read_mode == mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_CACHE_CHECK)
+	{
+		if ((m_cache_crc_failed && (m_cache_hash_check == 0))
+			|| ((now - m_cache_check_time) > PARAM_CACHE_CHECK_TIMEOUT))
+		{
+			// autopilot can identify neither param.pck nor _HASH_CHECK.
+			onCacheInvalid();
+		}
+
+		return ;
+	}
+
+	// no parameter has been received yet.
+	if ((m_parameters_last_receive_time==0) 
+	&& (m_parameter_read_mode == mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_LOAD_ALL_INIT) // redundant condition flor clarity only.
+	&& ((now - m_parameters_last_receive_time) >  300000l))
+	{
+		// Load all parameters at first
+		reloadParemeters();
+
+		return ;
+	}
+		
+
+	// If still loading & timeout then load one-by-one.
+	if ((m_parameter_read_mode != mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_LIST_LOADED)  
+		 && ((now - m_parameters_last_receive_time) >  300000l))
+	{
+		if (m_parameters_last_receive_time==0)
+		{
+			// Load all parameters at first
+			reloadParemeters();
+		}
+		else
+		{
+			#ifdef DEBUG
+			#ifdef DEBUG_PARAM
+				std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  
+				<< _LOG_CONSOLE_TEXT << "DEBUG: MISSING PARAMs m_parameters_last_index_read:" << std::to_string(m_parameters_last_index_read) 
+				<< std::endl;
+			#endif
+			#endif
+			if (m_parameter_read_mode != mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_ONE_BY_ONE)
+			{
+				m_parameter_read_mode = mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_ONE_BY_ONE;
+				m_next_missing_index = 0;
+				fillRequestWindow();
+			}
+			else if (m_parameter_requests.empty())
+			{
+				// pass is over and some indices were dropped after all retries. start another pass.
+				m_next_missing_index = 0;
+				fillRequestWindow();
+			}
+		}
+	}
+}
+
+
+/**
+ * @brief set bit of received index. Bitset is reset if FCB reports a different parameter count.
+ *
+ */
+void mavlinksdk::CMavlinkParameterManager::markParameterReceived (const uint16_t param_index, const uint16_t param_count)
+{
+	if (m_parameters_received.size() != param_count)
+	{
+		m_parameters_received.assign(param_count, false);
+		m_parameters_received_count = 0;
+		m_next_missing_index = 0;
+	}
+
+	if (!m_parameters_received[param_index])
+	{
+		m_parameters_received[param_index] = true;
+		m_parameters_received_count++;
+	}
+
+	auto it = m_parameter_requests.find(param_index);
+	if (it != m_parameter_requests.end())
+	{
+		// Karn's algorithm: only samples of requests that were not resent are valid.
+		if (it->second.retries == 0)
+		{
+			updateRequestTimeout(m_parameters_last_receive_time - it->second.sent_time);
+		}
+		m_parameter_requests.erase(it);
+	}
+}
+
+
+/**
+ * @brief keep up to m_request_window PARAM_REQUEST_READ outstanding for missing indices.
+ *
+ */
+void mavlinksdk::CMavlinkParameterManager::fillRequestWindow ()
+{
+	const uint64_t now = get_time_usec();
+
+	while ((m_parameter_requests.size() < m_request_window) && (m_next_missing_index < m_parameter_read_count))
+	{
+		const uint16_t index = m_next_missing_index++;
+		if (m_parameters_received[index]) continue;
+		if (m_parameter_requests.find(index) != m_parameter_requests.end()) continue;
+
+		T_PARAM_REQUEST& request = m_parameter_requests[index];
+		request.sent_time = now;
+		request.timeout = m_request_timeout;
+		request.retries = 0;
+		mavlinksdk::CMavlinkCommand::getInstance().readParameterByIndex(index);
+	}
+}
+
+
+/**
+ * @brief resend index requests that exceeded their timeout. Each resend doubles timeout of that request only.
+ * Requests that exceed PARAM_REQUEST_MAX_RETRIES are dropped so that they do not hold the window.
+ * Their indices are requested again in next pass. [see handle_heart_beat]
+ *
+ */
+void mavlinksdk::CMavlinkParameterManager::checkParameterRequests ()
+{
+	{
+		const std::lock_guard<std::mutex> lock(m_write_lock);
+		if (!m_write_batch.outstanding.empty())
+		{
+			checkWriteRequests(get_time_usec());
+		}
+	}
+	runWriteCallback();
+
+	if (m_parameter_read_mode != mavlinksdk::ENUM_LOADING_PARAMS_STATUS::LOADING_PARAMS_ONE_BY_ONE) return ;
+	if (m_parameter_requests.empty()) return ;
+
+	const uint64_t now = get_time_usec();
+	bool dropped = false;
+
+	auto it = m_parameter_requests.begin();
+	while (it != m_parameter_requests.end())
+	{
+		T_PARAM_REQUEST& request = it->second;
+		if ((now - request.sent_time) < request.timeout)
+		{
+			++it;
+			continue;
+		}
+
+		if (request.retries >= PARAM_REQUEST_MAX_RETRIES)
+		{
+			#ifdef DEBUG
+				std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: parameter index:" << std::to_string(it->first) << " dropped after retries" << _NORMAL_CONSOLE_TEXT_ << std::endl;
+			#endif
+			it = m_parameter_requests.erase(it);
+			dropped = true;
+			continue;
+		}
+
+		// back off this request only as it may be lost rather than link being congested.
+		request.sent_time = now;
+		request.retries++;
+		request.timeout *= 2;
+		if (request.timeout > PARAM_REQUEST_RTO_MAX) request.timeout = PARAM_REQUEST_RTO_MAX;
+		mavlinksdk::CMavlinkCommand::getInstance().readParameterByIndex(it->first);
+		++it;
+	}
+
+	if (dropped)
+	{
+		fillRequestWindow();
+	}
+}
+
+
+bool mavlinksdk::CMavlinkParameterManager::writeParameters (const std::vector<std::pair<std::string, float>>& parameters, PARAM_WRITE_CALLBACK callback, const uint16_t window)
+{
+	if (!isParametersListAvailable()) return false;
+	if (parameters.empty()) return false;
+
+	{
+		const std::lock_guard<std::mutex> lock(m_write_lock);
+		if (!m_write_batch.results.empty()) return false;
+
+		m_write_batch = T_PARAM_WRITE_BATCH();
+		m_write_batch.window = (window == 0) ? 1 : window;
+		m_write_batch.callback = callback;
+		m_write_batch.start_time = get_time_usec();
+		m_write_batch.results.resize(parameters.size());
+		for (std::size_t i=0; i<parameters.size(); ++i)
+		{
+			m_write_batch.results[i].param_name = parameters[i].first;
+			m_write_batch.results[i].requested_value = parameters[i].second;
+		}
+
+		fillWriteWindow();
+	}
+
+	// batch may be finished already if no parameter is found.
+	runWriteCallback();
+
+	return true;
+}
+
+
+/**
+ * @brief call callbacks of finished batches. Must be called without m_write_lock.
+ *
+ */
+void mavlinksdk::CMavlinkParameterManager::runWriteCallback ()
+{
+	std::vector<T_PARAM_WRITE_BATCH> write_batches;
+	{
+		const std::lock_guard<std::mutex> lock(m_write_lock);
+		if (m_write_batches_finished.empty()) return ;
+		write_batches.swap(m_write_batches_finished);
+	}
+
+	for (const T_PARAM_WRITE_BATCH& write_batch : write_batches)
+	{
+		if (write_batch.callback)
+		{
+			write_batch.callback(write_batch.results, write_batch.duration);
+		}
+	}
+}
+
+
+/**
+ * @brief PX4 reports PARAM_UNION capability. Its heartbeat is used before AUTOPILOT_VERSION is received.
+ *
+ */
+bool mavlinksdk::CMavlinkParameterManager::isBytewiseEncoding () const
+{
+	const mavlinksdk::CVehicle& vehicle = mavlinksdk::CVehicle::getInstance();
+
+	if ((vehicle.getMsgAutopilotVersion().capabilities & MAV_PROTOCOL_CAPABILITY_PARAM_UNION) != 0) return true;
+
+	return (vehicle.getMsgHeartBeat().autopilot == MAV_AUTOPILOT_PX4);
+}
+
+
+static inline bool isIntegerParameter (const uint8_t param_type)
+{
+	return (param_type != MAV_PARAM_TYPE_REAL32) && (param_type != MAV_PARAM_TYPE_REAL64);
+}
+
+
+/**
+ * @brief send PARAM_SET till window is full. Parameters not in the list fail immediately.
+ * Batch is finished here when all results are final. Called with m_write_lock held.
+ *
+ */
+void mavlinksdk::CMavlinkParameterManager::fillWriteWindow ()
+{
+	while ((m_write_batch.outstanding.size() < m_write_batch.window) && (m_write_batch.next < m_write_batch.results.size()))
+	{
+		const std::size_t position = m_write_batch.next++;
+		T_PARAM_WRITE_RESULT& write_result = m_write_batch.results[position];
+
+		const int32_t index = findIndex(write_result.param_name.c_str());
+		if ((index < 0) || (m_write_batch.outstanding.find((uint16_t) index) != m_write_batch.outstanding.end()))
+		{
+			// unknown or same parameter written twice in a batch.
+			write_result.result = PARAM_WRITE_NOT_FOUND;
+			m_write_batch.completed++;
+			continue;
+		}
+
+		// integer parameters are sent and echoed as float of their integer value.
+		// bytewise encoded values are kept as received.
+		if (!isBytewiseEncoding() && isIntegerParameter(m_parameters[index].message.param_type))
+		{
+			write_result.requested_value = (float) lround(write_result.requested_value);
+		}
+
+		m_write_batch.outstanding[(uint16_t) index] = position;
+		sendParameterSet((uint16_t) index, write_result);
+	}
+
+	if (m_write_batch.completed < m_write_batch.results.size()) return ;
+
+	// batch is finished. clear it so callback can start a new batch. [see runWriteCallback]
+	m_write_batch.duration = get_time_usec() - m_write_batch.start_time;
+
+	#ifdef DEBUG
+		std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: Parameters written: " << std::to_string(m_write_batch.results.size()) << " in " << std::to_string(m_write_batch.duration / 1000) << " ms" << _NORMAL_CONSOLE_TEXT_ << std::endl;
+	#endif
+
+	m_write_batches_finished.push_back(std::move(m_write_batch));
+	m_write_batch = T_PARAM_WRITE_BATCH();
+}
+
+
+void mavlinksdk::CMavlinkParameterManager::sendParameterSet (const uint16_t param_index, T_PARAM_WRITE_RESULT& write_result)
+{
+	write_result.attempts++;
+	m_write_batch.sent_time[param_index] = get_time_usec();
+
+	mavlinksdk::CMavlinkCommand::getInstance().writeParameter(write_result.param_name, write_result.requested_value);
+}
+
+
+/**
+ * @brief match echoed PARAM_VALUE with an outstanding PARAM_SET. Called with m_write_lock held.
+ *
+ */
+void mavlinksdk::CMavlinkParameterManager::handle_write_echo (const uint16_t param_index, const mavlink_param_value_t& param_message)
+{
+	auto it = m_write_batch.outstanding.find(param_index);
+	if (it == m_write_batch.outstanding.end()) return ;
+
+	T_PARAM_WRITE_RESULT& write_result = m_write_batch.results[it->second];
+	write_result.confirmed_value = param_message.param_value;
+
+	bool matched;
+	if (isBytewiseEncoding())
+	{
+		matched = (memcmp(&param_message.param_value, &write_result.requested_value, sizeof(float)) == 0);
+	}
+	else
+	{
+		matched = isIntegerParameter(param_message.param_type)
+			? (lround(param_message.param_value) == lround(write_result.requested_value))
+			: (param_message.param_value == write_result.requested_value);
+	}
+
+	if (matched)
+	{
+		if (write_result.attempts == 1)
+		{
+			updateRequestTimeout(get_time_usec() - m_write_batch.sent_time[param_index]);
+		}
+		completeWrite(param_index, PARAM_WRITE_CONFIRMED);
+		return ;
+	}
+
+	if (write_result.attempts >= PARAM_WRITE_MAX_ATTEMPTS)
+	{
+		completeWrite(param_index, PARAM_WRITE_MISMATCH);
+		return ;
+	}
+
+	// may be an echo of an older value. write again.
+	sendParameterSet(param_index, write_result);
+}
+
+
+void mavlinksdk::CMavlinkParameterManager::checkWriteRequests (const uint64_t now)
+{
+	std::vector<uint16_t> timed_out;
+
+	for (const auto& outstanding : m_write_batch.outstanding)
+	{
+		if ((now - m_write_batch.sent_time[outstanding.first]) >= m_request_timeout)
+		{
+			timed_out.push_back(outstanding.first);
+		}
+	}
+
+	for (const uint16_t param_index : timed_out)
+	{
+		// batch may be finished by a previous completeWrite.
+		auto it = m_write_batch.outstanding.find(param_index);
+		if (it == m_write_batch.outstanding.end()) continue;
+
+		T_PARAM_WRITE_RESULT& write_result = m_write_batch.results[it->second];
+		if (write_result.attempts >= PARAM_WRITE_MAX_ATTEMPTS)
+		{
+			completeWrite(param_index, PARAM_WRITE_TIMEOUT);
+		}
+		else
+		{
+			sendParameterSet(param_index, write_result);
+		}
+	}
+}
+
+
+void mavlinksdk::CMavlinkParameterManager::completeWrite (const uint16_t param_index, const ENUM_PARAM_WRITE_RESULT result)
+{
+	auto it = m_write_batch.outstanding.find(param_index);
+	if (it == m_write_batch.outstanding.end()) return ;
+
+	m_write_batch.results[it->second].result = result;
+	m_write_batch.completed++;
+	m_write_batch.outstanding.erase(it);
+	m_write_batch.sent_time.erase(param_index);
+
+	fillWriteWindow();
+}
+
+
+/**
+ * @brief RTO = SRTT + 4 * RTTVAR as in RFC 6298.
+ *
+ */
+void mavlinksdk::CMavlinkParameterManager::updateRequestTimeout (const uint64_t rtt)
+{
+	if (m_srtt == 0)
+	{
+		m_srtt = rtt;
+		m_rttvar = rtt / 2;
+	}
+	else
+	{
+		const uint64_t delta = (rtt > m_srtt) ? (rtt - m_srtt) : (m_srtt - rtt);
+		m_rttvar = (3 * m_rttvar + delta) / 4;
+		m_srtt = (7 * m_srtt + rtt) / 8;
+	}
+
+	m_request_timeout = m_srtt + 4 * m_rttvar;
+	if (m_request_timeout < PARAM_REQUEST_RTO_MIN) m_request_timeout = PARAM_REQUEST_RTO_MIN;
+	if (m_request_timeout > PARAM_REQUEST_RTO_MAX) m_request_timeout = PARAM_REQUEST_RTO_MAX;
+}
+
+uint16_t mavlinksdk::CMavlinkParameterManager::getFirstMissingParameterByIndex()
+{
+	for (uint16_t i=0; i< m_parameters_received.size(); ++i)
+	{
+		if (!m_parameters_received[i]) return i;
+	}
+	
+	return m_parameter_read_count;
+}
+
+/**
+ * @brief returns parameter by name. This is a helper function can be used by other modules.
+ * 
+ * @param pram_name 
+ * @callgraph
+ * @return const mavlink_param_value_t if mavlink_param_value_t.param_index=-1 then parameter is not found.
+ */
+const mavlink_param_value_t mavlinksdk::CMavlinkParameterManager::getParameterByName(const std::string& param_name) const 
+{
+	const mavlink_param_value_t* parameter = findParameter(param_name.c_str());
+
+	if (parameter == nullptr)
+	{
+		mavlink_param_value_t t;
+		t.param_index = -1;
+		
+		return t; // not found
+	} 
+
+	return *parameter;
+}
+
+
+const mavlink_param_value_t* mavlinksdk::CMavlinkParameterManager::findParameter (const char* param_name) const
+{
+	const int32_t index = findIndex(param_name);
+	if (index < 0) return nullptr;
+
+	return &m_parameters[index].message;
+}
+
+
+const mavlink_param_value_t* mavlinksdk::CMavlinkParameterManager::findParameter (const uint16_t param_index) const
+{
+	if ((param_index >= m_parameters.size()) || (!m_parameters[param_index].valid)) return nullptr;
+
+	return &m_parameters[param_index].message;
+}
+
+
+bool mavlinksdk::CMavlinkParameterManager::getParameterValue (const char* param_name, float& value) const
+{
+	const mavlink_param_value_t* parameter = findParameter(param_name);
+	if (parameter == nullptr) return false;
+
+	value = parameter->param_value;
+	return true;
+}
+
+
+/**
+ * @brief ArduPilot casts integer parameters to float. PX4 copies their bytes into param_value. [see isBytewiseEncoding]
+ *
+ */
+bool mavlinksdk::CMavlinkParameterManager::getParameterValue (const char* param_name, int32_t& value) const
+{
+	const mavlink_param_value_t* parameter = findParameter(param_name);
+	if (parameter == nullptr) return false;
+
+	if (!isBytewiseEncoding())
+	{
+		value = (int32_t) parameter->param_value;
+		return true;
+	}
+
+	switch (parameter->param_type)
+	{
+		case MAV_PARAM_TYPE_UINT8:
+		{
+			uint8_t raw;
+			memcpy(&raw, &parameter->param_value, sizeof(raw));
+			value = raw;
+		}
+		break;
+
+		case MAV_PARAM_TYPE_INT8:
+		{
+			int8_t raw;
+			memcpy(&raw, &parameter->param_value, sizeof(raw));
+			value = raw;
+		}
+		break;
+
+		case MAV_PARAM_TYPE_UINT16:
+		{
+			uint16_t raw;
+			memcpy(&raw, &parameter->param_value, sizeof(raw));
+			value = raw;
+		}
+		break;
+
+		case MAV_PARAM_TYPE_INT16:
+		{
+			int16_t raw;
+			memcpy(&raw, &parameter->param_value, sizeof(raw));
+			value = raw;
+		}
+		break;
+
+		case MAV_PARAM_TYPE_UINT32:
+		case MAV_PARAM_TYPE_INT32:
+			memcpy(&value, &parameter->param_value, sizeof(value));
+		break;
+
+		default:
+			// float parameter.
+			value = (int32_t) parameter->param_value;
+		break;
+	}
+
+	return true;
+}
+
+
+uint32_t mavlinksdk::CMavlinkParameterManager::getParameterVersion (const char* param_name) const
+{
+	const int32_t index = findIndex(param_name);
+	if (index < 0) return 0;
 
-	return it->second;
+	return m_parameters[index].version;
 }
-            
\ No newline at end of file
@@ -3,19 +3,98 @@
 
 
 #include <map>
+#include <atomic>
+#include <mutex>
 #include <vector>
 #include <cstdint>
+#include <string>
+#include <functional>
 
 namespace mavlinksdk
 {
 
+#define PARAM_REQUEST_WINDOW_DEFAULT    8           // outstanding PARAM_REQUEST_READ at a time.
+#define PARAM_REQUEST_WINDOW_MAX        64
+#define PARAM_REQUEST_RTO_INIT          300000      // usec initial request timeout.
+#define PARAM_REQUEST_RTO_MIN           50000       // usec
+#define PARAM_REQUEST_RTO_MAX           2000000     // usec
+#define PARAM_REQUEST_MAX_RETRIES       4           // resends of an index before it is dropped from window till next pass.
+
+#define PARAM_CACHE_CHECK_TIMEOUT       3000000     // usec waiting for cache validation before downloading.
+#define PARAM_CACHE_VERSION_REQUESTS    3           // heartbeats waiting for AUTOPILOT_VERSION before downloading without cache.
+#define PARAM_HASH_CHECK                "_HASH_CHECK"
+
+#define PARAM_WRITE_WINDOW_DEFAULT      8           // outstanding PARAM_SET at a time.
+#define PARAM_WRITE_MAX_ATTEMPTS        4
+
+
     typedef enum {
         LOADING_PARAMS_LIST_EMPTY       = 0,
         LOADING_PARAMS_LOAD_ALL_INIT    = 1,
         LOADING_PARAMS_ONE_BY_ONE       = 2,
-        LOADING_PARAMS_LIST_LOADED      = 3
+        LOADING_PARAMS_LIST_LOADED      = 3,
+        LOADING_PARAMS_FTP              = 4,    // downloading @PARAM/param.pck using MAVLink FTP.
+        LOADING_PARAMS_CACHE_CHECK      = 5     // validating parameters cached on disk.
     } ENUM_LOADING_PARAMS_STATUS;
 
+    /**
+     * @brief PARAM_REQUEST_READ sent by index and waiting for PARAM_VALUE.
+     *
+     */
+    typedef struct T_PARAM_REQUEST {
+        uint64_t sent_time;
+        uint64_t timeout;       // usec. doubled with each resend of this request.
+        uint8_t retries;
+    } T_PARAM_REQUEST;
+
+    /**
+     * @brief parameter stored at its param_index.
+     *
+     */
+    typedef struct T_PARAMETER_SLOT {
+        mavlink_param_value_t message = {};
+        uint32_t version = 0;       // value of getParametersVersion() when parameter was stored or last changed.
+        bool valid = false;
+    } T_PARAMETER_SLOT;
+
+    typedef enum {
+        PARAM_WRITE_PENDING             = 0,
+        PARAM_WRITE_CONFIRMED           = 1,    // FCB echoed requested value.
+        PARAM_WRITE_MISMATCH            = 2,    // FCB echoed a different value. i.e. rejected or clamped.
+        PARAM_WRITE_TIMEOUT             = 3,
+        PARAM_WRITE_NOT_FOUND           = 4
+    } ENUM_PARAM_WRITE_RESULT;
+
+    typedef struct T_PARAM_WRITE_RESULT {
+        std::string param_name;
+        float requested_value = 0.0f;
+        float confirmed_value = 0.0f;
+        mavlinksdk::ENUM_PARAM_WRITE_RESULT result = PARAM_WRITE_PENDING;
+        uint8_t attempts = 0;
+    } T_PARAM_WRITE_RESULT;
+
+    /**
+     * @brief called once when all parameters of a batch are confirmed or failed.
+     *
+     */
+    typedef std::function<void (const std::vector<T_PARAM_WRITE_RESULT>& results, const uint64_t duration_us)> PARAM_WRITE_CALLBACK;
+
+    /**
+     * @brief active batch write.
+     *
+     */
+    typedef struct T_PARAM_WRITE_BATCH {
+        std::vector<T_PARAM_WRITE_RESULT> results;
+        std::map<uint16_t, std::size_t> outstanding;    // param_index -> position in results.
+        std::map<uint16_t, uint64_t> sent_time;         // param_index -> time of last PARAM_SET.
+        std::size_t next = 0;                           // next position in results to send.
+        std::size_t completed = 0;
+        uint16_t window = PARAM_WRITE_WINDOW_DEFAULT;
+        uint64_t start_time = 0;
+        uint64_t duration = 0;                          // set when all results are final.
+        PARAM_WRITE_CALLBACK callback;
+    } T_PARAM_WRITE_BATCH;
+
     class CCallBack_Parameter
     {
         public:
@@ -61,19 +140,126 @@ namespace mavlinksdk
             void set_callback_parameter (mavlinksdk::CCallBack_Parameter* callback_parameter);
             void reloadParemeters ();
 
+            /**
+             * @brief called by FTP manager from any thread when param.pck cannot be loaded.
+             * PARAM_REQUEST_LIST is sent later by handle_heart_beat on parser thread.
+             *
+             */
+            void postFTPLoadFailed ()
+            {
+                m_ftp_load_failed = true;
+            }
+
+            /**
+             * @brief max number of outstanding PARAM_REQUEST_READ when filling missing parameters.
+             *
+             */
+            void setRequestWindow (const uint16_t window);
+
+            /**
+             * @brief resend timed-out index requests. Called for each received message while parameters are loading.
+             *
+             */
+            void checkParameterRequests ();
+
+            /**
+             * @brief cache parameters in folder. Cache is keyed by sysid & autopilot UID and
+             * validated on connect using param.pck CRC32 (ArduPilot) or _HASH_CHECK (PX4).
+             *
+             * @param folder empty string disables cache.
+             */
+            void enableCache (const std::string& folder);
+
+            /**
+             * @brief write parameters keeping up to window PARAM_SET outstanding.
+             * Each write is confirmed by the echoed PARAM_VALUE and resent on timeout or mismatch.
+             *
+             * @param parameters name & value pairs.
+             * @param callback called from parser thread, or from caller thread if batch finishes immediately.
+             * @return false if parameters are not loaded yet or another batch is active.
+             */
+            bool writeParameters (const std::vector<std::pair<std::string, float>>& parameters, PARAM_WRITE_CALLBACK callback, const uint16_t window = PARAM_WRITE_WINDOW_DEFAULT);
+
+            const bool isWritingParameters () const
+            {
+                const std::lock_guard<std::mutex> lock(m_write_lock);
+                return !m_write_batch.results.empty();
+            }
+
         public:
 
             void handle_heart_beat (const mavlink_heartbeat_t& heartbeat);
             void handle_param_value (const mavlink_param_value_t& param_message);
+            bool handle_param_pck (const std::vector<uint8_t>& param_pck);
+            void handle_autopilot_version (const mavlink_autopilot_version_t& autopilot_version);
 
 
         public:
 
-            const mavlink_param_value_t getParameterByName(const std::string param_name) const;
+            const mavlink_param_value_t getParameterByName(const std::string& param_name) const;
+
+            /**
+             * @brief allocation-free lookups. Return nullptr if not found.
+             *
+             * @param param_name up to 16 chars, null-terminated if shorter.
+             */
+            const mavlink_param_value_t* findParameter (const char* param_name) const;
+            const mavlink_param_value_t* findParameter (const uint16_t param_index) const;
+
+            bool getParameterValue (const char* param_name, float& value) const;
+            bool getParameterValue (const char* param_name, int32_t& value) const;
+
+            /**
+             * @brief true if integer parameters are carried as raw bytes in param_value (PX4)
+             * instead of being cast to float (ArduPilot).
+             *
+             */
+            bool isBytewiseEncoding () const;
+
+            /**
+             * @brief version at which parameter was stored or last changed. 0 if not found.
+             * Parameters with version greater than V changed after version V.
+             *
+             */
+            uint32_t getParameterVersion (const char* param_name) const;
+
+            /**
+             * @brief monotonically increasing. Incremented whenever a parameter is stored or changes value.
+             *
+             */
+            uint32_t getParametersVersion () const
+            {
+                return m_parameters_version;
+            }
+
+            /**
+             * @brief identifies current parameter store. Changes on restart and whenever store is cleared
+             * e.g. FCB parameters count changed. Versions are only comparable within the same epoch.
+             *
+             */
+            uint32_t getParametersEpoch () const
+            {
+                return m_parameters_epoch;
+            }
+
+            /**
+             * @brief parameters ordered by param_index. Check T_PARAMETER_SLOT::valid.
+             *
+             */
+            const std::vector<T_PARAMETER_SLOT>& getParametersList() const
+            {
+                return m_parameters;
+            }
+
+            static uint32_t hashParameterName (const char* param_name);
 
-            const std::map<std::string, mavlink_param_value_t>& getParametersList() const
+            /**
+             * @brief current RTO of index requests in usec.
+             *
+             */
+            uint64_t getRequestTimeout () const
             {
-                return m_parameters_list;
+                return m_request_timeout;
             }
 
             const bool isParametersListAvailable() const
@@ -85,12 +271,71 @@ namespace mavlinksdk
         protected:
 
             uint16_t getFirstMissingParameterByIndex();
+            void markParameterReceived (const uint16_t param_index, const uint16_t param_count);
+            void fillRequestWindow ();
+            void updateRequestTimeout (const uint64_t rtt);
+
+            void resizeStore (const uint16_t param_count);
+            void rebuildHashIndex ();
+            void insertHashIndex (const uint16_t param_index);
+            int32_t findIndex (const char* param_name) const;
+            bool storeParameter (const mavlink_param_value_t& param_message, const uint16_t param_index);
+
+            const std::string getCacheFileName () const;
+            bool loadCache ();
+            void saveCache () const;
+            void validateCache ();
+            void onCacheValid ();
+            void onCacheInvalid ();
+            void handle_hash_check (const mavlink_param_value_t& param_message);
+
+            void fillWriteWindow ();
+            void sendParameterSet (const uint16_t param_index, T_PARAM_WRITE_RESULT& write_result);
+            void handle_write_echo (const uint16_t param_index, const mavlink_param_value_t& param_message);
+            void checkWriteRequests (const uint64_t now);
+            void completeWrite (const uint16_t param_index, const ENUM_PARAM_WRITE_RESULT result);
+            void runWriteCallback ();
 
         protected:
             mavlinksdk::CCallBack_Parameter* m_callback_parameter;
 
-            std::map<std::string, mavlink_param_value_t> m_parameters_list;
-            std::vector<uint16_t> m_parameters_id;
+            /**
+             * @brief parameters indexed by param_index.
+             *
+             */
+            std::vector<T_PARAMETER_SLOT> m_parameters;
+
+            /**
+             * @brief open addressing hash of parameter names. Each bucket is param_index + 1, 0 if empty.
+             * Size is a power of 2 at least twice number of parameters.
+             *
+             */
+            std::vector<uint16_t> m_parameters_hash;
+            uint32_t m_parameters_version = 0;
+            uint32_t m_parameters_epoch = 0;
+
+            /**
+             * @brief bit per parameter index. true if received.
+             *
+             */
+            std::vector<bool> m_parameters_received;
+            uint16_t m_parameters_received_count = 0;
+
+            /**
+             * @brief outstanding index requests. Size never exceeds m_request_window.
+             *
+             */
+            std::map<uint16_t, T_PARAM_REQUEST> m_parameter_requests;
+            uint16_t m_request_window = PARAM_REQUEST_WINDOW_DEFAULT;
+            uint16_t m_next_missing_index = 0;
+
+            /**
+             * @brief smoothed RTT & variance of index requests used to compute m_request_timeout as in RFC 6298.
+             *
+             */
+            uint64_t m_srtt = 0;
+            uint64_t m_rttvar = 0;
+            uint64_t m_request_timeout = PARAM_REQUEST_RTO_INIT;
             
             /**
              * @brief Status of the state machine
@@ -103,6 +348,37 @@ namespace mavlinksdk
             uint64_t m_parameters_last_receive_time = 0;
 
             bool m_load_parameters_1st_iteration = true;
+
+            /**
+             * @brief Parameter cache
+             *
+             */
+            std::string m_cache_folder;
+            std::string m_autopilot_uid;
+            uint8_t m_autopilot_version_requests = 0;
+            std::vector<mavlink_param_value_t> m_cache_parameters;
+            uint32_t m_cache_pck_crc = 0;
+            uint32_t m_cache_hash_check = 0;
+            std::atomic<bool> m_cache_crc_failed{false};
+            uint64_t m_cache_check_time = 0;
+
+            /**
+             * @brief identity of current parameter set as reported by autopilot. 0 if unknown.
+             *
+             */
+            uint32_t m_param_pck_crc = 0;
+            uint32_t m_hash_check = 0;
+
+            /**
+             * @brief batch written by writeParameters() from caller thread and confirmed by parser thread.
+             * Finished batches are moved to m_write_batches_finished and their callbacks run outside m_write_lock.
+             *
+             */
+            T_PARAM_WRITE_BATCH m_write_batch;
+            std::vector<T_PARAM_WRITE_BATCH> m_write_batches_finished;
+            mutable std::mutex m_write_lock;
+
+            std::atomic<bool> m_ftp_load_failed{false};
     };
         
     
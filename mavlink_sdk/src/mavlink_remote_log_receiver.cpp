@@ -0,0 +1,345 @@
+#include <iostream>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+#include "./helpers/colors.h"
+#include "./helpers/utils.h"
+#include "mavlink_sdk.h"
+#include "vehicle.h"
+#include "mavlink_remote_log_receiver.h"
+
+
+using namespace mavlinksdk;
+
+#define GCS_SYSID 255
+
+
+mavlinksdk::CMavlinkRemoteLogReceiver::~CMavlinkRemoteLogReceiver ()
+{
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+		m_exit_thread = true;
+	}
+	m_condition.notify_all();
+
+	if (m_worker_thread.joinable())
+	{
+		m_worker_thread.join();
+	}
+
+	closeFile();
+}
+
+
+bool mavlinksdk::CMavlinkRemoteLogReceiver::start (const std::string& folder)
+{
+	const std::lock_guard<std::mutex> lock(m_lock);
+
+	if (m_active) return true;
+
+	m_folder = folder;
+	if (!openFile()) return false;
+
+	m_active = true;
+	m_last_block_time = 0;
+	m_last_start_time = 0;
+	m_start_sent = false;
+	m_stats = T_REMOTE_LOG_STATS();
+
+	if (!m_worker_thread.joinable())
+	{
+		m_worker_thread = std::thread{[&](){ loopWorker(); }};
+	}
+
+	// START is sent by worker thread.
+	m_condition.notify_all();
+
+	return true;
+}
+
+
+void mavlinksdk::CMavlinkRemoteLogReceiver::stop ()
+{
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+
+		if (!m_active) return ;
+
+		m_active = false;
+		m_acks.clear();
+		m_stats.blocks_lost += m_missing.size();
+		m_missing.clear();
+		closeFile();
+	}
+
+	sendBlockStatus(MAV_REMOTE_LOG_DATA_BLOCK_STOP, MAV_REMOTE_LOG_DATA_BLOCK_ACK);
+}
+
+
+/**
+ * @brief Caller should hold m_lock.
+ *
+ */
+bool mavlinksdk::CMavlinkRemoteLogReceiver::openFile ()
+{
+	char name[64];
+	const time_t now = time(nullptr);
+	struct tm now_tm;
+	localtime_r(&now, &now_tm);
+	strftime(name, sizeof(name), "remote_log_%Y%m%d_%H%M%S.bin", &now_tm);
+
+	m_file_path = m_folder;
+	if (!m_file_path.empty() && m_file_path.back() != '/') m_file_path += "/";
+	m_file_path += name;
+
+	m_fd = open(m_file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (m_fd < 0)
+	{
+		std::cout << _ERROR_CONSOLE_TEXT_ << "Cannot create remote log file: " << m_file_path << _NORMAL_CONSOLE_TEXT_ << std::endl;
+		return false;
+	}
+
+	m_allocated_size = 0;
+	m_first_block = true;
+	m_highest_seqno = 0;
+	m_received.clear();
+
+	std::cout << _LOG_CONSOLE_BOLD_TEXT << "Remote log file: " << _INFO_CONSOLE_TEXT << m_file_path << _NORMAL_CONSOLE_TEXT_ << std::endl;
+
+	return true;
+}
+
+
+/**
+ * @brief trim preallocated space to received data and close file.
+ * Caller should hold m_lock.
+ *
+ */
+void mavlinksdk::CMavlinkRemoteLogReceiver::closeFile ()
+{
+	if (m_fd < 0) return ;
+
+	const off_t length = m_first_block ? 0 : (off_t)(m_highest_seqno + 1) * REMOTE_LOG_BLOCK_LENGTH;
+	if (ftruncate(m_fd, length) != 0)
+	{
+		std::cout << _ERROR_CONSOLE_TEXT_ << "Cannot trim remote log file: " << m_file_path << _NORMAL_CONSOLE_TEXT_ << std::endl;
+	}
+
+	close(m_fd);
+	m_fd = -1;
+}
+
+
+/**
+ * @brief write block at its position. File space is allocated in large extents
+ * so that out of order blocks do not fragment file.
+ * Caller should hold m_lock.
+ *
+ */
+void mavlinksdk::CMavlinkRemoteLogReceiver::writeBlock (const uint32_t seqno, const uint8_t* data)
+{
+	if (m_fd < 0) return ;
+
+	const uint64_t offset = (uint64_t)seqno * REMOTE_LOG_BLOCK_LENGTH;
+
+	if (offset + REMOTE_LOG_BLOCK_LENGTH > m_allocated_size)
+	{
+		const uint64_t size = ((offset + REMOTE_LOG_BLOCK_LENGTH) / REMOTE_LOG_PREALLOCATE_SIZE + 1) * REMOTE_LOG_PREALLOCATE_SIZE;
+		if (posix_fallocate(m_fd, (off_t)m_allocated_size, (off_t)(size - m_allocated_size)) == 0)
+		{
+			m_allocated_size = size;
+		}
+	}
+
+	if (pwrite(m_fd, data, REMOTE_LOG_BLOCK_LENGTH, (off_t)offset) != REMOTE_LOG_BLOCK_LENGTH)
+	{
+		std::cout << _ERROR_CONSOLE_TEXT_ << "Cannot write remote log file: " << m_file_path << _NORMAL_CONSOLE_TEXT_ << std::endl;
+	}
+}
+
+
+void mavlinksdk::CMavlinkRemoteLogReceiver::sendBlockStatus (const uint32_t seqno, const uint8_t status) const
+{
+	const mavlinksdk::CVehicle &vehicle =  mavlinksdk::CVehicle::getInstance();
+
+	mavlink_remote_log_block_status_t remote_log_block_status;
+	remote_log_block_status.target_system = vehicle.getSysId();
+	remote_log_block_status.target_component = vehicle.getCompId();
+	remote_log_block_status.seqno = seqno;
+	remote_log_block_status.status = status;
+
+	mavlink_message_t mavlink_message;
+	mavlink_msg_remote_log_block_status_encode(GCS_SYSID, 190, &mavlink_message, &remote_log_block_status);
+
+	mavlinksdk::CMavlinkSDK::getInstance().sendMavlinkMessage(mavlink_message);
+}
+
+
+void mavlinksdk::CMavlinkRemoteLogReceiver::handle_remote_log_data_block (const mavlink_remote_log_data_block_t& remote_log_data_block)
+{
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+
+		if (!m_active) return ;
+
+		const uint32_t seqno = remote_log_data_block.seqno;
+		const uint64_t now = get_time_usec();
+		const bool restarted = m_start_sent || (now - m_last_block_time >= REMOTE_LOG_START_INTERVAL);
+		m_last_block_time = now;
+		m_start_sent = false;
+
+		if ((seqno == 0) && (!m_first_block) && (m_highest_seqno > 0) && restarted)
+		{
+			// autopilot started a new log. Otherwise block 0 is a resent or missing block.
+			m_stats.blocks_lost += m_missing.size();
+			m_missing.clear();
+			closeFile();
+			if (!openFile())
+			{
+				m_active = false;
+				return ;
+			}
+		}
+
+		// ACK duplicates as well as previous ACK may have been lost.
+		m_acks.push_back(seqno);
+
+		if (m_first_block || (seqno > m_highest_seqno))
+		{
+			// blocks between last highest and this one are missing.
+			const uint32_t first_missing = m_first_block ? 0 : m_highest_seqno + 1;
+			for (uint32_t i = first_missing; i < seqno; ++i)
+			{
+				if (m_missing.size() >= REMOTE_LOG_MAX_MISSING)
+				{
+					m_stats.blocks_lost += seqno - i;
+					break;
+				}
+				m_missing[i] = std::make_pair((uint64_t)0, (uint8_t)0);
+			}
+
+			m_first_block = false;
+			m_highest_seqno = seqno;
+			m_received.resize((size_t)seqno + 1, false);
+			m_received[seqno] = true;
+			writeBlock(seqno, remote_log_data_block.data);
+			m_stats.blocks_received++;
+		}
+		else if (!m_received[seqno])
+		{
+			auto missing = m_missing.find(seqno);
+			if (missing != m_missing.end())
+			{
+				m_missing.erase(missing);
+			}
+			else if (m_stats.blocks_lost > 0)
+			{
+				// block was given up as lost.
+				m_stats.blocks_lost--;
+			}
+			m_received[seqno] = true;
+			writeBlock(seqno, remote_log_data_block.data);
+			m_stats.blocks_received++;
+			m_stats.blocks_recovered++;
+		}
+		else
+		{
+			m_stats.blocks_duplicated++;
+		}
+	}
+
+	m_condition.notify_all();
+}
+
+
+/**
+ * @brief sends queued ACKs once available and each 100 msec sends START if no data is received
+ * and NACKs for missing blocks.
+ *
+ */
+void mavlinksdk::CMavlinkRemoteLogReceiver::loopWorker ()
+{
+	std::vector<uint32_t> acks;
+	std::vector<uint32_t> nacks;
+	uint64_t last_tick = 0;
+
+	while (true)
+	{
+		bool send_start = false;
+
+		{
+			std::unique_lock<std::mutex> lock(m_lock);
+
+			m_condition.wait_for(lock, std::chrono::milliseconds(100), [&](){ return m_exit_thread || !m_acks.empty(); });
+
+			if (m_exit_thread) return ;
+
+			acks.swap(m_acks);
+
+			const uint64_t now = get_time_usec();
+			if (m_active && (now - last_tick >= 100000))
+			{
+				last_tick = now;
+
+				if ((now - m_last_block_time > REMOTE_LOG_START_INTERVAL)
+					&& (now - m_last_start_time > REMOTE_LOG_START_INTERVAL)
+					&& (mavlinksdk::CVehicle::getInstance().getSysId() != 0))
+				{
+					m_last_start_time = now;
+					m_start_sent = true;
+					send_start = true;
+				}
+
+				auto it = m_missing.begin();
+				while ((it != m_missing.end()) && (nacks.size() < REMOTE_LOG_NACK_BATCH))
+				{
+					if (now - it->second.first < REMOTE_LOG_NACK_INTERVAL)
+					{
+						++it;
+						continue;
+					}
+
+					if (it->second.second >= REMOTE_LOG_MAX_NACKS)
+					{
+						m_stats.blocks_lost++;
+						it = m_missing.erase(it);
+						continue;
+					}
+
+					it->second.first = now;
+					it->second.second++;
+					nacks.push_back(it->first);
+					++it;
+				}
+
+				m_stats.nacks_sent += nacks.size();
+			}
+		}
+
+		// send outside lock so that parser thread is not blocked by link.
+		if (send_start)
+		{
+			#ifdef DEBUG
+				std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: REMOTE_LOG START" << _NORMAL_CONSOLE_TEXT_ << std::endl;
+			#endif
+
+			sendBlockStatus(MAV_REMOTE_LOG_DATA_BLOCK_START, MAV_REMOTE_LOG_DATA_BLOCK_ACK);
+		}
+
+		for (const uint32_t seqno : acks)
+		{
+			sendBlockStatus(seqno, MAV_REMOTE_LOG_DATA_BLOCK_ACK);
+		}
+
+		for (const uint32_t seqno : nacks)
+		{
+			sendBlockStatus(seqno, MAV_REMOTE_LOG_DATA_BLOCK_NACK);
+		}
+
+		acks.clear();
+		nacks.clear();
+	}
+}
@@ -0,0 +1,143 @@
+#ifndef MAVLINK_REMOTE_LOG_RECEIVER_H_
+#define MAVLINK_REMOTE_LOG_RECEIVER_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <all/mavlink.h>
+
+namespace mavlinksdk
+{
+
+#define REMOTE_LOG_BLOCK_LENGTH             MAVLINK_MSG_REMOTE_LOG_DATA_BLOCK_FIELD_DATA_LEN
+#define REMOTE_LOG_START_INTERVAL           1000000     // usec without blocks before START is resent.
+#define REMOTE_LOG_NACK_INTERVAL            300000      // usec between NACKs of the same block.
+#define REMOTE_LOG_NACK_BATCH               32          // max NACKs sent each tick.
+#define REMOTE_LOG_MAX_NACKS                10          // block is considered lost after this number of NACKs.
+#define REMOTE_LOG_MAX_MISSING              4096        // max tracked missing blocks.
+#define REMOTE_LOG_PREALLOCATE_SIZE         (8 * 1024 * 1024)
+
+
+typedef struct T_REMOTE_LOG_STATS {
+        uint32_t blocks_received = 0;
+        uint32_t blocks_duplicated = 0;
+        uint32_t blocks_recovered = 0;      // received after NACK.
+        uint32_t blocks_lost = 0;
+        uint32_t nacks_sent = 0;
+    } T_REMOTE_LOG_STATS;
+
+
+/**
+ * @brief Receives dataflash log streamed by ArduPilot as REMOTE_LOG_DATA_BLOCK.
+ * @details Each block is ACKed and written at seqno * block length into a preallocated file,
+ * so blocks can arrive in any order. Missing sequence numbers are NACKed in batches till received or
+ * considered lost. ACKs & NACKs are sent from a worker thread so parsing thread never waits for the link.
+ * @see https://ardupilot.org/dev/docs/mavlink-based-dataflash-logging.html
+ *
+ */
+class CMavlinkRemoteLogReceiver
+{
+    public:
+            //https://stackoverflow.com/questions/1008019/c-singleton-design-pattern
+            static CMavlinkRemoteLogReceiver& getInstance()
+            {
+                static CMavlinkRemoteLogReceiver instance;
+                return instance;
+            }
+
+            CMavlinkRemoteLogReceiver(CMavlinkRemoteLogReceiver const&)     = delete;
+            void operator=(CMavlinkRemoteLogReceiver const&)                = delete;
+
+
+            // Note: Scott Meyers mentions in his Effective Modern
+            //       C++ book, that deleted functions should generally
+            //       be public as it results in better error messages
+            //       due to the compilers behavior to check accessibility
+            //       before deleted status
+
+        private:
+
+            CMavlinkRemoteLogReceiver() {};
+
+        public:
+
+            ~CMavlinkRemoteLogReceiver ();
+
+        public:
+
+            /**
+             * @brief create a new log file in folder and ask autopilot to stream log blocks.
+             *
+             */
+            bool start (const std::string& folder);
+            void stop ();
+
+            const bool isActive () const
+            {
+                return m_active;
+            }
+
+            const T_REMOTE_LOG_STATS getStats () const
+            {
+                const std::lock_guard<std::mutex> lock(m_lock);
+                return m_stats;
+            }
+
+        public:
+
+            void handle_remote_log_data_block (const mavlink_remote_log_data_block_t& remote_log_data_block);
+
+        protected:
+
+            bool openFile ();
+            void closeFile ();
+            void writeBlock (const uint32_t seqno, const uint8_t* data);
+            void sendBlockStatus (const uint32_t seqno, const uint8_t status) const;
+            void loopWorker ();
+
+        protected:
+
+            std::string m_folder;
+            std::string m_file_path;
+            int m_fd = -1;
+            uint64_t m_allocated_size = 0;
+
+            bool m_active = false;
+            bool m_first_block = true;
+            uint32_t m_highest_seqno = 0;
+            uint64_t m_last_block_time = 0;
+            uint64_t m_last_start_time = 0;
+            bool m_start_sent = false;                  // START sent and no block received since.
+
+            /**
+             * @brief seqno -> block written. Blocks given up as lost are still written if they arrive later.
+             *
+             */
+            std::vector<bool> m_received;
+
+            /**
+             * @brief blocks waiting to be ACKed.
+             *
+             */
+            std::vector<uint32_t> m_acks;
+
+            /**
+             * @brief missing seqno -> (time of last NACK, number of NACKs).
+             *
+             */
+            std::map<uint32_t, std::pair<uint64_t, uint8_t>> m_missing;
+
+            T_REMOTE_LOG_STATS m_stats;
+
+            mutable std::mutex m_lock;
+            std::condition_variable m_condition;
+            std::thread m_worker_thread;
+            bool m_exit_thread = false;
+};
+
+}
+
+#endif
@@ -45,6 +45,11 @@ void CMavlinkSDK::connectTCP(const char *target_ip, const int tcp_port)
     this->m_port = std::shared_ptr<mavlinksdk::comm::GenericPort>(new mavlinksdk::comm::TCPClientPort(target_ip, tcp_port));
 }
 
+void CMavlinkSDK::connectPort(std::shared_ptr<mavlinksdk::comm::GenericPort> port)
+{
+    this->m_port = port;
+}
+
 void CMavlinkSDK::stop()
 {
     if (this->m_port.get() != nullptr)
@@ -38,6 +38,10 @@ namespace mavlinksdk
         void connectUDP(const char *target_ip, const int udp_port);
         void connectSerial(const char *uart_name, const int baudrate, const bool dynamic);
         void connectTCP(const char *target_ip, const int tcp_port);
+        /**
+         * @brief use a custom port. e.g. a simulated FCB in tests.
+         */
+        void connectPort(std::shared_ptr<mavlinksdk::comm::GenericPort> port);
         void stop();
 
     public:
@@ -90,6 +94,17 @@ namespace mavlinksdk
             m_mavlink_events->OnWayPointsLoadingCompleted();
         }
 
+        inline void OnWayPointsLoadingProgress(const uint16_t &received, const uint16_t &count) override
+        {
+            m_mavlink_events->OnWayPointsLoadingProgress(received, count);
+        }
+
+        inline void OnWayPointsLoadingFailed() override
+        {
+            std::cout << _ERROR_CONSOLE_TEXT_ << "OnWayPointsLoadingFailed" << _NORMAL_CONSOLE_TEXT_ << std::endl;
+            m_mavlink_events->OnWayPointsLoadingFailed();
+        }
+
         inline void OnBoardRestarted() override
         {
             m_mavlink_events->OnBoardRestarted();
@@ -0,0 +1,158 @@
+#include <iostream>
+
+#include "./helpers/colors.h"
+#include "mavlink_command.h"
+#include "mavlink_setpoint_channel.h"
+
+
+using namespace mavlinksdk;
+
+
+mavlinksdk::CMavlinkSetpointChannel::~CMavlinkSetpointChannel ()
+{
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+		m_exit_thread = true;
+	}
+
+	m_condition.notify_all();
+
+	if (m_send_thread.joinable())
+	{
+		m_send_thread.join();
+	}
+}
+
+
+/**
+ * @brief store setpoint in its slot replacing any unsent setpoint of the same kind.
+ *
+ * @param kind
+ * @param send function that encodes and sends the setpoint.
+ */
+void mavlinksdk::CMavlinkSetpointChannel::post (const ENUM_SETPOINT_KIND& kind, std::function<void ()> send)
+{
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+
+		T_SETPOINT_SLOT& slot = m_slots[kind];
+		if (slot.pending)
+		{
+			slot.superseded_count++;
+		}
+
+		slot.pending = true;
+		slot.send = std::move(send);
+
+		if (!m_send_thread_started)
+		{
+			m_send_thread_started = true;
+			m_send_thread = std::thread{[&](){ loopSend(); }};
+		}
+	}
+
+	m_condition.notify_one();
+}
+
+
+/**
+ * @brief takes pending setpoints and sends them. Sending blocks as long as the link is busy
+ * and meanwhile newer setpoints replace pending ones.
+ *
+ */
+void mavlinksdk::CMavlinkSetpointChannel::loopSend ()
+{
+	std::function<void ()> to_send[SETPOINT_COUNT];
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_lock);
+
+			m_condition.wait(lock, [&]()
+			{
+				if (m_exit_thread) return true;
+				for (int i=0; i<SETPOINT_COUNT; ++i)
+				{
+					if (m_slots[i].pending) return true;
+				}
+				return false;
+			});
+
+			if (m_exit_thread) return ;
+
+			for (int i=0; i<SETPOINT_COUNT; ++i)
+			{
+				T_SETPOINT_SLOT& slot = m_slots[i];
+				if (!slot.pending) continue;
+
+				slot.pending = false;
+				slot.sent_count++;
+				to_send[i] = std::move(slot.send);
+				slot.send = nullptr;
+			}
+		}
+
+		for (int i=0; i<SETPOINT_COUNT; ++i)
+		{
+			if (!to_send[i]) continue;
+
+			to_send[i]();
+			to_send[i] = nullptr;
+		}
+	}
+}
+
+
+void mavlinksdk::CMavlinkSetpointChannel::gotoGuidedPoint (const double& latitude, const double& longitude, const double& relative_altitude)
+{
+	post (SETPOINT_POSITION, [=]()
+	{
+		mavlinksdk::CMavlinkCommand::getInstance().gotoGuidedPoint(latitude, longitude, relative_altitude);
+	});
+}
+
+
+void mavlinksdk::CMavlinkSetpointChannel::ctrlGuidedVelocityInLocalFrame (const float vx, const float vy, const float vz, const float yaw_rate, MAV_FRAME mav_frame)
+{
+	post (SETPOINT_VELOCITY, [=]()
+	{
+		mavlinksdk::CMavlinkCommand::getInstance().ctrlGuidedVelocityInLocalFrame(vx, vy, vz, yaw_rate, mav_frame);
+	});
+}
+
+
+void mavlinksdk::CMavlinkSetpointChannel::setYawCondition (const double& target_angle, const double& turn_rate, const bool& is_clock_wise, const bool& is_relative)
+{
+	post (SETPOINT_YAW, [=]()
+	{
+		mavlinksdk::CMavlinkCommand::getInstance().setYawCondition(target_angle, turn_rate, is_clock_wise, is_relative);
+	});
+}
+
+
+void mavlinksdk::CMavlinkSetpointChannel::setROI (const float& latitude, const float& longitude, const float& altitude)
+{
+	post (SETPOINT_ROI, [=]()
+	{
+		mavlinksdk::CMavlinkCommand::getInstance().setROI(latitude, longitude, altitude);
+	});
+}
+
+
+void mavlinksdk::CMavlinkSetpointChannel::resetROI ()
+{
+	post (SETPOINT_ROI, []()
+	{
+		mavlinksdk::CMavlinkCommand::getInstance().resetROI();
+	});
+}
+
+
+void mavlinksdk::CMavlinkSetpointChannel::setNavigationSpeed (const int& speed_type, const double& speed, const double& throttle, const bool& is_relative)
+{
+	post (SETPOINT_SPEED, [=]()
+	{
+		mavlinksdk::CMavlinkCommand::getInstance().setNavigationSpeed(speed_type, speed, throttle, is_relative);
+	});
+}
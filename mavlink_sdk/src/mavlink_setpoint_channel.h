@@ -0,0 +1,110 @@
+#ifndef MAVLINK_SETPOINT_CHANNEL_H_
+#define MAVLINK_SETPOINT_CHANNEL_H_
+
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+#include <all/mavlink.h>
+
+namespace mavlinksdk
+{
+
+typedef enum {
+        SETPOINT_POSITION       = 0,    // gotoGuidedPoint
+        SETPOINT_VELOCITY       = 1,    // ctrlGuidedVelocityInLocalFrame
+        SETPOINT_YAW            = 2,    // setYawCondition
+        SETPOINT_ROI            = 3,    // setROI & resetROI
+        SETPOINT_SPEED          = 4,    // setNavigationSpeed
+        SETPOINT_COUNT          = 5
+    } ENUM_SETPOINT_KIND;
+
+
+typedef struct T_SETPOINT_SLOT {
+        bool pending = false;
+        std::function<void ()> send;
+        uint32_t sent_count = 0;
+        uint32_t superseded_count = 0;  // setpoints replaced by newer ones before being sent.
+    } T_SETPOINT_SLOT;
+
+
+/**
+ * @brief Latest-value channels for guidance setpoints.
+ * @details Each setpoint kind has a single slot. A new setpoint replaces an unsent older one of the same kind,
+ * so when the FCB link is busy -i.e. write is blocked by parameter or mission traffic- stale targets are dropped
+ * and the FCB receives the freshest one once the link is free.
+ * Setpoints are sent from a dedicated thread so callers never block on the link.
+ *
+ */
+class CMavlinkSetpointChannel
+{
+    public:
+        //https://stackoverflow.com/questions/1008019/c-singleton-design-pattern
+        static CMavlinkSetpointChannel& getInstance()
+        {
+            static CMavlinkSetpointChannel instance;
+
+            return instance;
+        };
+
+        CMavlinkSetpointChannel(CMavlinkSetpointChannel const&)       = delete;
+        void operator=(CMavlinkSetpointChannel const&)                = delete;
+
+
+        // Note: Scott Meyers mentions in his Effective Modern
+        //       C++ book, that deleted functions should generally
+        //       be public as it results in better error messages
+        //       due to the compilers behavior to check accessibility
+        //       before deleted status
+
+    private:
+
+        CMavlinkSetpointChannel()
+        {
+        };
+
+    public:
+
+        ~CMavlinkSetpointChannel ();
+
+    public:
+
+        void gotoGuidedPoint (const double& latitude, const double& longitude, const double& relative_altitude);
+        void ctrlGuidedVelocityInLocalFrame (const float vx, const float vy, const float vz, const float yaw_rate, MAV_FRAME mav_frame);
+        void setYawCondition (const double& target_angle, const double& turn_rate, const bool& is_clock_wise, const bool& is_relative);
+        void setROI (const float& latitude, const float& longitude, const float& altitude);
+        void resetROI ();
+        void setNavigationSpeed (const int& speed_type, const double& speed, const double& throttle, const bool& is_relative);
+
+        const uint32_t getSupersededCount (const ENUM_SETPOINT_KIND& kind) const
+        {
+            const std::lock_guard<std::mutex> lock(m_lock);
+            return m_slots[kind].superseded_count;
+        }
+
+        const uint32_t getSentCount (const ENUM_SETPOINT_KIND& kind) const
+        {
+            const std::lock_guard<std::mutex> lock(m_lock);
+            return m_slots[kind].sent_count;
+        }
+
+    protected:
+
+        void post (const ENUM_SETPOINT_KIND& kind, std::function<void ()> send);
+        void loopSend ();
+
+    protected:
+
+        T_SETPOINT_SLOT m_slots[SETPOINT_COUNT];
+        mutable std::mutex m_lock;
+        std::condition_variable m_condition;
+
+        std::thread m_send_thread;
+        bool m_send_thread_started = false;
+        bool m_exit_thread = false;
+};
+
+}
+
+#endif
@@ -0,0 +1,292 @@
+#include <iostream>
+#include <chrono>
+
+#include "./helpers/colors.h"
+#include "./helpers/utils.h"
+#include "mavlink_sdk.h"
+#include "vehicle.h"
+#include "mavlink_setpoint_streamer.h"
+
+
+using namespace mavlinksdk;
+
+#define GCS_SYSID 255
+
+
+/**
+ * @brief start streaming thread.
+ *
+ * @param rate_hz clamped to [SETPOINT_STREAM_MIN_RATE, SETPOINT_STREAM_MAX_RATE]
+ * @param producer_timeout_us switch to hold if target is not updated within this time.
+ */
+void mavlinksdk::CMavlinkSetpointStreamer::start (const uint32_t rate_hz, const uint64_t producer_timeout_us)
+{
+	if (m_streaming) return ;
+
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+
+		m_rate_hz = rate_hz;
+		if (m_rate_hz < SETPOINT_STREAM_MIN_RATE) m_rate_hz = SETPOINT_STREAM_MIN_RATE;
+		if (m_rate_hz > SETPOINT_STREAM_MAX_RATE) m_rate_hz = SETPOINT_STREAM_MAX_RATE;
+
+		m_producer_timeout_us = producer_timeout_us;
+		m_stream_start_time = get_time_usec();
+		m_last_producer_update = m_stream_start_time;
+		m_holding = false;
+		m_dirty = true;
+	}
+
+	m_streaming = true;
+	m_stream_thread = std::thread{[&](){ loopStream(); }};
+}
+
+
+void mavlinksdk::CMavlinkSetpointStreamer::stop ()
+{
+	if (!m_streaming) return ;
+
+	m_streaming = false;
+
+	if (m_stream_thread.joinable())
+	{
+		m_stream_thread.join();
+	}
+}
+
+
+void mavlinksdk::CMavlinkSetpointStreamer::clearTarget ()
+{
+	const std::lock_guard<std::mutex> lock(m_lock);
+
+	m_target_local = {0};
+	m_target_global = {0};
+	m_target_local.type_mask = SETPOINT_STREAM_TYPEMASK_IGNORE_ALL;
+	m_target_global.type_mask = SETPOINT_STREAM_TYPEMASK_IGNORE_ALL;
+	m_target_local.coordinate_frame = MAV_FRAME_LOCAL_NED;
+	m_target_global.coordinate_frame = MAV_FRAME_GLOBAL_RELATIVE_ALT_INT;
+	m_is_global = false;
+	m_dirty = true;
+}
+
+
+/**
+ * @brief called by setters while holding m_lock.
+ *
+ */
+void mavlinksdk::CMavlinkSetpointStreamer::targetUpdated ()
+{
+	m_last_producer_update = get_time_usec();
+	m_holding = false;
+	m_dirty = true;
+}
+
+
+void mavlinksdk::CMavlinkSetpointStreamer::setPositionLocal (const float x, const float y, const float z, const MAV_FRAME mav_frame)
+{
+	const std::lock_guard<std::mutex> lock(m_lock);
+
+	m_is_global = false;
+	m_target_local.coordinate_frame = mav_frame;
+	m_target_local.x = x;
+	m_target_local.y = y;
+	m_target_local.z = z;
+	m_target_local.type_mask &= ~(POSITION_TARGET_TYPEMASK_X_IGNORE | POSITION_TARGET_TYPEMASK_Y_IGNORE | POSITION_TARGET_TYPEMASK_Z_IGNORE);
+
+	targetUpdated();
+}
+
+
+void mavlinksdk::CMavlinkSetpointStreamer::setPositionGlobal (const double& latitude, const double& longitude, const float relative_altitude)
+{
+	const std::lock_guard<std::mutex> lock(m_lock);
+
+	m_is_global = true;
+	m_target_global.lat_int = (int32_t)(latitude * 10000000.0);
+	m_target_global.lon_int = (int32_t)(longitude * 10000000.0);
+	m_target_global.alt = relative_altitude;
+	m_target_global.type_mask &= ~(POSITION_TARGET_TYPEMASK_X_IGNORE | POSITION_TARGET_TYPEMASK_Y_IGNORE | POSITION_TARGET_TYPEMASK_Z_IGNORE);
+
+	targetUpdated();
+}
+
+
+/**
+ * @brief velocity in m/s. In global frame it is NED.
+ *
+ * @param mav_frame frame of local target. e.g. MAV_FRAME_BODY_OFFSET_NED for joystick control.
+ */
+void mavlinksdk::CMavlinkSetpointStreamer::setVelocity (const float vx, const float vy, const float vz, const MAV_FRAME mav_frame)
+{
+	const std::lock_guard<std::mutex> lock(m_lock);
+
+	m_target_local.coordinate_frame = mav_frame;
+
+	m_target_local.vx = m_target_global.vx = vx;
+	m_target_local.vy = m_target_global.vy = vy;
+	m_target_local.vz = m_target_global.vz = vz;
+	m_target_local.type_mask &= ~(POSITION_TARGET_TYPEMASK_VX_IGNORE | POSITION_TARGET_TYPEMASK_VY_IGNORE | POSITION_TARGET_TYPEMASK_VZ_IGNORE);
+	m_target_global.type_mask &= ~(POSITION_TARGET_TYPEMASK_VX_IGNORE | POSITION_TARGET_TYPEMASK_VY_IGNORE | POSITION_TARGET_TYPEMASK_VZ_IGNORE);
+
+	targetUpdated();
+}
+
+
+void mavlinksdk::CMavlinkSetpointStreamer::setAcceleration (const float afx, const float afy, const float afz)
+{
+	const std::lock_guard<std::mutex> lock(m_lock);
+
+	m_target_local.afx = m_target_global.afx = afx;
+	m_target_local.afy = m_target_global.afy = afy;
+	m_target_local.afz = m_target_global.afz = afz;
+	m_target_local.type_mask &= ~(POSITION_TARGET_TYPEMASK_AX_IGNORE | POSITION_TARGET_TYPEMASK_AY_IGNORE | POSITION_TARGET_TYPEMASK_AZ_IGNORE);
+	m_target_global.type_mask &= ~(POSITION_TARGET_TYPEMASK_AX_IGNORE | POSITION_TARGET_TYPEMASK_AY_IGNORE | POSITION_TARGET_TYPEMASK_AZ_IGNORE);
+
+	targetUpdated();
+}
+
+
+/**
+ * @brief yaw in radians.
+ *
+ */
+void mavlinksdk::CMavlinkSetpointStreamer::setYaw (const float yaw)
+{
+	const std::lock_guard<std::mutex> lock(m_lock);
+
+	m_target_local.yaw = m_target_global.yaw = yaw;
+	m_target_local.type_mask &= ~POSITION_TARGET_TYPEMASK_YAW_IGNORE;
+	m_target_global.type_mask &= ~POSITION_TARGET_TYPEMASK_YAW_IGNORE;
+	// yaw & yaw rate are exclusive.
+	m_target_local.type_mask |= POSITION_TARGET_TYPEMASK_YAW_RATE_IGNORE;
+	m_target_global.type_mask |= POSITION_TARGET_TYPEMASK_YAW_RATE_IGNORE;
+
+	targetUpdated();
+}
+
+
+/**
+ * @brief yaw rate in rad/s.
+ *
+ */
+void mavlinksdk::CMavlinkSetpointStreamer::setYawRate (const float yaw_rate)
+{
+	const std::lock_guard<std::mutex> lock(m_lock);
+
+	m_target_local.yaw_rate = m_target_global.yaw_rate = yaw_rate;
+	m_target_local.type_mask &= ~POSITION_TARGET_TYPEMASK_YAW_RATE_IGNORE;
+	m_target_global.type_mask &= ~POSITION_TARGET_TYPEMASK_YAW_RATE_IGNORE;
+	// yaw & yaw rate are exclusive.
+	m_target_local.type_mask |= POSITION_TARGET_TYPEMASK_YAW_IGNORE;
+	m_target_global.type_mask |= POSITION_TARGET_TYPEMASK_YAW_IGNORE;
+
+	targetUpdated();
+}
+
+
+/**
+ * @brief encode active target into m_message. Caller should hold m_lock.
+ *
+ */
+void mavlinksdk::CMavlinkSetpointStreamer::encodeTemplate ()
+{
+	const mavlinksdk::CVehicle &vehicle = mavlinksdk::CVehicle::getInstance();
+
+	if (m_is_global)
+	{
+		m_target_global.target_system = vehicle.getSysId();
+		m_target_global.target_component = vehicle.getCompId();
+		mavlink_msg_set_position_target_global_int_encode(GCS_SYSID, 190, &m_message, &m_target_global);
+	}
+	else
+	{
+		m_target_local.target_system = vehicle.getSysId();
+		m_target_local.target_component = vehicle.getCompId();
+		mavlink_msg_set_position_target_local_ned_encode(GCS_SYSID, 190, &m_message, &m_target_local);
+	}
+
+	m_dirty = false;
+}
+
+
+/**
+ * @brief encode zero velocity setpoint into m_message. Caller should hold m_lock.
+ *
+ */
+void mavlinksdk::CMavlinkSetpointStreamer::encodeHold ()
+{
+	const mavlinksdk::CVehicle &vehicle = mavlinksdk::CVehicle::getInstance();
+
+	mavlink_set_position_target_local_ned_t hold = {0};
+	hold.target_system = vehicle.getSysId();
+	hold.target_component = vehicle.getCompId();
+	hold.coordinate_frame = MAV_FRAME_LOCAL_NED;
+	hold.type_mask = SETPOINT_STREAM_TYPEMASK_IGNORE_ALL
+		& ~(POSITION_TARGET_TYPEMASK_VX_IGNORE | POSITION_TARGET_TYPEMASK_VY_IGNORE | POSITION_TARGET_TYPEMASK_VZ_IGNORE | POSITION_TARGET_TYPEMASK_YAW_RATE_IGNORE);
+
+	mavlink_msg_set_position_target_local_ned_encode(GCS_SYSID, 190, &m_message, &hold);
+
+	m_dirty = false;
+}
+
+
+void mavlinksdk::CMavlinkSetpointStreamer::loopStream ()
+{
+	const std::chrono::microseconds period (1000000 / m_rate_hz);
+	std::chrono::steady_clock::time_point next_tick = std::chrono::steady_clock::now();
+
+	while (m_streaming)
+	{
+		next_tick += period;
+
+		mavlink_message_t mavlink_message;
+		{
+			const std::lock_guard<std::mutex> lock(m_lock);
+
+			const uint64_t now = get_time_usec();
+
+			if ((!m_holding) && ((now - m_last_producer_update) > m_producer_timeout_us))
+			{
+				#ifdef DEBUG
+					std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: Setpoint producer timeout - HOLD" << _NORMAL_CONSOLE_TEXT_ << std::endl;
+				#endif
+
+				m_holding = true;
+				encodeHold();
+			}
+			else if (m_dirty)
+			{
+				if (m_holding)
+				{
+					encodeHold();
+				}
+				else
+				{
+					encodeTemplate();
+				}
+			}
+
+			// time_boot_ms is the first field in both messages. patch it and finalize with a new sequence.
+			_mav_put_uint32_t(_MAV_PAYLOAD_NON_CONST(&m_message), 0, (uint32_t)((now - m_stream_start_time) / 1000));
+			if (m_message.msgid == MAVLINK_MSG_ID_SET_POSITION_TARGET_GLOBAL_INT)
+			{
+				mavlink_finalize_message(&m_message, GCS_SYSID, 190, MAVLINK_MSG_ID_SET_POSITION_TARGET_GLOBAL_INT_MIN_LEN, MAVLINK_MSG_ID_SET_POSITION_TARGET_GLOBAL_INT_LEN, MAVLINK_MSG_ID_SET_POSITION_TARGET_GLOBAL_INT_CRC);
+			}
+			else
+			{
+				mavlink_finalize_message(&m_message, GCS_SYSID, 190, MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED_MIN_LEN, MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED_LEN, MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED_CRC);
+			}
+
+			mavlink_message = m_message;
+		}
+
+		// send outside lock so producers are never blocked by the link.
+		mavlinksdk::CMavlinkSDK::getInstance().sendMavlinkMessage(mavlink_message);
+
+		// link was busy longer than a period. do not burst to catch up.
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (next_tick < now) next_tick = now;
+
+		std::this_thread::sleep_until(next_tick);
+	}
+}
@@ -0,0 +1,136 @@
+#ifndef MAVLINK_SETPOINT_STREAMER_H_
+#define MAVLINK_SETPOINT_STREAMER_H_
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include <all/mavlink.h>
+
+namespace mavlinksdk
+{
+
+#define SETPOINT_STREAM_MIN_RATE                1       // Hz
+#define SETPOINT_STREAM_MAX_RATE                50      // Hz
+#define SETPOINT_STREAM_DEFAULT_RATE            20      // Hz
+#define SETPOINT_STREAM_DEFAULT_PRODUCER_TIMEOUT 500000 // usec without target update before switching to hold.
+
+
+/**
+ * @brief all fields ignored. Setters clear ignore bits of the fields they set.
+ *
+ */
+#define SETPOINT_STREAM_TYPEMASK_IGNORE_ALL    (POSITION_TARGET_TYPEMASK_X_IGNORE  | POSITION_TARGET_TYPEMASK_Y_IGNORE  | POSITION_TARGET_TYPEMASK_Z_IGNORE  | \
+                                                POSITION_TARGET_TYPEMASK_VX_IGNORE | POSITION_TARGET_TYPEMASK_VY_IGNORE | POSITION_TARGET_TYPEMASK_VZ_IGNORE | \
+                                                POSITION_TARGET_TYPEMASK_AX_IGNORE | POSITION_TARGET_TYPEMASK_AY_IGNORE | POSITION_TARGET_TYPEMASK_AZ_IGNORE | \
+                                                POSITION_TARGET_TYPEMASK_YAW_IGNORE | POSITION_TARGET_TYPEMASK_YAW_RATE_IGNORE)
+
+
+/**
+ * @brief Streams SET_POSITION_TARGET_LOCAL_NED or SET_POSITION_TARGET_GLOBAL_INT at a steady rate.
+ * @details Producers update position, velocity, acceleration, yaw or yaw-rate at any rate.
+ * The streamer has its own timing thread that sends the latest target every period.
+ * The message is kept pre-encoded and re-encoded only when a producer changes the target;
+ * otherwise only time_boot_ms is patched and the message is finalized with a new sequence.
+ * If no producer updates the target within producer timeout the streamer switches to hold:
+ * zero velocity setpoints that brake the vehicle, till a new target is set or streaming is stopped.
+ *
+ */
+class CMavlinkSetpointStreamer
+{
+    public:
+        //https://stackoverflow.com/questions/1008019/c-singleton-design-pattern
+        static CMavlinkSetpointStreamer& getInstance()
+        {
+            static CMavlinkSetpointStreamer instance;
+
+            return instance;
+        };
+
+        CMavlinkSetpointStreamer(CMavlinkSetpointStreamer const&)       = delete;
+        void operator=(CMavlinkSetpointStreamer const&)                 = delete;
+
+
+        // Note: Scott Meyers mentions in his Effective Modern
+        //       C++ book, that deleted functions should generally
+        //       be public as it results in better error messages
+        //       due to the compilers behavior to check accessibility
+        //       before deleted status
+
+    private:
+
+        CMavlinkSetpointStreamer()
+        {
+            clearTarget();
+        };
+
+    public:
+
+        ~CMavlinkSetpointStreamer ()
+        {
+            stop();
+        };
+
+    public:
+
+        void start (const uint32_t rate_hz = SETPOINT_STREAM_DEFAULT_RATE, const uint64_t producer_timeout_us = SETPOINT_STREAM_DEFAULT_PRODUCER_TIMEOUT);
+        void stop ();
+
+        void setPositionLocal (const float x, const float y, const float z, const MAV_FRAME mav_frame = MAV_FRAME_LOCAL_NED);
+        void setPositionGlobal (const double& latitude, const double& longitude, const float relative_altitude);
+        void setVelocity (const float vx, const float vy, const float vz, const MAV_FRAME mav_frame = MAV_FRAME_LOCAL_NED);
+        void setAcceleration (const float afx, const float afy, const float afz);
+        void setYaw (const float yaw);
+        void setYawRate (const float yaw_rate);
+
+        /**
+         * @brief ignore all fields of current target. Next setters build a new target.
+         *
+         */
+        void clearTarget ();
+
+        const bool isStreaming () const
+        {
+            return m_streaming;
+        }
+
+        const bool isHolding () const
+        {
+            const std::lock_guard<std::mutex> lock(m_lock);
+            return m_holding;
+        }
+
+    protected:
+
+        void loopStream ();
+        void encodeTemplate ();
+        void encodeHold ();
+        void targetUpdated ();
+
+    protected:
+
+        mavlink_set_position_target_local_ned_t m_target_local;
+        mavlink_set_position_target_global_int_t m_target_global;
+        bool m_is_global = false;
+
+        /**
+         * @brief pre-encoded message that is sent each period.
+         *
+         */
+        mavlink_message_t m_message;
+        bool m_dirty = true;
+        bool m_holding = false;
+
+        uint32_t m_rate_hz = SETPOINT_STREAM_DEFAULT_RATE;
+        uint64_t m_producer_timeout_us = SETPOINT_STREAM_DEFAULT_PRODUCER_TIMEOUT;
+        uint64_t m_last_producer_update = 0;
+        uint64_t m_stream_start_time = 0;
+
+        mutable std::mutex m_lock;
+        std::thread m_stream_thread;
+        std::atomic<bool> m_streaming{false};
+};
+
+}
+
+#endif
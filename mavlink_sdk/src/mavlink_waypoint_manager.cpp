@@ -1,7 +1,13 @@
 #include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
 #include "./helpers/colors.h"
+#include "./helpers/utils.h"
 #include "mavlink_helper.h"
 #include "mavlink_command.h"
+#include "vehicle.h"
 #include "mavlink_waypoint_manager.h"
 
 
@@ -17,56 +23,390 @@ void CMavlinkWayPointManager::setCallbackWaypoint (mavlinksdk::CCallBack_WayPoin
 }
 
 
+void CMavlinkWayPointManager::setReadWindow (const uint16_t window)
+{
+    const std::lock_guard<std::recursive_mutex> lock(m_lock);
+    m_mission_read_window = window;
+    if (m_mission_read_window == 0) m_mission_read_window = 1;
+    if (m_mission_read_window > MISSION_READ_WINDOW_MAX) m_mission_read_window = MISSION_READ_WINDOW_MAX;
+}
+
+
 void CMavlinkWayPointManager::reloadWayPoints ()
+{
+    readWayPoints(MAV_MISSION_TYPE_MISSION, nullptr);
+}
+
+
+void CMavlinkWayPointManager::readWayPoints (const MAV_MISSION_TYPE& mission_type, MISSION_TRANSFER_CALLBACK callback)
+{
+    const std::lock_guard<std::recursive_mutex> lock(m_lock);
+    if (m_state != WAYPOINT_STATE_IDLE)
+    {
+        T_MISSION_TRANSFER transfer;
+        transfer.write = false;
+        transfer.mission_type = mission_type;
+        transfer.callback = callback;
+        m_transfer_queue.push_back(transfer);
+        return ;
+    }
+
+    startRead(mission_type, callback);
+}
+
+
+void CMavlinkWayPointManager::startRead (const MAV_MISSION_TYPE& mission_type, MISSION_TRANSFER_CALLBACK callback)
 {
     m_mission_waiting_for_seq = 0;
+    m_read_mission_type = mission_type;
+    m_read_callback = callback;
+    m_read_items.clear();
+    m_mission_read_received.clear();
+    m_mission_read_received_count = 0;
+    m_mission_read_count = 0;
+    m_mission_read_next_seq = 0;
+    m_mission_read_requests.clear();
+    m_mission_read_deadline = 0;
+    m_mission_list_request = T_MISSION_REQUEST();
+    m_mission_list_request.sent_time = get_time_usec();
+    m_mission_read_opaque_id = 0;
+    if (mission_type == MAV_MISSION_TYPE_MISSION)
+    {
+        m_vehicle_mission.clear();
+        m_vehicle_mission_valid = false;
+    }
+    
     m_state = WAYPOINT_STATE_READ_REQUEST;
-    mavlinksdk::CMavlinkCommand::getInstance().requestMissionList();
+    if ((mission_type == MAV_MISSION_TYPE_MISSION) && readFromCache()) return ;
+    
+    mavlinksdk::CMavlinkCommand::getInstance().requestMissionList(mission_type);
 }
 
 
+/**
+ * @brief start next queued transfer if no transfer is active.
+ * 
+ */
+void CMavlinkWayPointManager::startNextTransfer ()
+{
+    if (m_state != WAYPOINT_STATE_IDLE) return ;
+    if (m_transfer_queue.empty()) return ;
+
+    T_MISSION_TRANSFER transfer = m_transfer_queue.front();
+    m_transfer_queue.pop_front();
+
+    if (transfer.write)
+    {
+        startWrite(transfer.mavlink_mission, transfer.mission_type, transfer.callback);
+    }
+    else
+    {
+        startRead(transfer.mission_type, transfer.callback);
+    }
+}
+
+
+/**
+ * @brief MISSION_CLEAR_ALL ends any transfer on autopilot side, so active and queued
+ * transfers are cancelled and their callbacks are called with MAV_MISSION_OPERATION_CANCELLED.
+ * 
+ */
 void CMavlinkWayPointManager::clearWayPoints ()
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_lock);
+
+    std::vector<MISSION_TRANSFER_CALLBACK> callbacks;
+    if ((m_state == WAYPOINT_STATE_WRITING_WP_COUNT) || (m_state == WAYPOINT_STATE_WRITING_ACK))
+    {
+        callbacks.push_back(m_write_callback);
+        m_write_callback = nullptr;
+        m_write_ranges.clear();
+    }
+    else if (m_state == WAYPOINT_STATE_READ_REQUEST)
+    {
+        callbacks.push_back(m_read_callback);
+        m_read_callback = nullptr;
+        m_mission_read_requests.clear();
+        m_mission_list_request = T_MISSION_REQUEST();
+        m_read_items.clear();
+    }
+    
+    for (const T_MISSION_TRANSFER& transfer : m_transfer_queue)
+    {
+        callbacks.push_back(transfer.callback);
+    }
+    m_transfer_queue.clear();
+
     m_mission_waiting_for_seq = 0;
+    m_vehicle_mission.clear();
+    m_vehicle_mission_valid = false;
     m_state = WAYPOINT_STATE_IDLE;
     m_callback_waypoint->OnWayPointsLoadingCompleted();
 
+    const std::map <int, mavlink_mission_item_int_t> mavlink_mission;
+    for (const MISSION_TRANSFER_CALLBACK& callback : callbacks)
+    {
+        if (callback) callback(MAV_MISSION_OPERATION_CANCELLED, mavlink_mission);
+    }
 }
 
 /**
  * @brief Upload Mission to Ardupilot.
  * This is the entery function.
+ * If mission on vehicle is known and has the same number of items, only changed items are written
+ * using MISSION_WRITE_PARTIAL_LIST. Otherwise the whole mission is uploaded.
  * 
  * @param mavlink_mission std::map of mavlink_missions
  * @param mission_type MAV_MISSION_TYPE
  */
-void CMavlinkWayPointManager::saveWayPoints (std::map <int, mavlink_mission_item_int_t> mavlink_mission, const MAV_MISSION_TYPE& mission_type)
+void CMavlinkWayPointManager::saveWayPoints (const std::map <int, mavlink_mission_item_int_t>& mavlink_mission, const MAV_MISSION_TYPE& mission_type, MISSION_TRANSFER_CALLBACK callback)
+{
+    const std::lock_guard<std::recursive_mutex> lock(m_lock);
+    if (m_state != WAYPOINT_STATE_IDLE)
+    {
+        T_MISSION_TRANSFER transfer;
+        transfer.write = true;
+        transfer.mission_type = mission_type;
+        transfer.mavlink_mission = mavlink_mission;
+        transfer.callback = callback;
+        
+        // a newer write replaces a queued write of the same type.
+        for (T_MISSION_TRANSFER& queued_transfer : m_transfer_queue)
+        {
+            if (queued_transfer.write && (queued_transfer.mission_type == mission_type))
+            {
+                queued_transfer = transfer;
+                return ;
+            }
+        }
+        
+        m_transfer_queue.push_back(transfer);
+        return ;
+    }
+
+    startWrite(mavlink_mission, mission_type, callback);
+}
+
+
+void CMavlinkWayPointManager::startWrite (const std::map <int, mavlink_mission_item_int_t>& mavlink_mission, const MAV_MISSION_TYPE& mission_type, MISSION_TRANSFER_CALLBACK callback)
 {
     m_state = WAYPOINT_STATE_WRITING_WP_COUNT;
     m_mavlink_mission = mavlink_mission;
+    m_write_mission_type = mission_type;
+    m_write_callback = callback;
+    m_write_activity_time = get_time_usec();
+    m_write_ranges.clear();
+    m_write_range_index = 0;
     const int waypoint_count = mavlink_mission.size();
     m_mission_write_count = waypoint_count;
+
+    if ((mission_type == MAV_MISSION_TYPE_MISSION) && buildWriteRanges(mavlink_mission))
+    {
+        if (m_write_ranges.empty())
+        {
+            // nothing changed.
+            m_state = WAYPOINT_STATE_IDLE;
+            if (callback)
+            {
+                callback(MAV_MISSION_ACCEPTED, mavlink_mission);
+            }
+            else
+            {
+                m_callback_waypoint->OnMissionSaveFinished(MAV_MISSION_ACCEPTED, mission_type, mavlinksdk::CMavlinkHelper::getMissionACKResult (MAV_MISSION_ACCEPTED));
+            }
+            startNextTransfer();
+            return ;
+        }
+
+        m_state = WAYPOINT_STATE_WRITING_ACK;
+        writeNextRange();
+        return ;
+    }
+
     mavlinksdk::CMavlinkCommand::getInstance().setMissionCount (waypoint_count, mission_type);
     m_state = WAYPOINT_STATE_WRITING_ACK;
 }
 
 
+bool CMavlinkWayPointManager::isSameMissionItem (const mavlink_mission_item_int_t& item1, const mavlink_mission_item_int_t& item2)
+{
+    // NaN is used for unset params e.g. yaw.
+    auto same_float = [](const float value1, const float value2) { return (value1 == value2) || (std::isnan(value1) && std::isnan(value2)); };
+
+    // target ids & current flag are not part of the plan.
+    return (item1.command == item2.command)
+        && (item1.frame == item2.frame)
+        && (item1.x == item2.x)
+        && (item1.y == item2.y)
+        && same_float(item1.z, item2.z)
+        && same_float(item1.param1, item2.param1)
+        && same_float(item1.param2, item2.param2)
+        && same_float(item1.param3, item2.param3)
+        && same_float(item1.param4, item2.param4)
+        && (item1.autocontinue == item2.autocontinue);
+}
 
 
-void CMavlinkWayPointManager::handle_mission_ack (const mavlink_mission_ack_t& mission_ack)
+/**
+ * @brief compare mission with mission on vehicle and fill m_write_ranges with changed items.
+ * Changed ranges separated by a few unchanged items are merged as a round trip costs more than few items.
+ * Copy of mission on vehicle is trusted only if autopilot reports opaque_id, as otherwise
+ * changes by another GCS with the same item count are not detected.
+ * 
+ * @return false if mission on vehicle is unknown or item count changed, so full upload is needed.
+ */
+bool CMavlinkWayPointManager::buildWriteRanges (const std::map <int, mavlink_mission_item_int_t>& mavlink_mission)
 {
+    if (!m_vehicle_mission_valid) return false;
+    if (m_vehicle_opaque_id[MAV_MISSION_TYPE_MISSION] == 0) return false;
+    if (m_vehicle_mission.size() != mavlink_mission.size()) return false;
+    
+    // both maps are keyed by seq 0..count-1.
+    auto vehicle_item = m_vehicle_mission.cbegin();
+    for (auto item = mavlink_mission.cbegin(); item != mavlink_mission.cend(); ++item, ++vehicle_item)
+    {
+        if (item->first != vehicle_item->first) 
+        {
+            m_write_ranges.clear();
+            return false;
+        }
+
+        if (isSameMissionItem(item->second, vehicle_item->second)) continue;
+
+        const uint16_t seq = item->first;
+        if (!m_write_ranges.empty() && (seq - m_write_ranges.back().second <= MISSION_PARTIAL_MERGE_GAP + 1))
+        {
+            m_write_ranges.back().second = seq;
+        }
+        else
+        {
+            m_write_ranges.push_back(std::make_pair(seq, seq));
+        }
+    }
+
+    #ifdef DEBUG
+    std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: changed ranges: " << std::to_string(m_write_ranges.size()) << _NORMAL_CONSOLE_TEXT_ << std::endl;
+    #endif
+
+    return true;
+}
+
+
+/**
+ * @brief autopilot handles one partial write at a time, so next range is written after MISSION_ACK.
+ * 
+ */
+void CMavlinkWayPointManager::writeNextRange ()
+{
+    const std::pair<uint16_t, uint16_t>& range = m_write_ranges[m_write_range_index];
+    mavlinksdk::CMavlinkCommand::getInstance().setMissionPartialList (range.first, range.second, m_write_mission_type);
+}
+
+
+/**
+ * @brief complete active write. A failed partial write is retried as a full upload.
+ * 
+ * @return false if write continues as a full upload.
+ */
+bool CMavlinkWayPointManager::finishWrite (const mavlink_mission_ack_t& mission_ack, const uint32_t opaque_id)
+{
+    if ((mission_ack.type != MAV_MISSION_ACCEPTED) && !m_write_ranges.empty())
+    {
+        std::cout << _ERROR_CONSOLE_TEXT_ << "Mission Partial Write Failed: uploading whole mission" << _NORMAL_CONSOLE_TEXT_ << std::endl;
+        // part of mission may have been written.
+        m_vehicle_mission_valid = false;
+        m_write_ranges.clear();
+        m_write_range_index = 0;
+        m_write_activity_time = get_time_usec();
+        mavlinksdk::CMavlinkCommand::getInstance().setMissionCount (m_mission_write_count, m_write_mission_type);
+        m_state = WAYPOINT_STATE_WRITING_ACK;
+        return false;
+    }
+
+    m_state = WAYPOINT_STATE_IDLE;
+
+    if ((mission_ack.type == MAV_MISSION_ACCEPTED) && (m_write_mission_type < MISSION_CACHE_TYPES))
+    {
+        // 0 if autopilot does not report opaque_id. next MISSION_CURRENT is then accepted as is.
+        m_vehicle_opaque_id[m_write_mission_type] = opaque_id;
+        updateCache(m_write_mission_type, opaque_id, m_mavlink_mission);
+    }
+
+    if (m_write_mission_type == MAV_MISSION_TYPE_MISSION)
+    {
+        if (mission_ack.type == MAV_MISSION_ACCEPTED)
+        {
+            m_vehicle_mission = m_mavlink_mission;
+            m_vehicle_mission_valid = true;
+            // total in MISSION_CURRENT is expected to change.
+            m_vehicle_mission_total = 0;
+        }
+        else
+        {
+            // part of mission may have been written.
+            m_vehicle_mission_valid = false;
+        }
+    }
+
+    if (m_write_callback)
+    {
+        const MISSION_TRANSFER_CALLBACK callback = m_write_callback;
+        m_write_callback = nullptr;
+        callback(mission_ack.type, m_mavlink_mission);
+        return true;
+    }
+    
+    m_callback_waypoint->OnMissionSaveFinished(mission_ack.type, mission_ack.mission_type, mavlinksdk::CMavlinkHelper::getMissionACKResult (mission_ack.type));
+    return true;
+}
+
+
+
+
+void CMavlinkWayPointManager::handle_mission_ack (const mavlink_mission_ack_t& mission_ack, const uint32_t opaque_id)
+{
+    const std::lock_guard<std::recursive_mutex> lock(m_lock);
 	#ifdef DDEBUG
     std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: handle_mission_ack "  << _NORMAL_CONSOLE_TEXT_ << std::endl;
     #endif
     switch (m_state)
     {
+        case WAYPOINT_STATE_READ_REQUEST:
+        {
+            if ((mission_ack.mission_type != m_read_mission_type) || (mission_ack.type == MAV_MISSION_ACCEPTED)) break;
+
+            // autopilot rejected read. no more items will arrive.
+            finishRead(false);
+        }
+        return ;
+
         case WAYPOINT_STATE_WRITING_WP_COUNT:
             m_state = WAYPOINT_STATE_WRITING_ACK;
         break;
 
         case WAYPOINT_STATE_WRITING_ACK:
-            m_callback_waypoint->OnMissionSaveFinished(mission_ack.type, mission_ack.mission_type, mavlinksdk::CMavlinkHelper::getMissionACKResult (mission_ack.type));        
-        break;
+        {
+            if (mission_ack.mission_type != m_write_mission_type) return ;
+            
+            m_write_activity_time = get_time_usec();
+            if ((mission_ack.type == MAV_MISSION_ACCEPTED) && (m_write_range_index + 1 < m_write_ranges.size()))
+            {
+                // intermediate range of a partial write.
+                ++m_write_range_index;
+                writeNextRange();
+                return ;
+            }
+
+            // transfers with own callback are not reported to GCS.
+            const bool notify = !m_write_callback;
+            if (!finishWrite(mission_ack, opaque_id)) return ;
+            if (notify)
+            {
+                m_callback_waypoint->OnMissionACK (mission_ack.type, mission_ack.mission_type, mavlinksdk::CMavlinkHelper::getMissionACKResult (mission_ack.type));
+            }
+            startNextTransfer();
+        }
+        return ;
 
         default:
         break;
@@ -80,47 +420,44 @@ void CMavlinkWayPointManager::handle_mission_ack (const mavlink_mission_ack_t& m
 }
 
 
-void CMavlinkWayPointManager::handle_mission_count (const mavlink_mission_count_t& mission_count)
+void CMavlinkWayPointManager::handle_mission_count (const mavlink_mission_count_t& mission_count, const uint32_t opaque_id)
 {
-    
-    m_mission_count = mission_count;
+    const std::lock_guard<std::recursive_mutex> lock(m_lock);
+    if (mission_count.mission_type == MAV_MISSION_TYPE_MISSION)
+    {
+        m_mission_count = mission_count;
+    }
 
     #ifdef DEBUG
-    std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: m_mission_count:" << std::to_string(m_mission_count.count) << _NORMAL_CONSOLE_TEXT_ << std::endl;
+    std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: mission_count:" << std::to_string(mission_count.count) << " type:" << std::to_string(mission_count.mission_type) << _NORMAL_CONSOLE_TEXT_ << std::endl;
     #endif
 
-    switch (mission_count.mission_type)
-    {
-        case MAV_MISSION_TYPE_MISSION:
-        {
-            if (m_mission_count.count == 0)
-            {
-                //mavlinksdk::CMavlinkCommand::getInstance().sendMissionAck();
-                return ;
-            }
-            
-            switch (m_state)
-            {
-                case WAYPOINT_STATE_READ_REQUEST:
-                    mavlinksdk::CMavlinkCommand::getInstance().getWayPointByNumber(0);
-                    break;
-                
-                default:
-                    break;
-            } 
-            
-        }
-        break;
+    if (m_state != WAYPOINT_STATE_READ_REQUEST) return ;
+    if (mission_count.mission_type != m_read_mission_type) return ;
+    // duplicate MISSION_COUNT as MISSION_REQUEST_LIST has been resent.
+    if (m_mission_list_request.sent_time == 0) return ;
+    
+    m_mission_list_request = T_MISSION_REQUEST();
+    m_mission_read_opaque_id = opaque_id;
+    m_mission_read_count = mission_count.count;
 
-        
-    };
+    if (m_mission_read_count == 0)
+    {
+        // no ACK is expected for empty mission.
+        finishRead(true);
+        return ;
+    }
+    
+    m_mission_read_received.assign(m_mission_read_count, false);
+    m_mission_read_deadline = get_time_usec() + MISSION_READ_DEADLINE_BASE + (uint64_t)MISSION_READ_DEADLINE_PER_ITEM * m_mission_read_count;
+    fillReadWindow();
 }
 
 
 void CMavlinkWayPointManager::writeMissionItems ()
 {
     const std::size_t length = m_mavlink_mission.size();
-    for (int i=0; i<length; ++i)
+    for (std::size_t i=0; i<length; ++i)
     {
         writeMissionItem(m_mavlink_mission.at(i));
     }
@@ -139,11 +476,34 @@ void CMavlinkWayPointManager::writeMissionItem(mavlink_mission_item_int_t& missi
     mavlinksdk::CMavlinkCommand::getInstance().writeMissionItem(mission_item_int);
 }
 
-void CMavlinkWayPointManager::handle_mission_current (const mavlink_mission_current_t& mission_current)
+void CMavlinkWayPointManager::handle_mission_current (const mavlink_mission_current_t& mission_current, const uint32_t mission_id, const uint32_t fence_id, const uint32_t rally_id)
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_lock);
+    if ((mission_id != 0) && (m_state == WAYPOINT_STATE_IDLE))
+    {
+        // mission changed by another GCS.
+        if ((m_vehicle_opaque_id[MAV_MISSION_TYPE_MISSION] != 0) && (m_vehicle_opaque_id[MAV_MISSION_TYPE_MISSION] != mission_id))
+        {
+            m_vehicle_mission_valid = false;
+        }
+    }
+    m_vehicle_opaque_id[MAV_MISSION_TYPE_MISSION] = mission_id;
+    m_vehicle_opaque_id[MAV_MISSION_TYPE_FENCE] = fence_id;
+    m_vehicle_opaque_id[MAV_MISSION_TYPE_RALLY] = rally_id;
+
     // handle_mission_item_reached detects changes
     const mavlink_mission_current_t last_mission_current = m_mission_current;
     m_mission_current = mission_current;
+
+    if (m_vehicle_mission_valid && (m_state == WAYPOINT_STATE_IDLE))
+    {
+        // mission changed by another GCS. copy is no longer valid for partial writes.
+        if ((m_vehicle_mission_total != 0) && (m_vehicle_mission_total != mission_current.total))
+        {
+            m_vehicle_mission_valid = false;
+        }
+        m_vehicle_mission_total = mission_current.total;
+    }
     if ((last_mission_current.seq != mission_current.seq)
         || (last_mission_current.mission_state != mission_current.mission_state)
         || (last_mission_current.mission_mode != mission_current.mission_mode))
@@ -156,6 +516,7 @@ void CMavlinkWayPointManager::handle_mission_current (const mavlink_mission_curr
 
 void CMavlinkWayPointManager::handle_mission_item (const mavlink_message_t& mavlink_message) //const mavlink_mission_item_int_t& mission_item_int)
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_lock);
     if (m_state != WAYPOINT_STATE_READ_REQUEST) 
     {
         return ; //ignore
@@ -169,42 +530,397 @@ void CMavlinkWayPointManager::handle_mission_item (const mavlink_message_t& mavl
     #ifdef DEBUG
     std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: mission_item_int.seq " << std::to_string(mission_item_int.seq) << _NORMAL_CONSOLE_TEXT_ << std::endl;
     #endif
-    if (mission_item_int.mission_type == MAV_MISSION_TYPE_MISSION)
+    if (mission_item_int.mission_type != m_read_mission_type) return ;
+    if (mission_item_int.seq >= m_mission_read_received.size()) return ;
+    // duplicate reply of a resent request.
+    if (m_mission_read_received[mission_item_int.seq]) return ;
+    
+    m_mission_read_received[mission_item_int.seq] = true;
+    m_mission_read_received_count++;
+    m_mission_read_requests.erase(mission_item_int.seq);
+    
+    m_read_items[mission_item_int.seq] = mission_item_int;
+    if (!m_read_callback)
+    {
+        m_callback_waypoint->OnWayPointReceived (mission_item_int);
+    }
+    
+    if (m_mission_read_received_count == m_mission_read_count)
+    {
+        // inform FCB that you received missions.
+        std::cout << _SUCCESS_CONSOLE_TEXT_ << "Mission Received Way points count: " << std::to_string(m_mission_read_count) << " type: " << std::to_string(m_read_mission_type) << _NORMAL_CONSOLE_TEXT_ << std::endl;
+        mavlinksdk::CMavlinkCommand::getInstance().sendMissionAck(mavlink_message.sysid, mavlink_message.compid, MAV_MISSION_ACCEPTED, m_read_mission_type);
+        finishRead(true);
+        return ;
+    }
+
+    if ((!m_read_callback) && ((m_mission_read_received_count % MISSION_READ_PROGRESS_ITEMS) == 0))
+    {
+        m_callback_waypoint->OnWayPointsLoadingProgress (m_mission_read_received_count, m_mission_read_count);
+    }
+
+    fillReadWindow();
+}
+
+
+uint16_t CMavlinkWayPointManager::getReadWindow () const
+{
+    if (m_mission_read_window != 0) return m_mission_read_window;
+
+    return (mavlinksdk::CVehicle::getInstance().getMsgHeartBeat().autopilot == MAV_AUTOPILOT_ARDUPILOTMEGA) ? MISSION_READ_WINDOW_ARDUPILOT : MISSION_READ_WINDOW_DEFAULT;
+}
+
+
+/**
+ * @brief send MISSION_REQUEST_INT for next items till window is full.
+ * Autopilot answers each request independently so items can be requested ahead.
+ *
+ */
+void CMavlinkWayPointManager::fillReadWindow ()
+{
+    const uint64_t now = get_time_usec();
+    const uint16_t window = getReadWindow();
+    while ((m_mission_read_requests.size() < window) && (m_mission_read_next_seq < m_mission_read_count))
+    {
+        const uint16_t seq = m_mission_read_next_seq++;
+        if (m_mission_read_received[seq]) continue;
+        
+        T_MISSION_REQUEST request;
+        request.sent_time = now;
+        m_mission_read_requests[seq] = request;
+        mavlinksdk::CMavlinkCommand::getInstance().getWayPointByNumber(seq, m_read_mission_type);
+    }
+}
+
+
+void CMavlinkWayPointManager::finishRead (const bool success)
+{
+    m_state = WAYPOINT_STATE_IDLE;
+    m_mission_read_requests.clear();
+    m_mission_list_request = T_MISSION_REQUEST();
+    
+    if (success && (m_read_mission_type < MISSION_CACHE_TYPES))
     {
-        if (m_state == WAYPOINT_STATE_READ_REQUEST) 
+        if (m_mission_read_opaque_id != 0)
+        {
+            m_vehicle_opaque_id[m_read_mission_type] = m_mission_read_opaque_id;
+        }
+        
+        const T_MISSION_CACHE& cache = m_mission_cache[m_read_mission_type];
+        if ((!cache.valid) || (cache.opaque_id != m_mission_read_opaque_id))
         {
-            m_callback_waypoint->OnWayPointReceived (mission_item_int);
+            updateCache(m_read_mission_type, m_mission_read_opaque_id, m_read_items);
         }
+    }
+
+    if (success && (m_read_mission_type == MAV_MISSION_TYPE_MISSION))
+    {
+        m_vehicle_mission = m_read_items;
+        m_vehicle_mission_valid = true;
+        m_vehicle_mission_total = 0;
+    }
+
+    if (!success)
+    {
+        std::cout << _ERROR_CONSOLE_TEXT_ << "Mission Read Failed: received " << std::to_string(m_mission_read_received_count) << " of " << std::to_string(m_mission_read_count) << " type: " << std::to_string(m_read_mission_type) << _NORMAL_CONSOLE_TEXT_ << std::endl;
+    }
+
+    if (m_read_callback)
+    {
+        // callback may start a new transfer.
+        const MISSION_TRANSFER_CALLBACK callback = m_read_callback;
+        m_read_callback = nullptr;
+        std::map <int, mavlink_mission_item_int_t> mavlink_mission;
+        mavlink_mission.swap(m_read_items);
+        callback(success ? MAV_MISSION_ACCEPTED : MAV_MISSION_ERROR, mavlink_mission);
+    }
+    else if (success)
+    {
+        m_callback_waypoint->OnWayPointsLoadingProgress (m_mission_read_received_count, m_mission_read_count);
+        m_callback_waypoint->OnWayPointsLoadingCompleted();
+    }
+    else
+    {
+        m_callback_waypoint->OnWayPointsLoadingFailed();
+    }
+
+    startNextTransfer();
+}
+
+
+/**
+ * @brief resend timed out MISSION_REQUEST_LIST & MISSION_REQUEST_INT.
+ * Read fails when a request exceeds MISSION_READ_MAX_RETRIES or whole mission exceeds its deadline.
+ * Called from parser thread so incoming traffic drives timeouts.
+ *
+ */
+void CMavlinkWayPointManager::checkMissionRequests ()
+{
+    const std::lock_guard<std::recursive_mutex> lock(m_lock);
+    const uint64_t now = get_time_usec();
+
+    if ((m_state == WAYPOINT_STATE_WRITING_WP_COUNT) || (m_state == WAYPOINT_STATE_WRITING_ACK))
+    {
+        if ((now - m_write_activity_time) < MISSION_WRITE_TIMEOUT) return ;
+
+        std::cout << _ERROR_CONSOLE_TEXT_ << "Mission Write Timeout type: " << std::to_string(m_write_mission_type) << _NORMAL_CONSOLE_TEXT_ << std::endl;
+        mavlink_mission_ack_t mission_ack = {0};
+        mission_ack.type = MAV_MISSION_OPERATION_CANCELLED;
+        mission_ack.mission_type = m_write_mission_type;
+        if (!finishWrite(mission_ack, 0)) return ;
+        startNextTransfer();
+        return ;
+    }
+
+    if (m_state != WAYPOINT_STATE_READ_REQUEST) return ;
+
+    if (m_mission_list_request.sent_time != 0)
+    {
+        // waiting for MISSION_COUNT.
+        if ((now - m_mission_list_request.sent_time) < MISSION_READ_ITEM_TIMEOUT) return ;
+        
+        if (m_mission_list_request.retries >= MISSION_READ_MAX_RETRIES)
+        {
+            finishRead(false);
+            return ;
+        }
+
+        m_mission_list_request.sent_time = now;
+        m_mission_list_request.retries++;
+        mavlinksdk::CMavlinkCommand::getInstance().requestMissionList(m_read_mission_type);
+        return ;
+    }
+
+    if (now > m_mission_read_deadline)
+    {
+        finishRead(false);
+        return ;
+    }
+
+    for (auto& request : m_mission_read_requests)
+    {
+        if ((now - request.second.sent_time) < MISSION_READ_ITEM_TIMEOUT) continue;
+        
+        if (request.second.retries >= MISSION_READ_MAX_RETRIES)
+        {
+            finishRead(false);
+            return ;
+        }
+
+        request.second.sent_time = now;
+        request.second.retries++;
+        mavlinksdk::CMavlinkCommand::getInstance().getWayPointByNumber(request.first, m_read_mission_type);
+    }
+}
+
+
+void CMavlinkWayPointManager::enableCache (const std::string& folder)
+{
+    const std::lock_guard<std::recursive_mutex> lock(m_lock);
+    m_cache_folder = folder;
+    if (!m_cache_folder.empty() && (m_cache_folder.back() != '/')) m_cache_folder += "/";
+    m_cache_sysid = -1;
+}
+
+
+bool CMavlinkWayPointManager::getCachedMission (const MAV_MISSION_TYPE& mission_type, std::map <int, mavlink_mission_item_int_t>& mavlink_mission)
+{
+    const std::lock_guard<std::recursive_mutex> lock(m_lock);
+    if (mission_type >= MISSION_CACHE_TYPES) return false;
     
-        if (m_mission_waiting_for_seq == mission_item_int.seq)
+    loadCache();
+
+    const T_MISSION_CACHE& cache = m_mission_cache[mission_type];
+    if ((!cache.valid) || (cache.opaque_id == 0) || (cache.opaque_id != m_vehicle_opaque_id[mission_type])) return false;
+
+    mavlink_mission = cache.items;
+    return true;
+}
+
+
+/**
+ * @brief serve mission read from cache if its opaque_id matches the one reported by vehicle.
+ * 
+ * @return false if mission should be downloaded.
+ */
+bool CMavlinkWayPointManager::readFromCache ()
+{
+    loadCache();
+    
+    const T_MISSION_CACHE& cache = m_mission_cache[MAV_MISSION_TYPE_MISSION];
+    const uint32_t opaque_id = m_vehicle_opaque_id[MAV_MISSION_TYPE_MISSION];
+    if ((!cache.valid) || (opaque_id == 0) || (cache.opaque_id != opaque_id)) return false;
+
+    const uint16_t count = cache.items.size();
+    m_mission_count.count = count;
+    m_mission_count.mission_type = MAV_MISSION_TYPE_MISSION;
+    m_mission_list_request = T_MISSION_REQUEST();
+    m_mission_read_count = count;
+    m_mission_read_received.assign(count, true);
+    m_mission_read_received_count = count;
+    m_mission_read_opaque_id = opaque_id;
+    m_read_items = cache.items;
+    
+    if (!m_read_callback)
+    {
+        for (const auto& item : m_read_items)
         {
-            m_mission_waiting_for_seq +=1;
-            m_mission_waiting_for_seq %=m_mission_count.count+1;
-            
+            m_callback_waypoint->OnWayPointReceived (item.second);
         }
+    }
+
+    std::cout << _SUCCESS_CONSOLE_TEXT_ << "Mission Loaded from Cache Way points count: " << std::to_string(count) << _NORMAL_CONSOLE_TEXT_ << std::endl;
+    
+    finishRead(true);
+    
+    return true;
+}
+
+
+void CMavlinkWayPointManager::updateCache (const uint8_t mission_type, const uint32_t opaque_id, const std::map <int, mavlink_mission_item_int_t>& mavlink_mission)
+{
+    if (mission_type >= MISSION_CACHE_TYPES) return ;
+    
+    loadCache();
 
-        const int next_seq = mission_item_int.seq + 1;
+    T_MISSION_CACHE& cache = m_mission_cache[mission_type];
+    if (opaque_id == 0)
+    {
+        // cannot be validated later.
+        cache = T_MISSION_CACHE();
+        return ;
+    }
+
+    cache.valid = true;
+    cache.opaque_id = opaque_id;
+    cache.items = mavlink_mission;
+    
+    saveCache(mission_type);
+}
+
+
+const std::string CMavlinkWayPointManager::getCacheFileName (const uint8_t mission_type) const
+{
+    return m_cache_folder + "mission_" + std::to_string(mavlinksdk::CVehicle::getInstance().getSysId()) + "_" + std::to_string(mission_type) + ".cache";
+}
+
+
+/**
+ * @brief read cache files of current vehicle once.
+ * @details format: header line, then [sysid mission_type opaque_id count], then a line per item
+ * [seq frame command autocontinue param1 param2 param3 param4 x y z] where floats are written as bits.
+ * 
+ */
+void CMavlinkWayPointManager::loadCache ()
+{
+    if (m_cache_folder.empty()) return ;
+    
+    const int sysid = mavlinksdk::CVehicle::getInstance().getSysId();
+    if (m_cache_sysid == sysid) return ;
+    m_cache_sysid = sysid;
+    
+    for (uint8_t mission_type = 0; mission_type < MISSION_CACHE_TYPES; ++mission_type)
+    {
+        T_MISSION_CACHE& cache = m_mission_cache[mission_type];
+        cache = T_MISSION_CACHE();
         
-        if (m_mission_count.count == next_seq)
+        std::ifstream file (getCacheFileName(mission_type));
+        if (!file.is_open()) continue;
+
+        std::string header;
+        int file_sysid, file_mission_type;
+        uint32_t opaque_id, count;
+        file >> header >> std::dec >> file_sysid >> file_mission_type >> std::hex >> opaque_id >> std::dec >> count;
+        if ((!file) || (header != "DE_MISSION_CACHE_1") || (file_sysid != sysid) || (file_mission_type != mission_type) || (opaque_id == 0)) continue;
+
+        bool valid = true;
+        for (uint32_t i=0; i<count; ++i)
         {
-            // inform FCB that you received missions.
-            std::cout << _SUCCESS_CONSOLE_TEXT_ << "Mission Received Way points count: " << std::to_string(m_mission_count.count) << _NORMAL_CONSOLE_TEXT_ << std::endl;
-            mavlinksdk::CMavlinkCommand::getInstance().sendMissionAck(mavlink_message.sysid, mavlink_message.compid, MAV_MISSION_ACCEPTED);
-            if (m_state == WAYPOINT_STATE_READ_REQUEST) 
+            int seq, frame, command, autocontinue;
+            uint32_t params[4], z;
+            int32_t x, y;
+            file >> std::dec >> seq >> frame >> command >> autocontinue 
+                 >> std::hex >> params[0] >> params[1] >> params[2] >> params[3] 
+                 >> std::dec >> x >> y >> std::hex >> z;
+            if ((!file) || (seq != (int)i))
             {
-                m_state = WAYPOINT_STATE_IDLE;
-                m_callback_waypoint->OnWayPointsLoadingCompleted();
+                valid = false;
+                break;
             }
+
+            mavlink_mission_item_int_t mission_item_int;
+            memset(&mission_item_int, 0, sizeof(mavlink_mission_item_int_t));
+            mission_item_int.seq = seq;
+            mission_item_int.frame = frame;
+            mission_item_int.command = command;
+            mission_item_int.autocontinue = autocontinue;
+            mission_item_int.mission_type = mission_type;
+            memcpy(&mission_item_int.param1, &params[0], sizeof(float));
+            memcpy(&mission_item_int.param2, &params[1], sizeof(float));
+            memcpy(&mission_item_int.param3, &params[2], sizeof(float));
+            memcpy(&mission_item_int.param4, &params[3], sizeof(float));
+            mission_item_int.x = x;
+            mission_item_int.y = y;
+            memcpy(&mission_item_int.z, &z, sizeof(float));
+            cache.items[seq] = mission_item_int;
         }
-        else
+
+        if (!valid)
         {
-            mavlinksdk::CMavlinkCommand::getInstance().getWayPointByNumber(next_seq);
+            cache = T_MISSION_CACHE();
+            continue;
         }
-        
+
+        cache.valid = true;
+        cache.opaque_id = opaque_id;
     }
 }
 
 
+/**
+ * @brief write cache of mission type. File is replaced atomically.
+ * 
+ */
+void CMavlinkWayPointManager::saveCache (const uint8_t mission_type) const
+{
+    if (m_cache_folder.empty()) return ;
+
+    const T_MISSION_CACHE& cache = m_mission_cache[mission_type];
+    
+    const std::string file_name = getCacheFileName(mission_type);
+    const std::string temp_file_name = file_name + ".tmp";
+    {
+        std::ofstream file (temp_file_name, std::ios::trunc);
+        if (!file.is_open()) return ;
+
+        file << "DE_MISSION_CACHE_1" << "\n"
+             << std::dec << m_cache_sysid << " " << (int)mission_type << " " << std::hex << cache.opaque_id << " " << std::dec << cache.items.size() << "\n";
+
+        int expected_seq = 0;
+        for (const auto& item : cache.items)
+        {
+            if (item.first != expected_seq++) return ; // not a contiguous mission. temp file is left unused.
+            
+            const mavlink_mission_item_int_t& mission_item_int = item.second;
+            uint32_t params[4], z;
+            memcpy(&params[0], &mission_item_int.param1, sizeof(float));
+            memcpy(&params[1], &mission_item_int.param2, sizeof(float));
+            memcpy(&params[2], &mission_item_int.param3, sizeof(float));
+            memcpy(&params[3], &mission_item_int.param4, sizeof(float));
+            memcpy(&z, &mission_item_int.z, sizeof(float));
+
+            file << std::dec << item.first << " " << (int)mission_item_int.frame << " " << mission_item_int.command << " " << (int)mission_item_int.autocontinue << " "
+                 << std::hex << params[0] << " " << params[1] << " " << params[2] << " " << params[3] << " "
+                 << std::dec << mission_item_int.x << " " << mission_item_int.y << " " << std::hex << z << "\n";
+        }
+
+        if (!file) return ;
+    }
+
+    std::rename(temp_file_name.c_str(), file_name.c_str());
+}
+
+
 void CMavlinkWayPointManager::handle_mission_item_reached (const mavlink_mission_item_reached_t& mission_item_reached)
 {
     m_callback_waypoint->OnWaypointReached(mission_item_reached.seq);
@@ -213,28 +929,36 @@ void CMavlinkWayPointManager::handle_mission_item_reached (const mavlink_mission
 
 void CMavlinkWayPointManager::handle_mission_item_request (const mavlink_mission_request_int_t& mission_request_int)
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_lock);
     #ifdef DEBUG
     std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: handle_mission_item_request  I AM HERE"  << _NORMAL_CONSOLE_TEXT_ << std::endl;
     #endif
    
 
-    if (mission_request_int.mission_type != MAV_MISSION_TYPE_MISSION ) return ;
+    if ((m_state != WAYPOINT_STATE_WRITING_WP_COUNT) && (m_state != WAYPOINT_STATE_WRITING_ACK)) return ;
+    if (mission_request_int.mission_type != m_write_mission_type) return ;
     if (m_mavlink_mission.size() <= mission_request_int.seq) return ;
     
+    m_write_activity_time = get_time_usec();
+    
     mavlinksdk::CMavlinkCommand::getInstance().writeMissionItem(m_mavlink_mission.at(mission_request_int.seq));
 }
 
 
 void CMavlinkWayPointManager::handle_mission_item_request (const mavlink_mission_request_t& mission_request)
 {
+    const std::lock_guard<std::recursive_mutex> lock(m_lock);
     
     #ifdef DEBUG
     std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: mission_request  "  << std::to_string(mission_request.seq) << _NORMAL_CONSOLE_TEXT_ << std::endl;
     #endif
    
-    if (mission_request.mission_type != MAV_MISSION_TYPE_MISSION ) return ;
+    if ((m_state != WAYPOINT_STATE_WRITING_WP_COUNT) && (m_state != WAYPOINT_STATE_WRITING_ACK)) return ;
+    if (mission_request.mission_type != m_write_mission_type) return ;
     if (m_mavlink_mission.size() <= mission_request.seq) return ;
     
+    m_write_activity_time = get_time_usec();
+    
     writeMissionItem(m_mavlink_mission.at(mission_request.seq));
     m_state = WAYPOINT_STATE_WRITING_ACK;
     //mavlinksdk::CMavlinkCommand::getInstance().writeMissionItem(m_mavlink_mission.at(mission_request.seq+1));
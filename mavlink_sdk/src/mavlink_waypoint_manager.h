@@ -1,6 +1,11 @@
 #ifndef WAYPOINT_MANAGER_H_
 #define WAYPOINT_MANAGER_H_
 #include <map>
+#include <vector>
+#include <deque>
+#include <string>
+#include <mutex>
+#include <functional>
 
 #include <all/mavlink.h>
 #include <ardupilotmega/ardupilotmega.h>
@@ -17,6 +22,68 @@ namespace mavlinksdk
 #define WAYPOINT_STATE_WRITING_WP           4    
 #define WAYPOINT_STATE_WRITING_ACK          5
 
+#define MISSION_READ_WINDOW_DEFAULT         1           // MISSION_REQUEST_INT in flight while reading mission.
+#define MISSION_READ_WINDOW_ARDUPILOT       8           // ArduPilot answers requests ahead of current item.
+#define MISSION_READ_WINDOW_MAX             32
+#define MISSION_READ_ITEM_TIMEOUT           500000      // usec before a request is sent again.
+#define MISSION_READ_MAX_RETRIES            5           // retries of a single request before read fails.
+#define MISSION_READ_DEADLINE_BASE          5000000     // usec. whole mission deadline is base + per item * count.
+#define MISSION_READ_DEADLINE_PER_ITEM      100000
+#define MISSION_READ_PROGRESS_ITEMS         16          // progress is reported each this number of items.
+#define MISSION_PARTIAL_MERGE_GAP           4           // unchanged items between two changed ranges that are resent to save a round trip.
+#define MISSION_WRITE_TIMEOUT               5000000     // usec without autopilot requests or ACK before write fails.
+
+// payload offsets of opaque_id extension fields.
+#define MISSION_COUNT_OPAQUE_ID_OFFSET      5
+#define MISSION_ACK_OPAQUE_ID_OFFSET        4
+#define MISSION_CURRENT_MISSION_ID_OFFSET   6
+#define MISSION_CURRENT_FENCE_ID_OFFSET     10
+#define MISSION_CURRENT_RALLY_ID_OFFSET     14
+
+#define MISSION_CACHE_TYPES                 3           // MAV_MISSION_TYPE_MISSION, MAV_MISSION_TYPE_FENCE & MAV_MISSION_TYPE_RALLY
+
+
+/**
+ * @brief outstanding MISSION_REQUEST_INT or MISSION_REQUEST_LIST.
+ *
+ */
+typedef struct T_MISSION_REQUEST {
+        uint64_t sent_time = 0;
+        uint8_t retries = 0;
+    } T_MISSION_REQUEST;
+
+
+/**
+ * @brief called when a read or write of a mission type finishes.
+ * 
+ * @param result MAV_MISSION_RESULT. MAV_MISSION_ACCEPTED if succeeded.
+ * @param mavlink_mission items read or written.
+ */
+typedef std::function<void (const int result, const std::map <int, mavlink_mission_item_int_t>& mavlink_mission)> MISSION_TRANSFER_CALLBACK;
+
+
+/**
+ * @brief read or write waiting for active transfer to finish.
+ *
+ */
+typedef struct T_MISSION_TRANSFER {
+        bool write = false;
+        MAV_MISSION_TYPE mission_type = MAV_MISSION_TYPE_MISSION;
+        std::map <int, mavlink_mission_item_int_t> mavlink_mission;
+        MISSION_TRANSFER_CALLBACK callback;
+    } T_MISSION_TRANSFER;
+
+
+/**
+ * @brief items of a mission type with the opaque_id reported by autopilot for them.
+ *
+ */
+typedef struct T_MISSION_CACHE {
+        bool valid = false;
+        uint32_t opaque_id = 0;
+        std::map <int, mavlink_mission_item_int_t> items;
+    } T_MISSION_CACHE;
+
 
 /**
  * @brief This class manages waypoints
@@ -28,6 +95,8 @@ class CCallBack_WayPoint
 
     virtual void OnWaypointReached(const int& sequence)                                                             {};
     virtual void OnWayPointsLoadingCompleted()                                                                      {}; 
+    virtual void OnWayPointsLoadingProgress (const uint16_t& received, const uint16_t& count)                       {};
+    virtual void OnWayPointsLoadingFailed ()                                                                        {};
     virtual void OnMissionACK (const int& result, const int& mission_type, const std::string& result_msg)           {};
     virtual void OnMissionSaveFinished (const int& result, const int& mission_type, const std::string& result_msg)  {};
     virtual void OnWayPointReceived (const mavlink_mission_item_int_t& mission_item_int)                            {};
@@ -74,25 +143,86 @@ class CMavlinkWayPointManager
         
     
         void setCallbackWaypoint (mavlinksdk::CCallBack_WayPoint* callback_waypoint);
-        inline const mavlink_mission_current_t getMissionCurrent () const { return m_mission_current;}
-        inline const mavlink_mission_count_t getMissionCount () const { return m_mission_count;}
+        inline const mavlink_mission_current_t getMissionCurrent () const { const std::lock_guard<std::recursive_mutex> lock(m_lock); return m_mission_current;}
+        inline const mavlink_mission_count_t getMissionCount () const { const std::lock_guard<std::recursive_mutex> lock(m_lock); return m_mission_count;}
+        inline const bool isReadingWayPoints () const { const std::lock_guard<std::recursive_mutex> lock(m_lock); return (m_state == WAYPOINT_STATE_READ_REQUEST) && (m_read_mission_type == MAV_MISSION_TYPE_MISSION);}
+        
+        /**
+         * @brief number of MISSION_REQUEST_INT kept in flight while reading mission.
+         * 1 restores item by item reading. If not set ArduPilot uses MISSION_READ_WINDOW_ARDUPILOT
+         * and other autopilots MISSION_READ_WINDOW_DEFAULT.
+         */
+        void setReadWindow (const uint16_t window);
         
 
     public:
 
             void reloadWayPoints();
             void clearWayPoints();
-            void saveWayPoints (std::map <int, mavlink_mission_item_int_t> mavlink_mission, const MAV_MISSION_TYPE& mission_type);
+            /**
+             * @brief upload items of mission_type. Transfers are queued while another read or write is active.
+             * 
+             * @param callback if set it is called instead of CCallBack_WayPoint events.
+             */
+            void saveWayPoints (const std::map <int, mavlink_mission_item_int_t>& mavlink_mission, const MAV_MISSION_TYPE& mission_type, MISSION_TRANSFER_CALLBACK callback = nullptr);
+            
+            /**
+             * @brief download items of mission_type. reloadWayPoints is a read of MAV_MISSION_TYPE_MISSION
+             * that reports through CCallBack_WayPoint.
+             * 
+             * @param callback if set it is called instead of CCallBack_WayPoint events.
+             */
+            void readWayPoints (const MAV_MISSION_TYPE& mission_type, MISSION_TRANSFER_CALLBACK callback);
+            
+            static bool isSameMissionItem (const mavlink_mission_item_int_t& item1, const mavlink_mission_item_int_t& item2);
+            
+            /**
+             * @brief true if mission on vehicle is known i.e. read or written successfully.
+             * 
+             */
+            inline const bool isVehicleMissionKnown () const { const std::lock_guard<std::recursive_mutex> lock(m_lock); return m_vehicle_mission_valid;}
+
+
+            /**
+             * @brief cache mission, fence & rally items in folder with their opaque_id.
+             * Mission reads are served from cache while opaque_id reported in MISSION_CURRENT is unchanged.
+             * 
+             * @param folder empty string disables cache.
+             */
+            void enableCache (const std::string& folder);
+
+            /**
+             * @brief items of mission type if they are known to match the vehicle.
+             * 
+             * @return false if not cached or opaque_id has changed.
+             */
+            bool getCachedMission (const MAV_MISSION_TYPE& mission_type, std::map <int, mavlink_mission_item_int_t>& mavlink_mission);
 
-            void handle_mission_ack   (const mavlink_mission_ack_t& mission_ack);
-            void handle_mission_count (const mavlink_mission_count_t& mission_count);
-            void handle_mission_current   (const mavlink_mission_current_t& mission_current);
+            void handle_mission_ack   (const mavlink_mission_ack_t& mission_ack, const uint32_t opaque_id = 0);
+            void handle_mission_count (const mavlink_mission_count_t& mission_count, const uint32_t opaque_id = 0);
+            void handle_mission_current   (const mavlink_mission_current_t& mission_current, const uint32_t mission_id = 0, const uint32_t fence_id = 0, const uint32_t rally_id = 0);
             void handle_mission_item (const mavlink_message_t& mavlink_message); //const mavlink_mission_item_int_t& mission_item_int);
             void handle_mission_item_reached (const mavlink_mission_item_reached_t& mission_item_reached);
             void handle_mission_item_request (const mavlink_mission_request_int_t& mission_request_int);
             void handle_mission_item_request (const mavlink_mission_request_t& mission_request);
 
+            void checkMissionRequests ();
+
     protected:
+            uint16_t getReadWindow () const;
+            void fillReadWindow ();
+            void finishRead (const bool success);
+            void startRead (const MAV_MISSION_TYPE& mission_type, MISSION_TRANSFER_CALLBACK callback);
+            void startWrite (const std::map <int, mavlink_mission_item_int_t>& mavlink_mission, const MAV_MISSION_TYPE& mission_type, MISSION_TRANSFER_CALLBACK callback);
+            void startNextTransfer ();
+            bool buildWriteRanges (const std::map <int, mavlink_mission_item_int_t>& mavlink_mission);
+            void writeNextRange ();
+            bool finishWrite (const mavlink_mission_ack_t& mission_ack, const uint32_t opaque_id);
+            bool readFromCache ();
+            void updateCache (const uint8_t mission_type, const uint32_t opaque_id, const std::map <int, mavlink_mission_item_int_t>& mavlink_mission);
+            const std::string getCacheFileName (const uint8_t mission_type) const;
+            void loadCache ();
+            void saveCache (const uint8_t mission_type) const;
             void writeMissionItems ();  
             void writeMissionItem(mavlink_mission_item_int_t& mission_item_int);
 
@@ -107,7 +237,50 @@ class CMavlinkWayPointManager
         uint16_t  m_mission_waiting_for_seq   = 0;
         std::map <int, mavlink_mission_item_int_t> m_mavlink_mission;
 
+        // mission read state.
+        std::vector<bool> m_mission_read_received;
+        uint16_t m_mission_read_received_count = 0;
+        uint16_t m_mission_read_next_seq = 0;                           // first seq that has never been requested.
+        std::map<uint16_t, T_MISSION_REQUEST> m_mission_read_requests;  // seq -> outstanding request.
+        T_MISSION_REQUEST m_mission_list_request;                       // outstanding MISSION_REQUEST_LIST till MISSION_COUNT.
+        uint64_t m_mission_read_deadline = 0;
+        uint16_t m_mission_read_window = 0;                             // 0 if not set by setReadWindow.
+        uint16_t m_mission_read_count = 0;                              // count in MISSION_COUNT of active read.
+        MAV_MISSION_TYPE m_read_mission_type = MAV_MISSION_TYPE_MISSION;
+        std::map <int, mavlink_mission_item_int_t> m_read_items;
+        MISSION_TRANSFER_CALLBACK m_read_callback;
+
+        // copy of mission on vehicle. It is compared with new missions to upload changed items only.
+        std::map <int, mavlink_mission_item_int_t> m_vehicle_mission;
+        bool m_vehicle_mission_valid = false;
+        uint16_t m_vehicle_mission_total = 0;                           // MISSION_CURRENT.total when copy is valid. 0 if not known yet.
+
+        // mission write state.
+        MAV_MISSION_TYPE m_write_mission_type = MAV_MISSION_TYPE_MISSION;
+        std::vector<std::pair<uint16_t, uint16_t>> m_write_ranges;      // [start, end] ranges written by MISSION_WRITE_PARTIAL_LIST. empty for full upload.
+        std::size_t m_write_range_index = 0;
+        MISSION_TRANSFER_CALLBACK m_write_callback;
+        uint64_t m_write_activity_time = 0;
+
+        std::deque<T_MISSION_TRANSFER> m_transfer_queue;
+
+        // opaque_id of mission, fence & rally reported by MISSION_CURRENT. 0 if not supported.
+        uint32_t m_vehicle_opaque_id[MISSION_CACHE_TYPES] = {0};
+        uint32_t m_mission_read_opaque_id = 0;                          // opaque_id in MISSION_COUNT of active read.
+
+        // mission cache.
+        std::string m_cache_folder;
+        int m_cache_sysid = -1;                                         // sysid of vehicle whose cache files are loaded.
+        T_MISSION_CACHE m_mission_cache[MISSION_CACHE_TYPES];
+
         int m_state = WAYPOINT_STATE_IDLE;
+
+        /**
+         * @brief guards transfer state. Transfers are started from caller thread and driven by parser thread.
+         * Recursive as transfer callbacks may start a new transfer.
+         *
+         */
+        mutable std::recursive_mutex m_lock;
         
       
 };
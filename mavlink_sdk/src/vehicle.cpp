@@ -8,8 +8,13 @@
 #include "./helpers/utils.h"
 #include "vehicle.h"
 #include "mavlink_command.h"
+#include "mavlink_command_engine.h"
+#include "mavlink_helper.h"
 #include "mavlink_waypoint_manager.h"
 #include "mavlink_parameter_manager.h"
+#include "mavlink_ftp_manager.h"
+#include "mavlink_log_manager.h"
+#include "mavlink_remote_log_receiver.h"
 
 
 mavlinksdk::CVehicle::CVehicle()
@@ -86,6 +91,7 @@ bool mavlinksdk::CVehicle::handle_heart_beat (const mavlink_heartbeat_t& heartbe
 		mavlinksdk::CMavlinkCommand::getInstance().requestDataStream(MAV_DATA_STREAM::MAV_DATA_STREAM_EXTRA1);
 		mavlinksdk::CMavlinkCommand::getInstance().requestDataStream(MAV_DATA_STREAM::MAV_DATA_STREAM_EXTRA2);
 		mavlinksdk::CMavlinkCommand::getInstance().requestDataStream(MAV_DATA_STREAM::MAV_DATA_STREAM_EXTRA3);
+		mavlinksdk::CMavlinkCommand::getInstance().requestMessageEmit(MAVLINK_MSG_ID_AUTOPILOT_VERSION);
 	}
 	else 
 	if ((now - time_stamps.getMessageTime(MAVLINK_MSG_ID_HEARTBEAT)) > HEART_BEAT_TIMEOUT)
@@ -421,6 +427,10 @@ void mavlinksdk::CVehicle::parseMessage (const mavlink_message_t& mavlink_messag
 
 	mavlink_message_temp = mavlink_message;
 
+	// incoming traffic drives parameter & mission request timeouts while loading.
+	mavlinksdk::CMavlinkParameterManager::getInstance().checkParameterRequests();
+	mavlinksdk::CMavlinkWayPointManager::getInstance().checkMissionRequests();
+
 	switch (mavlink_message.msgid)
 	{
         case MAVLINK_MSG_ID_HEARTBEAT:
@@ -486,6 +496,14 @@ void mavlinksdk::CVehicle::parseMessage (const mavlink_message_t& mavlink_messag
 		}
 		break;
 
+		case MAVLINK_MSG_ID_AUTOPILOT_VERSION:
+		{
+			mavlink_msg_autopilot_version_decode(&mavlink_message, &(m_autopilot_version));
+
+			mavlinksdk::CMavlinkParameterManager::getInstance().handle_autopilot_version (m_autopilot_version);
+		}
+		break;
+
         case MAVLINK_MSG_ID_WIND:
 		{
 			mavlink_msg_wind_decode(&mavlink_message, &(m_wind));
@@ -627,6 +645,7 @@ void mavlinksdk::CVehicle::parseMessage (const mavlink_message_t& mavlink_messag
 			mavlink_command_ack_t command_ack;
 			
 			mavlink_msg_command_ack_decode(&mavlink_message, &command_ack);
+			mavlinksdk::CMavlinkCommandEngine::getInstance().handle_cmd_ack(mavlink_message.sysid, mavlink_message.compid, command_ack);
 			handle_cmd_ack(command_ack);
 
 		}
@@ -681,6 +700,42 @@ void mavlinksdk::CVehicle::parseMessage (const mavlink_message_t& mavlink_messag
 		}
 		break;
 		
+		case MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL:
+		{
+			mavlink_file_transfer_protocol_t file_transfer_protocol;
+			mavlink_msg_file_transfer_protocol_decode(&mavlink_message, &file_transfer_protocol);
+
+			mavlinksdk::CMavlinkFTPManager::getInstance().handle_file_transfer_protocol (file_transfer_protocol);
+		}
+		break;
+
+		case MAVLINK_MSG_ID_LOG_ENTRY:
+		{
+			mavlink_log_entry_t log_entry;
+			mavlink_msg_log_entry_decode(&mavlink_message, &log_entry);
+
+			mavlinksdk::CMavlinkLogManager::getInstance().handle_log_entry (log_entry);
+		}
+		break;
+
+		case MAVLINK_MSG_ID_LOG_DATA:
+		{
+			mavlink_log_data_t log_data;
+			mavlink_msg_log_data_decode(&mavlink_message, &log_data);
+
+			mavlinksdk::CMavlinkLogManager::getInstance().handle_log_data (log_data);
+		}
+		break;
+
+		case MAVLINK_MSG_ID_REMOTE_LOG_DATA_BLOCK:
+		{
+			mavlink_remote_log_data_block_t remote_log_data_block;
+			mavlink_msg_remote_log_data_block_decode(&mavlink_message, &remote_log_data_block);
+
+			mavlinksdk::CMavlinkRemoteLogReceiver::getInstance().handle_remote_log_data_block (remote_log_data_block);
+		}
+		break;
+
 		case MAVLINK_MSG_ID_ADSB_VEHICLE:
 		{
 			mavlink_adsb_vehicle_t adsb_vehicle;
@@ -730,7 +785,7 @@ void mavlinksdk::CVehicle::parseMessage (const mavlink_message_t& mavlink_messag
             mavlink_mission_count_t mission_count;
             mavlink_msg_mission_count_decode (&mavlink_message, &mission_count);
 
-            mavlinksdk::CMavlinkWayPointManager::getInstance().handle_mission_count (mission_count);
+            mavlinksdk::CMavlinkWayPointManager::getInstance().handle_mission_count (mission_count, mavlinksdk::CMavlinkHelper::getExtensionUInt32(mavlink_message, MISSION_COUNT_OPAQUE_ID_OFFSET));
         }
         break;
         
@@ -739,7 +794,10 @@ void mavlinksdk::CVehicle::parseMessage (const mavlink_message_t& mavlink_messag
             mavlink_mission_current_t mission_current;
             mavlink_msg_mission_current_decode (&mavlink_message, &mission_current);
 
-            mavlinksdk::CMavlinkWayPointManager::getInstance().handle_mission_current (mission_current);
+            mavlinksdk::CMavlinkWayPointManager::getInstance().handle_mission_current (mission_current,
+                mavlinksdk::CMavlinkHelper::getExtensionUInt32(mavlink_message, MISSION_CURRENT_MISSION_ID_OFFSET),
+                mavlinksdk::CMavlinkHelper::getExtensionUInt32(mavlink_message, MISSION_CURRENT_FENCE_ID_OFFSET),
+                mavlinksdk::CMavlinkHelper::getExtensionUInt32(mavlink_message, MISSION_CURRENT_RALLY_ID_OFFSET));
         }
         break;
 
@@ -748,7 +806,7 @@ void mavlinksdk::CVehicle::parseMessage (const mavlink_message_t& mavlink_messag
 			mavlink_mission_ack_t mission_ack;
 			mavlink_msg_mission_ack_decode(&mavlink_message, &mission_ack);
 
-			mavlinksdk::CMavlinkWayPointManager::getInstance().handle_mission_ack(mission_ack);
+			mavlinksdk::CMavlinkWayPointManager::getInstance().handle_mission_ack(mission_ack, mavlinksdk::CMavlinkHelper::getExtensionUInt32(mavlink_message, MISSION_ACK_OPAQUE_ID_OFFSET));
 		}
         break;
 
@@ -367,6 +367,11 @@ namespace mavlinksdk
                 return m_flight_information;
             }
 
+            inline const mavlink_autopilot_version_t& getMsgAutopilotVersion () const
+            {
+                return m_autopilot_version;
+            }
+
             inline const std::string& getLastStatusText () const
             {
                 return m_status_text;
@@ -435,6 +440,9 @@ namespace mavlinksdk
 
 
             mavlink_flight_information_t m_flight_information;
+
+            // Autopilot Version
+            mavlink_autopilot_version_t m_autopilot_version = {0};
             
             // High Latency
             int m_high_latency_mode = 0; // either equal to MAVLINK_MSG_ID_HIGH_LATENCY or MAVLINK_MSG_ID_HIGH_LATENCY2 or 0
@@ -0,0 +1,266 @@
+/**
+ * @brief loads parameters from a simulated FCB over a lossy link.
+ * @details The simulated FCB rejects MAVLink FTP, drops a share of PARAM_VALUE replies and
+ * never answers some indices for longer than their retries. Test passes when all parameters
+ * are loaded, dropped indices are recovered in later passes and RTO does not hit its cap.
+ *
+ */
+#include <iostream>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <chrono>
+
+#include <mavlink_sdk.h>
+#include <mavlink_events.h>
+#include <mavlink_parameter_manager.h>
+#include <mavlink_ftp_manager.h>
+
+
+#define FCB_SYSID               1
+#define FCB_COMPID              1
+#define GCS_SYSID               255
+
+#define PARAM_COUNT             300
+#define PARAM_LOSS              0.3         // share of PARAM_VALUE replies that are lost.
+#define PARAM_LATENCY           20000       // usec
+#define HEARTBEAT_PERIOD        200000      // usec
+#define TEST_TIMEOUT            60000000    // usec
+
+// indices that ignore requests more than PARAM_REQUEST_MAX_RETRIES times so they are dropped once.
+static const uint16_t BLACK_HOLE_INDICES[] = {5, 17, 250};
+#define BLACK_HOLE_REQUESTS     (2 * (PARAM_REQUEST_MAX_RETRIES + 1))
+
+
+static uint64_t now_usec ()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+/**
+ * @brief simulated FCB. Messages written by SDK are answered into a delayed queue read by SDK.
+ *
+ */
+class CLossyFCBPort : public mavlinksdk::comm::GenericPort
+{
+	public:
+
+		int read_message (mavlink_message_t &message) override
+		{
+			{
+				const std::lock_guard<std::mutex> lock(m_lock);
+				const uint64_t now = now_usec();
+
+				if ((now - m_last_heartbeat) >= HEARTBEAT_PERIOD)
+				{
+					m_last_heartbeat = now;
+					mavlink_heartbeat_t heartbeat = {0};
+					heartbeat.type = MAV_TYPE_QUADROTOR;
+					heartbeat.autopilot = MAV_AUTOPILOT_ARDUPILOTMEGA;
+					heartbeat.mavlink_version = 3;
+					mavlink_msg_heartbeat_encode(FCB_SYSID, FCB_COMPID, &message, &heartbeat);
+					return 1;
+				}
+
+				if ((!m_replies.empty()) && (m_replies.front().first <= now))
+				{
+					message = m_replies.front().second;
+					m_replies.pop_front();
+					return 1;
+				}
+			}
+
+			std::this_thread::sleep_for(std::chrono::microseconds(500));
+			return 0;
+		}
+
+		int write_message (const mavlink_message_t &message) override
+		{
+			const std::lock_guard<std::mutex> lock(m_lock);
+			const uint64_t now = now_usec();
+
+			switch (message.msgid)
+			{
+				case MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL:
+				{
+					// no FTP support. SDK falls back to PARAM_REQUEST_LIST.
+					mavlink_file_transfer_protocol_t request;
+					mavlink_msg_file_transfer_protocol_decode(&message, &request);
+
+					mavlink_file_transfer_protocol_t reply = {0};
+					reply.target_system = GCS_SYSID;
+					uint16_t seq_number;
+					memcpy(&seq_number, &request.payload[0], sizeof(uint16_t));
+					seq_number++;
+					memcpy(&reply.payload[0], &seq_number, sizeof(uint16_t));
+					reply.payload[3] = (uint8_t) mavlinksdk::FTP_OP::Nack;
+					reply.payload[4] = 1;
+					reply.payload[5] = request.payload[3];
+					reply.payload[12] = (uint8_t) mavlinksdk::FTP_ERROR::UnknownCommand;
+
+					mavlink_message_t reply_message;
+					mavlink_msg_file_transfer_protocol_encode(FCB_SYSID, FCB_COMPID, &reply_message, &reply);
+					m_replies.push_back(std::make_pair(now + PARAM_LATENCY, reply_message));
+				}
+				break;
+
+				case MAVLINK_MSG_ID_PARAM_REQUEST_LIST:
+				{
+					m_list_requests++;
+					for (uint16_t i = 0; i < PARAM_COUNT; ++i)
+					{
+						queueParameter(i, now + PARAM_LATENCY + i * 1000);
+					}
+				}
+				break;
+
+				case MAVLINK_MSG_ID_PARAM_REQUEST_READ:
+				{
+					mavlink_param_request_read_t request;
+					mavlink_msg_param_request_read_decode(&message, &request);
+					if ((request.param_index < 0) || (request.param_index >= PARAM_COUNT)) break;
+
+					m_read_requests++;
+					if (isBlackHole(request.param_index)) break;
+					queueParameter(request.param_index, now + PARAM_LATENCY);
+				}
+				break;
+			}
+
+			return message.len;
+		}
+
+		bool is_running () override
+		{
+			return true;
+		}
+
+		void start () override
+		{
+		}
+
+		void stop () override
+		{
+		}
+
+	public:
+
+		uint32_t m_list_requests = 0;
+		uint32_t m_read_requests = 0;
+
+	protected:
+
+		bool isBlackHole (const uint16_t param_index)
+		{
+			for (std::size_t i = 0; i < sizeof(BLACK_HOLE_INDICES) / sizeof(BLACK_HOLE_INDICES[0]); ++i)
+			{
+				if (BLACK_HOLE_INDICES[i] != param_index) continue;
+				if (m_black_hole_requests[i] >= BLACK_HOLE_REQUESTS) return false;
+				m_black_hole_requests[i]++;
+				return true;
+			}
+
+			return false;
+		}
+
+		void queueParameter (const uint16_t param_index, const uint64_t due_time)
+		{
+			// black hole indices are also lost from full list.
+			for (const uint16_t index : BLACK_HOLE_INDICES)
+			{
+				if ((index == param_index) && (m_list_requests > 0) && (m_read_requests == 0)) return ;
+			}
+
+			if (m_loss(m_random)) return ;
+
+			mavlink_param_value_t param_value = {0};
+			snprintf(param_value.param_id, sizeof(param_value.param_id), "PARAM_%u", param_index);
+			param_value.param_value = param_index;
+			param_value.param_type = MAV_PARAM_TYPE_REAL32;
+			param_value.param_count = PARAM_COUNT;
+			param_value.param_index = param_index;
+
+			mavlink_message_t message;
+			mavlink_msg_param_value_encode(FCB_SYSID, FCB_COMPID, &message, &param_value);
+
+			// keep queue ordered by due time.
+			auto it = m_replies.end();
+			while ((it != m_replies.begin()) && ((it - 1)->first > due_time)) --it;
+			m_replies.insert(it, std::make_pair(due_time, message));
+		}
+
+	protected:
+
+		std::mutex m_lock;
+		std::deque<std::pair<uint64_t, mavlink_message_t>> m_replies;
+		uint64_t m_last_heartbeat = 0;
+		uint32_t m_black_hole_requests[sizeof(BLACK_HOLE_INDICES) / sizeof(BLACK_HOLE_INDICES[0])] = {0};
+		std::mt19937 m_random{1};
+		std::bernoulli_distribution m_loss{PARAM_LOSS};
+};
+
+
+class CTestEvents : public mavlinksdk::CMavlinkEvents
+{
+};
+
+
+int main ()
+{
+	std::shared_ptr<CLossyFCBPort> port = std::make_shared<CLossyFCBPort>();
+	CTestEvents events;
+
+	mavlinksdk::CMavlinkSDK& mavlink_sdk = mavlinksdk::CMavlinkSDK::getInstance();
+	mavlinksdk::CMavlinkParameterManager& parameter_manager = mavlinksdk::CMavlinkParameterManager::getInstance();
+	mavlink_sdk.connectPort(port);
+	mavlink_sdk.start(&events);
+
+	const uint64_t start_time = now_usec();
+	uint64_t max_request_timeout = 0;
+	while ((!parameter_manager.isParametersListAvailable()) && ((now_usec() - start_time) < TEST_TIMEOUT))
+	{
+		if (parameter_manager.getRequestTimeout() > max_request_timeout)
+		{
+			max_request_timeout = parameter_manager.getRequestTimeout();
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	const uint64_t duration = now_usec() - start_time;
+	int failures = 0;
+
+	if (!parameter_manager.isParametersListAvailable())
+	{
+		std::cout << "FAIL: parameters are not loaded after " << duration / 1000 << " ms" << std::endl;
+		failures++;
+	}
+
+	for (uint16_t i = 0; i < PARAM_COUNT; ++i)
+	{
+		const mavlink_param_value_t* parameter = parameter_manager.findParameter(i);
+		if ((parameter == nullptr) || (parameter->param_value != i))
+		{
+			std::cout << "FAIL: parameter index " << i << " is missing or wrong" << std::endl;
+			failures++;
+			break;
+		}
+	}
+
+	if (max_request_timeout >= PARAM_REQUEST_RTO_MAX)
+	{
+		std::cout << "FAIL: RTO reached its cap " << max_request_timeout << " usec" << std::endl;
+		failures++;
+	}
+
+	std::cout << "loaded " << PARAM_COUNT << " parameters in " << duration / 1000 << " ms"
+		<< " list requests: " << port->m_list_requests
+		<< " index requests: " << port->m_read_requests
+		<< " max RTO: " << max_request_timeout << " usec" << std::endl;
+
+	// singletons own running threads. skip their destruction.
+	std::cout.flush();
+	std::quick_exit(failures == 0 ? 0 : 1);
+}
@@ -37,9 +37,18 @@ try
                             // check if I am waiting for event.
                             if (validateField(module_mission_item,WAITING_EVENT,Json_de::value_t::string))
                             {
-                                std::string de_event_id = module_mission_item[WAITING_EVENT].get<std::string>();
-                                module_mission_item_single_command[WAITING_EVENT] = de_event_id;
-                                addModuleMissionItemByEvent (de_event_id, module_mission_item_single_command);
+                                const std::string de_event_sid = module_mission_item[WAITING_EVENT].get<std::string>();
+                                module_mission_item_single_command[WAITING_EVENT] = de_event_sid;
+                                
+                                int de_event_id;
+                                if (toEventID(de_event_sid, de_event_id))
+                                {
+                                    addModuleMissionItemByEvent (de_event_id, module_mission_item_single_command);
+                                }
+                                else
+                                {
+                                    std::cout << _ERROR_CONSOLE_TEXT_ << "Invalid waiting event: " << de_event_sid << _NORMAL_CONSOLE_TEXT_ << std::endl;
+                                }
                             }
                             std::cout << "module_mission_item_single_command:" << module_mission_item_single_command.dump() << std::endl; 
 
@@ -63,10 +72,16 @@ try
 
 void CMissionManagerBase::deEventFiredExternally (const std::string de_event_sid)
 {
-    if (m_module_missions_by_de_events.find(de_event_sid) != m_module_missions_by_de_events.end()) 
+    int de_event_id;
+    if (!toEventID(de_event_sid, de_event_id)) return ;
+    
+    const auto commands = m_module_missions_by_de_events.find(de_event_id);
+    if (commands != m_module_missions_by_de_events.end()) 
     {
-        const Json_de cmd = m_module_missions_by_de_events[de_event_sid];
-        std::cout << "deEventFiredExternally:" << cmd.dump() << std::endl;
+        for (const Json_de& cmd : commands->second)
+        {
+            std::cout << "deEventFiredExternally:" << cmd.dump() << std::endl;
+        }
     }
 
     return ; 
@@ -2,6 +2,10 @@
 #define MISSION_MANAGER_BASE_H_
 
 
+#include <cstdlib>
+#include <vector>
+#include <unordered_map>
+
 #include "../de_common/helpers/json_nlohmann.hpp"
 using Json_de = nlohmann::json;
 
@@ -64,10 +68,27 @@ namespace mission
             }
 
             
-            inline void addModuleMissionItemByEvent(std::string de_event_sid, Json_de item) {
-                // Move the unique_ptr into the map
-                m_module_missions_by_de_events[de_event_sid] = item;
+            inline void addModuleMissionItemByEvent(const int de_event_id, const Json_de& item) {
+                // an event may release more than one command.
+                m_module_missions_by_de_events[de_event_id].push_back(item);
+                
+            }
+
+            /**
+             * @brief events are servo PWM values sent as strings. They are parsed once into integer ids.
+             * 
+             * @return false if de_event_sid is not an integer.
+             */
+            static inline bool toEventID (const std::string& de_event_sid, int& de_event_id)
+            {
+                if (de_event_sid.empty()) return false;
                 
+                char* end;
+                const long value = strtol(de_event_sid.c_str(), &end, 10);
+                if (*end != '\0') return false;
+                
+                de_event_id = (int) value;
+                return true;
             }
 
             
@@ -87,7 +108,12 @@ namespace mission
         protected:
 
             std::map <std::string, Json_de> m_module_missions; // = std::map <int, std::unique_ptr<Json_de>> (new std::map <int, std::unique_ptr<Json_de>>);
-            std::map <std::string, Json_de> m_module_missions_by_de_events;
+            
+            /**
+             * @brief event id -> module commands waiting for it.
+             * 
+             */
+            std::unordered_map <int, std::vector<Json_de>> m_module_missions_by_de_events;
     };
 
 }
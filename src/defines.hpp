@@ -18,6 +18,14 @@
 // 3 seconds timeout
 #define RCCHANNEL_OVERRIDES_TIMEOUT 3000000 
 #define BLOCKING_CHANNEL_HIGH_ACTIVE_PWM 1800
+// joystick in guided mode is streamed to FCB at this rate. vehicle brakes if GCS stops updating for RC_GUIDED_SETPOINT_TIMEOUT usec.
+#define RC_GUIDED_SETPOINT_RATE     10
+#define RC_GUIDED_SETPOINT_TIMEOUT  1000000
+
+// min groundspeed in m/s used to calculate ETA.
+#define MISSION_PROGRESS_MIN_SPEED 0.5
+// max mission fence violations listed to GCS after mission or fence change.
+#define MAX_REPORTED_MISSION_VIOLATIONS 5
 
 typedef enum ANDRUAV_UNIT_TYPE
 {
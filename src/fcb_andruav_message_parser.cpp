@@ -1,5 +1,6 @@
 #include <iostream>
 #include "defines.hpp"
+#include <mavlink_setpoint_channel.h>
 #include <plog/Log.h>
 #include "plog/Initializers/RollingFileInitializer.h"
 
@@ -247,7 +248,7 @@ void CFCBAndruavMessageParser::parseMessage(Json_de &andruav_message, const char
                 }
             }
 
-            mavlinksdk::CMavlinkCommand::getInstance().gotoGuidedPoint(latitude, longitude, altitude / 1000.0);
+            mavlinksdk::CMavlinkSetpointChannel::getInstance().gotoGuidedPoint(latitude, longitude, altitude / 1000.0);
             CFCBFacade::getInstance().sendFCBTargetLocation(andruav_message[ANDRUAV_PROTOCOL_SENDER].get<std::string>(), latitude, longitude, altitude, DESTINATION_GUIDED_POINT);
         }
         break;
@@ -313,7 +314,7 @@ void CFCBAndruavMessageParser::parseMessage(Json_de &andruav_message, const char
             bool is_clock_wise = cmd["C"].get<bool>();
             bool is_relative = cmd["L"].get<bool>();
 
-            mavlinksdk::CMavlinkCommand::getInstance().setYawCondition(target_angle, turn_rate, is_clock_wise, is_relative);
+            mavlinksdk::CMavlinkSetpointChannel::getInstance().setYawCondition(target_angle, turn_rate, is_clock_wise, is_relative);
         }
         break;
 
@@ -348,7 +349,7 @@ void CFCBAndruavMessageParser::parseMessage(Json_de &andruav_message, const char
 
             const int speed_type = is_ground_speed ? 1 : 0;
 
-            mavlinksdk::CMavlinkCommand::getInstance().setNavigationSpeed(speed_type, speed, throttle, is_relative);
+            mavlinksdk::CMavlinkSetpointChannel::getInstance().setNavigationSpeed(speed_type, speed, throttle, is_relative);
         }
         break;
 
@@ -434,6 +435,7 @@ void CFCBAndruavMessageParser::parseMessage(Json_de &andruav_message, const char
             std::unique_ptr<geofence::CGeoFenceBase> fence = geofence::CGeoFenceFactory::getInstance().getGeoFenceObject(cmd);
             geofence::CGeoFenceManager::getInstance().addFence(std::move(fence));
             geofence::CGeoFenceManager::getInstance().attachToGeoFence(m_fcbMain.getAndruavVehicleInfo().party_id, cmd["n"].get<std::string>());
+            geofence::CGeoFenceManager::getInstance().validateMission();
             // geofence::GEO_FENCE_STRUCT * fence_struct = geofence::CGeoFenceManager::getInstance().getFenceByName(message["n"].get<std::string>());
             // std::vector<geofence::GEO_FENCE_STRUCT*> fence_struct_vect = geofence::CGeoFenceManager::getInstance().getFencesOfParty (m_fcbMain.getAndruavVehicleInfo().party_id);
             // if (fence_struct!=NULL)
@@ -637,6 +639,7 @@ void CFCBAndruavMessageParser::parseMessage(Json_de &andruav_message, const char
 
             mavlink_status_t status;
             mavlink_message_t mavlink_message;
+            std::vector<mavlink_message_t> param_set_messages;
             for (int i = 0; i < binary_length; ++i)
             {
                 uint8_t msgReceived = mavlink_parse_char(MAVLINK_CHANNEL_INTERMODULE, binary_message[i + 1], &mavlink_message, &status);
@@ -661,11 +664,34 @@ void CFCBAndruavMessageParser::parseMessage(Json_de &andruav_message, const char
                             std::cout << _INFO_CONSOLE_BOLD_TEXT << "MAVLINK: " << _ERROR_CONSOLE_BOLD_TEXT_ << "Permission Denied " << _INFO_CONSOLE_TEXT << " - " << _ERROR_CONSOLE_BOLD_TEXT_ << permission << _NORMAL_CONSOLE_TEXT_ << std::endl;
                             return;
                         }
+                        if (((mavlink_message.msgid == MAVLINK_MSG_ID_LOG_REQUEST_LIST) || (mavlink_message.msgid == MAVLINK_MSG_ID_LOG_REQUEST_DATA))
+                            && (!m_fcbMain.getLogDownloadFolder().empty())
+                            && (validateField(andruav_message, ANDRUAV_PROTOCOL_SENDER, Json_de::value_t::string)))
+                        {
+                            downloadLog(andruav_message[ANDRUAV_PROTOCOL_SENDER].get<std::string>(), mavlink_message);
+                            break;
+                        }
+                        // integer values are cast to float by ArduPilot only. Others are forwarded unchanged.
+                        if ((mavlink_message.msgid == MAVLINK_MSG_ID_PARAM_SET)
+                            && (mavlinksdk::CVehicle::getInstance().getMsgHeartBeat().autopilot == MAV_AUTOPILOT_ARDUPILOTMEGA)
+                            && (mavlink_msg_param_set_get_target_system(&mavlink_message) == mavlinksdk::CVehicle::getInstance().getSysId())
+                            && ((mavlink_msg_param_set_get_target_component(&mavlink_message) == 0)
+                                || (mavlink_msg_param_set_get_target_component(&mavlink_message) == mavlinksdk::CVehicle::getInstance().getCompId())))
+                        {
+                            // written below as a batch.
+                            param_set_messages.push_back(mavlink_message);
+                            break;
+                        }
                         mavlinksdk::CMavlinkCommand::getInstance().sendNative(mavlink_message);
                         break;
                     }
                 }
             }
+
+            if (!param_set_messages.empty())
+            {
+                writeParameters(param_set_messages);
+            }
         }
 
             /**
@@ -886,6 +912,136 @@ void CFCBAndruavMessageParser::parseMessage(Json_de &andruav_message, const char
     }
 }
 
+/**
+ * @brief writes PARAM_SET received from GCS as one batch so each value is confirmed by FCB echo.
+ * @details Parameters that are not confirmed are reported to GCS. If a batch cannot start
+ * i.e. parameters are not loaded yet or another batch is active, messages are forwarded as is.
+ *
+ * @param param_set_messages
+ */
+void CFCBAndruavMessageParser::writeParameters(const std::vector<mavlink_message_t> &param_set_messages)
+{
+    std::vector<std::pair<std::string, float>> parameters;
+    for (const mavlink_message_t &mavlink_message : param_set_messages)
+    {
+        mavlink_param_set_t param_set;
+        mavlink_msg_param_set_decode(&mavlink_message, &param_set);
+
+        char param_id[MAVLINK_MSG_PARAM_SET_FIELD_PARAM_ID_LEN + 1] = {0};
+        memcpy(param_id, param_set.param_id, MAVLINK_MSG_PARAM_SET_FIELD_PARAM_ID_LEN);
+        parameters.push_back(std::make_pair(std::string(param_id), param_set.param_value));
+    }
+
+    const bool started = mavlinksdk::CMavlinkParameterManager::getInstance().writeParameters(parameters,
+        [](const std::vector<mavlinksdk::T_PARAM_WRITE_RESULT> &results, const uint64_t duration_us)
+        {
+            UNUSED(duration_us);
+
+            for (const mavlinksdk::T_PARAM_WRITE_RESULT &write_result : results)
+            {
+                if (write_result.result == mavlinksdk::PARAM_WRITE_CONFIRMED) continue;
+
+                CFCBFacade::getInstance().sendErrorMessage(std::string(), 0, ERROR_TYPE_LO7ETTA7AKOM, NOTIFICATION_TYPE_WARNING, "Parameter " + write_result.param_name + " is not set.");
+            }
+        });
+
+    if (started) return;
+
+    for (const mavlink_message_t &mavlink_message : param_set_messages)
+    {
+        mavlinksdk::CMavlinkCommand::getInstance().sendNative(mavlink_message);
+    }
+}
+
+/**
+ * @brief handles LOG_REQUEST_LIST & LOG_REQUEST_DATA from GCS when log_download_folder is set.
+ * @details Log list is sent back to GCS as LOG_ENTRY messages. Requested log is downloaded
+ * from FCB into log_download_folder and GCS is notified with the result.
+ *
+ * @param target_party_id GCS that sent the request.
+ * @param mavlink_message
+ */
+void CFCBAndruavMessageParser::downloadLog(const std::string &target_party_id, const mavlink_message_t &mavlink_message)
+{
+    mavlinksdk::CMavlinkLogManager &log_manager = mavlinksdk::CMavlinkLogManager::getInstance();
+
+    if (mavlink_message.msgid == MAVLINK_MSG_ID_LOG_REQUEST_LIST)
+    {
+        const bool started = log_manager.requestLogList(
+            [this, target_party_id](const mavlinksdk::LOG_RESULT result, const std::vector<mavlink_log_entry_t> &entries)
+            {
+                if (result != mavlinksdk::LOG_RESULT::Success)
+                {
+                    CFCBFacade::getInstance().sendErrorMessage(target_party_id, 0, ERROR_TYPE_LO7ETTA7AKOM, NOTIFICATION_TYPE_WARNING, "Cannot read log list.");
+                    return;
+                }
+
+                {
+                    const std::lock_guard<std::mutex> lock(m_log_entries_lock);
+                    m_log_entries = entries;
+                }
+
+                const int sys_id = mavlinksdk::CVehicle::getInstance().getSysId();
+                const int comp_id = mavlinksdk::CVehicle::getInstance().getCompId();
+                std::vector<mavlink_message_t> mavlink_messages(entries.size());
+                for (std::size_t i = 0; i < entries.size(); ++i)
+                {
+                    mavlink_msg_log_entry_encode(sys_id, comp_id, &mavlink_messages[i], &entries[i]);
+                }
+
+                CFCBFacade::getInstance().sendMavlinkData_Packed(target_party_id, mavlink_messages.data(), mavlink_messages.size(), false);
+            });
+
+        if (!started)
+        {
+            CFCBFacade::getInstance().sendErrorMessage(target_party_id, 0, ERROR_TYPE_LO7ETTA7AKOM, NOTIFICATION_TYPE_WARNING, "Log download is busy.");
+        }
+
+        return;
+    }
+
+    const uint16_t id = mavlink_msg_log_request_data_get_id(&mavlink_message);
+    uint32_t size = 0;
+    {
+        const std::lock_guard<std::mutex> lock(m_log_entries_lock);
+        for (const mavlink_log_entry_t &log_entry : m_log_entries)
+        {
+            if (log_entry.id == id) size = log_entry.size;
+        }
+    }
+
+    if (size == 0)
+    {
+        CFCBFacade::getInstance().sendErrorMessage(target_party_id, 0, ERROR_TYPE_LO7ETTA7AKOM, NOTIFICATION_TYPE_WARNING, "Log " + std::to_string(id) + " is not listed.");
+        return;
+    }
+
+    std::string log_file_path = m_fcbMain.getLogDownloadFolder();
+    if (log_file_path.back() != '/') log_file_path += "/";
+    log_file_path += "log_" + std::to_string(id) + ".bin";
+
+    const bool started = log_manager.downloadLog(id, size, log_file_path,
+        [target_party_id, id](const mavlinksdk::LOG_RESULT result, const std::string &file_path, const uint32_t size, const uint64_t duration_us)
+        {
+            UNUSED(size);
+            UNUSED(duration_us);
+
+            if (result == mavlinksdk::LOG_RESULT::Success)
+            {
+                CFCBFacade::getInstance().sendErrorMessage(target_party_id, 0, ERROR_TYPE_LO7ETTA7AKOM, NOTIFICATION_TYPE_INFO, "Log " + std::to_string(id) + " saved to " + file_path);
+            }
+            else
+            {
+                CFCBFacade::getInstance().sendErrorMessage(target_party_id, 0, ERROR_TYPE_LO7ETTA7AKOM, NOTIFICATION_TYPE_WARNING, "Log " + std::to_string(id) + " download failed.");
+            }
+        });
+
+    if (!started)
+    {
+        CFCBFacade::getInstance().sendErrorMessage(target_party_id, 0, ERROR_TYPE_LO7ETTA7AKOM, NOTIFICATION_TYPE_WARNING, "Log download is busy.");
+    }
+}
+
 /**
  * @brief part of parseMessage that is responsible only for
  * parsing remote execute command.
@@ -932,10 +1088,24 @@ void CFCBAndruavMessageParser::parseRemoteExecute(Json_de &andruav_message)
         break;
 
     case RemoteCommand_REQUEST_PARA_LIST:
+    {
         if (m_fcbMain.getAndruavVehicleInfo().is_gcs_blocked)
             break;
 
-        CFCBFacade::getInstance().sendParameterList(andruav_message[ANDRUAV_PROTOCOL_SENDER].get<std::string>());
+        // "v" & "e" optional: parameters version and epoch received previously. Only parameters changed after them are sent.
+        uint32_t since_version = 0;
+        uint32_t since_epoch = 0;
+        if (validateField(cmd, "v", Json_de::value_t::number_unsigned))
+        {
+            since_version = cmd["v"].get<uint32_t>();
+        }
+        if (validateField(cmd, "e", Json_de::value_t::number_unsigned))
+        {
+            since_epoch = cmd["e"].get<uint32_t>();
+        }
+
+        CFCBFacade::getInstance().sendParameterList(andruav_message[ANDRUAV_PROTOCOL_SENDER].get<std::string>(), since_version, since_epoch);
+    }
         break;
 
     case TYPE_AndruavMessage_HomeLocation:
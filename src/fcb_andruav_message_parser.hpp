@@ -1,8 +1,11 @@
 #ifndef FCB_ANDRUAV_MESSAGE_PARSER_H_
 #define FCB_ANDRUAV_MESSAGE_PARSER_H_
 
+#include <mutex>
+
 #include <mavlink_command.h>
 #include <mavlink_sdk.h>
+#include <mavlink_log_manager.h>
 
 
 #include "./de_common/helpers/json_nlohmann.hpp"
@@ -61,6 +64,8 @@ namespace fcb
             
         protected:
             void parseRemoteExecute (Json_de &andruav_message);
+            void writeParameters (const std::vector<mavlink_message_t> &param_set_messages);
+            void downloadLog (const std::string &target_party_id, const mavlink_message_t &mavlink_message);
    
 
         private:
@@ -69,6 +74,13 @@ namespace fcb
             mavlinksdk::CMavlinkSDK& m_mavlinksdk = mavlinksdk::CMavlinkSDK::getInstance();
             de::fcb::CFCBFacade& m_fcb_facade = de::fcb::CFCBFacade::getInstance();
             de::fcb::swarm::CSwarmManager& m_fcb_swarm_manager = de::fcb::swarm::CSwarmManager::getInstance();
+
+            /**
+             * @brief last log list received from FCB. LOG_REQUEST_DATA is matched against it for log size.
+             *
+             */
+            std::vector<mavlink_log_entry_t> m_log_entries;
+            std::mutex m_log_entries_lock;
     };
 
 }
@@ -453,49 +453,98 @@ void CFCBFacade::sendNavInfo(const std::string&target_party_id)  const
 }
 
 /**
- * @brief Send complete list of parameters in chunks.
+ * @brief encode parameters changed after since_version into chunks of MAVLink PARAM_VALUE messages.
  * 
- * @param target_party_id 
+ * @param since_version 0 for all parameters.
+ * @param chunks 
  */
-void CFCBFacade::sendParameterList (const std::string&target_party_id) const 
+void CFCBFacade::buildParameterChunks (const uint32_t since_version, std::vector<std::string>& chunks) const
 {
-    
-    
     const int sys_id = m_vehicle.getSysId();
     const int comp_id = m_vehicle.getCompId();
 
     mavlink_message_t mavlink_message;
-    	
-    mavlinksdk::CMavlinkParameterManager &parameter_manager =  mavlinksdk::CMavlinkParameterManager::getInstance();
-    if (!parameter_manager.isParametersListAvailable())
-    {
-        sendErrorMessage(std::string(), 0, ERROR_TYPE_LO7ETTA7AKOM, NOTIFICATION_TYPE_WARNING, std::string("Still Loading Parameters."));
-        return ;
-    }
-    const std::map<std::string, mavlink_param_value_t>& parameters_list = parameter_manager.getParametersList();
+    
+    const std::vector<mavlinksdk::T_PARAMETER_SLOT>& parameters_list = mavlinksdk::CMavlinkParameterManager::getInstance().getParametersList();
     
     char buf[600];
     unsigned total_length =0;
 
     for (auto it = parameters_list.begin(); it != parameters_list.end(); it++)
     {
-        mavlink_param_value_t param_message = it->second;
-        mavlink_msg_param_value_encode(sys_id, comp_id, &mavlink_message, &param_message);
+        if ((!it->valid) || (it->version <= since_version)) continue;
+        
+        mavlink_msg_param_value_encode(sys_id, comp_id, &mavlink_message, &it->message);
         unsigned len = mavlink_msg_to_send_buffer((uint8_t*)&buf[total_length], &mavlink_message);
         total_length += len;
 
-        std::cout << it->first << " len:" << std::to_string(len) << " value:" <<std::to_string(param_message.param_value) << std::endl;
-
         if (total_length > 500)
         {
-            m_module.sendBMSG (target_party_id, buf, total_length, TYPE_AndruavMessage_MAVLINK, false, Json_de());
+            chunks.push_back(std::string(buf, total_length));
             total_length = 0;
         }
     }
 
     if (total_length >0)
     {
-        m_module.sendBMSG (target_party_id, buf, total_length, TYPE_AndruavMessage_MAVLINK, false, Json_de());
+        chunks.push_back(std::string(buf, total_length));
+    }
+}
+
+
+/**
+ * @brief send parameters to GCS as PARAM_VALUE messages.
+ * @details full list is encoded once and cached till a parameter changes.
+ * Each chunk has fields "v" & "e" that are the parameters version and epoch. GCS can send them back to get only changed parameters.
+ * 
+ * @param target_party_id 
+ * @param since_version 0 or unknown version sends all parameters.
+ * @param since_epoch epoch of since_version. All parameters are sent if it is not the current epoch.
+ */
+void CFCBFacade::sendParameterList (const std::string&target_party_id, const uint32_t since_version, const uint32_t since_epoch) const 
+{
+    mavlinksdk::CMavlinkParameterManager &parameter_manager =  mavlinksdk::CMavlinkParameterManager::getInstance();
+    if (!parameter_manager.isParametersListAvailable())
+    {
+        sendErrorMessage(std::string(), 0, ERROR_TYPE_LO7ETTA7AKOM, NOTIFICATION_TYPE_WARNING, std::string("Still Loading Parameters."));
+        return ;
+    }
+    
+    const uint32_t version = parameter_manager.getParametersVersion();
+    const uint32_t epoch = parameter_manager.getParametersEpoch();
+    const Json_de message =
+    {
+        {"v", version},
+        {"e", epoch}
+    };
+
+    // version is from a previous run or store, or a full list is requested.
+    if ((since_version == 0) || (since_epoch != epoch) || (since_version > version))
+    {
+        std::lock_guard<std::mutex> guard(m_parameter_chunks_mutex);
+        
+        if ((m_parameter_chunks_version != version) || (m_parameter_chunks_epoch != epoch))
+        {
+            m_parameter_chunks.clear();
+            buildParameterChunks(0, m_parameter_chunks);
+            m_parameter_chunks_version = version;
+            m_parameter_chunks_epoch = epoch;
+        }
+
+        for (const std::string& chunk : m_parameter_chunks)
+        {
+            m_module.sendBMSG (target_party_id, chunk.c_str(), chunk.length(), TYPE_AndruavMessage_MAVLINK, false, message);
+        }
+
+        return ;
+    }
+
+    std::vector<std::string> chunks;
+    buildParameterChunks(since_version, chunks);
+    
+    for (const std::string& chunk : chunks)
+    {
+        m_module.sendBMSG (target_party_id, chunk.c_str(), chunk.length(), TYPE_AndruavMessage_MAVLINK, false, message);
     }
 }
 
@@ -638,8 +687,6 @@ void CFCBFacade::sendFCBTargetLocation(const std::string&target_party_id, const
 }
 
 
-std::mutex g_pages_mutex;
-
 /**
 * @details Chunked Waypoint version
 * In this version field "i" is mandatory
@@ -648,13 +695,10 @@ std::mutex g_pages_mutex;
 * "n" represents number of waypoint in the chunk.
 * waypoints are numbered zero-based in each chunk.
 */
-void CFCBFacade::sendWayPoints(const std::string&target_party_id) const
+std::shared_ptr<const std::vector<Json_de>> CFCBFacade::buildWayPointPages() const
 {
+    std::shared_ptr<std::vector<Json_de>> pages = std::make_shared<std::vector<Json_de>>();
 
-    
-    
-    std::lock_guard<std::mutex> guard(g_pages_mutex);
-    
     const mission::ANDRUAV_UNIT_MISSION& andruav_missions = de::fcb::mission::CMissionManager::getInstance().getAndruavMission(); 
     const std::size_t length = andruav_missions.mission_items.size();
     
@@ -666,25 +710,27 @@ void CFCBFacade::sendWayPoints(const std::string&target_party_id) const
             {"n", 0}
         };
 
-        m_module.sendJMSG (target_party_id, message, TYPE_AndruavMessage_WayPoints, false);
+        pages->push_back(message);
         
-        return ;
+        return pages;
     }
 
     //Note: you can put any  number here. as UDP connection now in de_common/de_databus handles chunks implicitly.
     #define MAX_WAYPOINT_CHUNK  20
 
+    pages->reserve((length + MAX_WAYPOINT_CHUNK - 1) / MAX_WAYPOINT_CHUNK);
+
+    // items are walked in seq order once instead of a lookup per item.
+    auto it = andruav_missions.mission_items.cbegin();
     for (int i=0; i< length; i+=MAX_WAYPOINT_CHUNK)
     {
         Json_de message;
         int lastsentIndex = 0;
-        for (int j =0; (j<MAX_WAYPOINT_CHUNK) && (j+i < length); ++j)
+        for (int j =0; (j<MAX_WAYPOINT_CHUNK) && (j+i < length); ++j, ++it)
         {
-            auto it = andruav_missions.mission_items.find(i+j);
             mission::CMissionItem *mi= it->second.get();
             
-            Json_de message_item = mi->getAndruavMission();
-            message[std::to_string(lastsentIndex)] = message_item;
+            message[std::to_string(lastsentIndex)] = mi->getAndruavMission();
             
             lastsentIndex++;   
         }
@@ -699,12 +745,49 @@ void CFCBFacade::sendWayPoints(const std::string&target_party_id) const
             message["i"] = WAYPOINT_CHUNK;
         }
 
-        m_module.sendJMSG (target_party_id, message, TYPE_AndruavMessage_WayPoints, false);
-        
+        pages->push_back(std::move(message));
     }
 
     #undef MAX_WAYPOINT_CHUNK
  
+    return pages;
+}
+
+
+/**
+ * @brief send mission to GCS as waypoint pages.
+ * @details pages are built once per mission version and shared by all requests.
+ * Building and sending happen outside the lock, so concurrent requests do not wait for each other.
+ * 
+ * @param target_party_id 
+ */
+void CFCBFacade::sendWayPoints(const std::string&target_party_id) const
+{
+    const uint32_t version = de::fcb::mission::CMissionManager::getInstance().getAndruavMission().version;
+
+    std::shared_ptr<const std::vector<Json_de>> pages;
+    {
+        std::lock_guard<std::mutex> guard(m_waypoint_pages_mutex);
+        if ((m_waypoint_pages != nullptr) && (m_waypoint_pages_version == version))
+        {
+            pages = m_waypoint_pages;
+        }
+    }
+
+    if (pages == nullptr)
+    {
+        pages = buildWayPointPages();
+
+        std::lock_guard<std::mutex> guard(m_waypoint_pages_mutex);
+        m_waypoint_pages = pages;
+        m_waypoint_pages_version = version;
+    }
+
+    for (const Json_de& message : *pages)
+    {
+        m_module.sendJMSG (target_party_id, message, TYPE_AndruavMessage_WayPoints, false);
+    }
+ 
     return ;
 }
 
@@ -875,6 +958,9 @@ void CFCBFacade::sendWayPointReached (const std::string&target_party_id, const i
     /*
         R: Report Type
         P: Parameter1
+        d: remaining distance [m] from reached item to end of mission. (optional)
+        D: total mission distance [m] (optional)
+        t: ETA [sec]. -1 if vehicle is not moving. (optional)
     */
 
     Json_de message =
@@ -883,12 +969,60 @@ void CFCBFacade::sendWayPointReached (const std::string&target_party_id, const i
         {"P", mission_sequence}
     };
 
+    addMissionProgress(message, mission_sequence, 0.0);
+
     m_module.sendJMSG (target_party_id, message, TYPE_AndruavMessage_DroneReport, false);
     
     return ;
 }
 
 
+/**
+ * @brief send remaining distance & ETA while flying towards current mission item.
+ * Same fields as sendWayPointReached with P as current item. Caller limits rate. [see CTelemetryEmitter]
+ * 
+ * @param target_party_id 
+ */
+void CFCBFacade::sendMissionProgress (const std::string&target_party_id)  const
+{
+    const mavlink_mission_current_t mission_current = mavlinksdk::CMavlinkWayPointManager::getInstance().getMissionCurrent();
+
+    Json_de message =
+    {
+        {"R", Drone_Report_NAV_ItemReached},
+        {"P", mission_current.seq}
+    };
+
+    if (!addMissionProgress(message, mission_current.seq, m_vehicle.getMsgNavController().wp_dist)) return ;
+
+    m_module.sendJMSG (target_party_id, message, TYPE_AndruavMessage_DroneReport, false);
+    
+    return ;
+}
+
+
+/**
+ * @brief add d, D & t fields of mission progress. 
+ * Mission legs are precomputed so this is O(1) regardless of mission size.
+ * 
+ * @param distance_to_current [m] from vehicle to mission_sequence.
+ * @return false if mission_sequence is not part of mission.
+ */
+bool CFCBFacade::addMissionProgress (Json_de& message, const int mission_sequence, const double distance_to_current) const
+{
+    const std::shared_ptr<const mission::CMissionGeometry> mission_geometry = de::fcb::mission::CMissionManager::getInstance().getMissionGeometry();
+    const double remaining_distance = mission_geometry->getRemainingDistance(mission_sequence, distance_to_current);
+    if (remaining_distance < 0) return false;
+
+    const float groundspeed = m_vehicle.getMsgVFRHud().groundspeed;
+    message["d"] = (int) remaining_distance;
+    message["D"] = (int) mission_geometry->getTotalDistance();
+    message["t"] = (groundspeed > MISSION_PROGRESS_MIN_SPEED) ? (int)(remaining_distance / groundspeed) : -1;
+
+    return true;
+}
+
+
             
 /**
  * @brief 
@@ -2,6 +2,10 @@
 #define FCB_FACADE_H_
 
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <string>
 
 #include <mavlink_sdk.h>
 #include "global.hpp"
@@ -94,7 +98,7 @@ namespace fcb
             void sendDistanceSensorInfo(const std::string&target_party_id) const;
             void sendDistanceSensorInfo(const std::string&target_party_id,const mavlink_distance_sensor_t& distance_sensor) const;
             void sendLocationInfo() const; 
-            void sendParameterList (const std::string&target_party_id) const;
+            void sendParameterList (const std::string&target_party_id, const uint32_t since_version = 0, const uint32_t since_epoch = 0) const;
             void sendParameterValue (const std::string&target_party_id, const mavlink_param_value_t& param_message) const;
             void sendPowerInfo(const std::string&target_party_id) const;
             void sendHomeLocation(const std::string&target_party_id) const;
@@ -105,6 +109,7 @@ namespace fcb
             void sendMavlinkData_Packed(const std::string&target_party_id, const mavlink_message_t* mavlink_message, const uint16_t count, const bool& internal_message)  const;
             void sendServoReadings(const std::string&target_party_id) const;
             void sendWayPointReached(const std::string&target_party_id, const int& mission_sequence) const;
+            void sendMissionProgress(const std::string&target_party_id) const;
             void sendMissionCurrent(const std::string&target_party_id) const;
             void sendGeoFenceAttachedStatusToTarget(const std::string&target_party_id, const std::string&fence_name) const;
             void sendGeoFenceToTarget(const std::string&target_party_id, const geofence::GEO_FENCE_STRUCT * geo_fenct_struct) const;
@@ -134,9 +139,32 @@ namespace fcb
             void API_IC_P2P_connectToMeshOnMac (const std::string& target_party_id) const;
             void API_IC_P2P_accessMac (const std::string& target_party_id) const;
 
+        private:
+            void buildParameterChunks (const uint32_t since_version, std::vector<std::string>& chunks) const;
+            std::shared_ptr<const std::vector<Json_de>> buildWayPointPages () const;
+            bool addMissionProgress (Json_de& message, const int mission_sequence, const double distance_to_current) const;
+
         private:
             mavlinksdk::CVehicle&    m_vehicle      =  mavlinksdk::CVehicle::getInstance();
 
+            /**
+             * @brief encoded full parameter list and parameters version it is built from.
+             * 
+             */
+            mutable std::vector<std::string> m_parameter_chunks;
+            mutable uint32_t m_parameter_chunks_version = 0;
+            mutable uint32_t m_parameter_chunks_epoch = 0;
+            mutable std::mutex m_parameter_chunks_mutex;
+
+            /**
+             * @brief waypoint pages and mission version they are built from.
+             * Pages are immutable once built so senders only hold the lock to copy the pointer.
+             * 
+             */
+            mutable std::shared_ptr<const std::vector<Json_de>> m_waypoint_pages;
+            mutable uint32_t m_waypoint_pages_version = 0;
+            mutable std::mutex m_waypoint_pages_mutex;
+
             
     };
 }
@@ -5,6 +5,8 @@
 #include <mavlink_waypoint_manager.h>
 #include <mavlink_parameter_manager.h>
 #include <mavlink_ftp_manager.h>
+#include <mavlink_setpoint_streamer.h>
+#include <mavlink_remote_log_receiver.h>
 
 #include <plog/Log.h>
 #include "plog/Initializers/RollingFileInitializer.h"
@@ -150,6 +152,46 @@ bool CFCBMain::init()
         m_mavlink_optimizer.reset_timestamps();
     }
 
+    if (m_jsonConfig.contains("telemetry_emission"))
+    {
+        m_telemetry_emitter.init(m_jsonConfig["telemetry_emission"]);
+    }
+
+    if (m_jsonConfig.contains("parameter_request_window") && m_jsonConfig["parameter_request_window"].is_number())
+    {
+        mavlinksdk::CMavlinkParameterManager::getInstance().setRequestWindow(m_jsonConfig["parameter_request_window"].get<int>());
+    }
+
+    if (m_jsonConfig.contains("mission_request_window") && m_jsonConfig["mission_request_window"].is_number())
+    {
+        mavlinksdk::CMavlinkWayPointManager::getInstance().setReadWindow(m_jsonConfig["mission_request_window"].get<int>());
+    }
+
+    if (m_jsonConfig.contains("parameter_cache_folder") && m_jsonConfig["parameter_cache_folder"].is_string())
+    {
+        mavlinksdk::CMavlinkParameterManager::getInstance().enableCache(m_jsonConfig["parameter_cache_folder"].get<std::string>());
+    }
+
+    if (m_jsonConfig.contains("mission_cache_folder") && m_jsonConfig["mission_cache_folder"].is_string())
+    {
+        mavlinksdk::CMavlinkWayPointManager::getInstance().enableCache(m_jsonConfig["mission_cache_folder"].get<std::string>());
+    }
+
+    if (m_jsonConfig.contains("remote_log_folder") && m_jsonConfig["remote_log_folder"].is_string())
+    {
+        mavlinksdk::CMavlinkRemoteLogReceiver::getInstance().start(m_jsonConfig["remote_log_folder"].get<std::string>());
+    }
+
+    if (m_jsonConfig.contains("log_download_folder") && m_jsonConfig["log_download_folder"].is_string())
+    {
+        m_log_download_folder = m_jsonConfig["log_download_folder"].get<std::string>();
+    }
+
+    if (m_jsonConfig.contains("fcb_fence_upload") && m_jsonConfig["fcb_fence_upload"].is_boolean())
+    {
+        geofence::CGeoFenceManager::getInstance().enableFCBFenceUpload(m_jsonConfig["fcb_fence_upload"].get<bool>());
+    }
+
     if (m_jsonConfig.contains("udp_proxy_enabled"))
     { // TODO: convert this to inline as validatefield
         m_enable_udp_telemetry_in_config = m_jsonConfig["udp_proxy_enabled"].get<bool>();
@@ -243,6 +285,8 @@ bool CFCBMain::uninit()
 
     m_scheduler_thread.join();
 
+    mavlinksdk::CMavlinkSetpointStreamer::getInstance().stop();
+
 #ifdef DEBUG
     std::cout << __FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  " << _LOG_CONSOLE_TEXT << "DEBUG: ~CFCBMain  Scheduler Thread Off" << _NORMAL_CONSOLE_TEXT_ << std::endl;
 #endif
@@ -489,21 +533,23 @@ void CFCBMain::loopScheduler()
         if (m_counter % 10 == 0)
         { // each 100 msec
             fcb_swarm_leader.handleSwarmsAsLeader();
+
+            // telemetry is sent when its mavlink message arrives. [see OnMessageReceived]
+            // this is a fallback that sends it when max_interval is exceeded with no changes.
+            sendChangedTelemetry();
+
+            // same fallback for fences when no position message arrives.
+            geofence::CGeoFenceManager::getInstance().onSchedulerUpdate();
         }
 
         if (m_counter % 30 == 0)
         { // each 300 msec
             remoteControlSignal();
-            m_fcb_facade.sendLocationInfo();
         }
 
         if (m_counter % 50 == 0)
         {
-            m_fcb_facade.sendNavInfo(std::string(ANDRUAV_PROTOCOL_SENDER_ALL_GCS));
-            geofence::CGeoFenceManager::getInstance().updateGeoFenceHitStatus();
-
             // called each second group #1
-            m_fcb_facade.sendGPSInfo(std::string(ANDRUAV_PROTOCOL_SENDER_ALL_GCS));
             checkBlockedStatus();
 
             heartbeatCamera();
@@ -556,6 +602,34 @@ void CFCBMain::loopScheduler()
     return;
 }
 
+/**
+ * @brief sends location, nav, gps info & mission progress if their emission policy allows.
+ * @see CTelemetryEmitter
+ *
+ */
+void CFCBMain::sendChangedTelemetry()
+{
+    if (m_telemetry_emitter.shouldSendLocationInfo())
+    {
+        m_fcb_facade.sendLocationInfo();
+    }
+
+    if (m_telemetry_emitter.shouldSendNavInfo())
+    {
+        m_fcb_facade.sendNavInfo(std::string(ANDRUAV_PROTOCOL_SENDER_ALL_GCS));
+    }
+
+    if (m_telemetry_emitter.shouldSendGPSInfo())
+    {
+        m_fcb_facade.sendGPSInfo(std::string(ANDRUAV_PROTOCOL_SENDER_ALL_GCS));
+    }
+
+    if ((m_andruav_vehicle_info.flying_mode == VEHICLE_MODE_AUTO) && m_telemetry_emitter.shouldSendMissionProgress())
+    {
+        m_fcb_facade.sendMissionProgress(std::string(ANDRUAV_PROTOCOL_SENDER_ALL_GCS));
+    }
+}
+
 /**
  * @brief Message received from FCB
  *
@@ -578,6 +652,39 @@ void CFCBMain::OnMessageReceived(const mavlink_message_t &mavlink_message)
 
         OnCommandLong(command_long);
         break;
+
+    case MAVLINK_MSG_ID_GLOBAL_POSITION_INT:
+        if (m_telemetry_emitter.shouldSendLocationInfo())
+        {
+            m_fcb_facade.sendLocationInfo();
+        }
+
+        // fences are evaluated on position change. [rate is capped by manager]
+        geofence::CGeoFenceManager::getInstance().onPositionUpdated();
+        break;
+
+    case MAVLINK_MSG_ID_ATTITUDE:
+    case MAVLINK_MSG_ID_VFR_HUD:
+        if (m_telemetry_emitter.shouldSendNavInfo())
+        {
+            m_fcb_facade.sendNavInfo(std::string(ANDRUAV_PROTOCOL_SENDER_ALL_GCS));
+        }
+        break;
+
+    case MAVLINK_MSG_ID_GPS_RAW_INT:
+        if (m_telemetry_emitter.shouldSendGPSInfo())
+        {
+            m_fcb_facade.sendGPSInfo(std::string(ANDRUAV_PROTOCOL_SENDER_ALL_GCS));
+        }
+        break;
+
+    case MAVLINK_MSG_ID_MISSION_CURRENT:
+    case MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT:
+        if ((m_andruav_vehicle_info.flying_mode == VEHICLE_MODE_AUTO) && m_telemetry_emitter.shouldSendMissionProgress())
+        {
+            m_fcb_facade.sendMissionProgress(std::string(ANDRUAV_PROTOCOL_SENDER_ALL_GCS));
+        }
+        break;
     }
 
     // if streaming active check each message to forward.
@@ -843,7 +950,7 @@ void CFCBMain::OnWayPointReceived(const mavlink_mission_item_int_t &mission_item
     {
         mission::CMissionItem *mission_item = mission::CMissionItemBuilder::getClassByMavlinkCMD(mission_item_int);
         mission_item->decodeMavlink(mission_item_int);
-        de::fcb::mission::CMissionManager::getInstance().getAndruavMission().mission_items.insert(std::make_pair(mission_item_int.seq, std::unique_ptr<mission::CMissionItem>(mission_item)));
+        de::fcb::mission::CMissionManager::getInstance().getAndruavMission().addMissionItem(mission_item_int.seq, std::unique_ptr<mission::CMissionItem>(mission_item));
     }
 
     return;
@@ -854,6 +961,13 @@ void CFCBMain::OnWayPointsLoadingCompleted()
     // ?Please check if we need to notify GCS.
     // notify that mission has been updated
     m_fcb_facade.sendWayPoints(std::string());
+
+    geofence::CGeoFenceManager::getInstance().validateMission();
+}
+
+void CFCBMain::OnWayPointsLoadingFailed()
+{
+    m_fcb_facade.sendErrorMessage(std::string(ANDRUAV_PROTOCOL_SENDER_ALL_GCS), 0, ERROR_TYPE_LO7ETTA7AKOM, NOTIFICATION_TYPE_ERROR, "Failed to read mission from FCB.");
 }
 
 /**
@@ -1155,6 +1269,7 @@ void CFCBMain::releaseRemoteControl()
     m_andruav_vehicle_info.rc_sub_action = RC_SUB_ACTION::RC_SUB_ACTION_RELEASED;
     m_andruav_vehicle_info.rc_command_active = false;
 
+    mavlinksdk::CMavlinkSetpointStreamer::getInstance().stop();
     mavlinksdk::CMavlinkCommand::getInstance().releaseRCChannels();
 
     m_fcb_facade.sendErrorMessage(std::string(ANDRUAV_PROTOCOL_SENDER_ALL_GCS), 0, ERROR_RCCONTROL, NOTIFICATION_TYPE_WARNING, std::string("RX Released."));
@@ -1188,6 +1303,7 @@ void CFCBMain::centerRemoteControl()
         memset(m_andruav_vehicle_info.rc_channels, 1500, 4 * sizeof(int16_t));
     }
 
+    mavlinksdk::CMavlinkSetpointStreamer::getInstance().stop();
     m_andruav_vehicle_info.rc_sub_action = RC_SUB_ACTION::RC_SUB_ACTION_CENTER_CHANNELS;
     m_andruav_vehicle_info.rc_command_active = true;
     m_fcb_facade.sendErrorMessage(std::string(ANDRUAV_PROTOCOL_SENDER_ALL_GCS), 0, ERROR_RCCONTROL, NOTIFICATION_TYPE_WARNING, std::string("RX Centered and Locked"));
@@ -1231,6 +1347,7 @@ void CFCBMain::freezeRemoteControl()
     m_andruav_vehicle_info.rc_channels[16] = mavlink_rc_channels.chan17_raw;
     m_andruav_vehicle_info.rc_channels[17] = mavlink_rc_channels.chan18_raw;
 
+    mavlinksdk::CMavlinkSetpointStreamer::getInstance().stop();
     m_andruav_vehicle_info.rc_sub_action = RC_SUB_ACTION::RC_SUB_ACTION_FREEZE_CHANNELS;
     m_andruav_vehicle_info.rc_command_active = true;
 
@@ -1251,6 +1368,7 @@ void CFCBMain::enableRemoteControl()
 
     m_andruav_vehicle_info.rc_command_last_update_time = get_time_usec();
     m_andruav_vehicle_info.rc_command_active = false; // remote control data will enable it
+    mavlinksdk::CMavlinkSetpointStreamer::getInstance().stop();
     m_andruav_vehicle_info.rc_sub_action = RC_SUB_ACTION::RC_SUB_ACTION_JOYSTICK_CHANNELS;
     memset(m_andruav_vehicle_info.rc_channels, 0, RC_CHANNELS_MAX * sizeof(int16_t)); // zero values. RC channels will be sent later
 
@@ -1273,6 +1391,17 @@ void CFCBMain::enableRemoteControlGuided()
     memset(m_andruav_vehicle_info.rc_channels, 0, RC_CHANNELS_MAX * sizeof(int16_t));
     mavlinksdk::CMavlinkCommand::getInstance().releaseRCChannels();
 
+    // joystick values are streamed at a steady rate. [see updateRemoteControlChannels]
+    // vehicle brakes till first joystick values arrive.
+    mavlinksdk::CMavlinkSetpointStreamer &setpoint_streamer = mavlinksdk::CMavlinkSetpointStreamer::getInstance();
+    if (!setpoint_streamer.isStreaming())
+    {
+        setpoint_streamer.clearTarget();
+        setpoint_streamer.setVelocity(0, 0, 0, MAV_FRAME_BODY_OFFSET_NED);
+        setpoint_streamer.setYawRate(0);
+        setpoint_streamer.start(RC_GUIDED_SETPOINT_RATE, RC_GUIDED_SETPOINT_TIMEOUT);
+    }
+
     m_andruav_vehicle_info.rc_sub_action = RC_SUB_ACTION::RC_SUB_ACTION_JOYSTICK_CHANNELS_GUIDED;
 
     m_fcb_facade.sendErrorMessage(std::string(ANDRUAV_PROTOCOL_SENDER_ALL_GCS), 0, ERROR_RCCONTROL, NOTIFICATION_TYPE_WARNING, std::string("RX Joystick Guided Mode"));
@@ -1386,7 +1515,7 @@ void CFCBMain::updateRemoteControlChannels(const int16_t rc_channels[RC_CHANNELS
 
     case RC_SUB_ACTION::RC_SUB_ACTION_JOYSTICK_CHANNELS_GUIDED:
     {
-        // In this mode send values via ctrlGuidedVelocityInLocalFrame
+        // In this mode values are streamed by CMavlinkSetpointStreamer as body frame velocity.
 
         m_andruav_vehicle_info.rc_command_last_update_time = get_time_usec();
         m_andruav_vehicle_info.rc_command_active = true;
@@ -1394,23 +1523,25 @@ void CFCBMain::updateRemoteControlChannels(const int16_t rc_channels[RC_CHANNELS
         int16_t rc_chammels_pwm[RC_CHANNELS_MAX] = {0};
 
         calculateChannels(rc_channels, true, rc_chammels_pwm);
+        mavlinksdk::CMavlinkSetpointStreamer &setpoint_streamer = mavlinksdk::CMavlinkSetpointStreamer::getInstance();
         if ((m_rcmap_channels_info.use_smart_rc) && (m_rcmap_channels_info.is_valid))
         {
-            mavlinksdk::CMavlinkCommand::getInstance().ctrlGuidedVelocityInLocalFrame(
+            setpoint_streamer.setVelocity(
                 !m_andruav_vehicle_info.rc_channels_enabled[m_rcmap_channels_info.rcmap_pitch] ? 0 : (1500 - rc_chammels_pwm[m_rcmap_channels_info.rcmap_pitch]) / 100.0f,
                 !m_andruav_vehicle_info.rc_channels_enabled[m_rcmap_channels_info.rcmap_roll] ? 0 : (rc_chammels_pwm[m_rcmap_channels_info.rcmap_roll] - 1500) / 100.0f,
                 !m_andruav_vehicle_info.rc_channels_enabled[m_rcmap_channels_info.rcmap_throttle] ? 0 : (1500 - rc_chammels_pwm[m_rcmap_channels_info.rcmap_throttle]) / 100.0f,
-                !m_andruav_vehicle_info.rc_channels_enabled[m_rcmap_channels_info.rcmap_yaw] ? 0 : (rc_chammels_pwm[m_rcmap_channels_info.rcmap_yaw] - 1500) / 1000.0f,
                 MAV_FRAME_BODY_OFFSET_NED);
+            setpoint_streamer.setYawRate(
+                !m_andruav_vehicle_info.rc_channels_enabled[m_rcmap_channels_info.rcmap_yaw] ? 0 : (rc_chammels_pwm[m_rcmap_channels_info.rcmap_yaw] - 1500) / 1000.0f);
         }
         else
         {
-            mavlinksdk::CMavlinkCommand::getInstance().ctrlGuidedVelocityInLocalFrame(
+            setpoint_streamer.setVelocity(
                 (1500 - rc_chammels_pwm[1]) / 100.0f,
                 (1500 - rc_chammels_pwm[0]) / 100.0f,
                 (1500 - rc_chammels_pwm[2]) / 100.0f,
-                (1500 - rc_chammels_pwm[3]) / 100.0f,
                 MAV_FRAME_BODY_OFFSET_NED);
+            setpoint_streamer.setYawRate((1500 - rc_chammels_pwm[3]) / 100.0f);
         }
     }
     break;
@@ -1448,17 +1579,21 @@ void CFCBMain::update_rcmap_info()
     {
         m_rcmap_channels_info.is_valid = false;
 
-        mavlink_param_value_t rcmap = parameter_manager.getParameterByName("RCMAP_PITCH");
-        m_rcmap_channels_info.rcmap_pitch = (uint16_t)rcmap.param_value - 1;
+        int32_t rcmap = 0;
+        parameter_manager.getParameterValue("RCMAP_PITCH", rcmap);
+        m_rcmap_channels_info.rcmap_pitch = (uint16_t)rcmap - 1;
 
-        rcmap = parameter_manager.getParameterByName("RCMAP_ROLL");
-        m_rcmap_channels_info.rcmap_roll = (uint16_t)rcmap.param_value - 1;
+        rcmap = 0;
+        parameter_manager.getParameterValue("RCMAP_ROLL", rcmap);
+        m_rcmap_channels_info.rcmap_roll = (uint16_t)rcmap - 1;
 
-        rcmap = parameter_manager.getParameterByName("RCMAP_THROTTLE");
-        m_rcmap_channels_info.rcmap_throttle = (uint16_t)rcmap.param_value - 1;
+        rcmap = 0;
+        parameter_manager.getParameterValue("RCMAP_THROTTLE", rcmap);
+        m_rcmap_channels_info.rcmap_throttle = (uint16_t)rcmap - 1;
 
-        rcmap = parameter_manager.getParameterByName("RCMAP_YAW");
-        m_rcmap_channels_info.rcmap_yaw = (uint16_t)rcmap.param_value - 1;
+        rcmap = 0;
+        parameter_manager.getParameterValue("RCMAP_YAW", rcmap);
+        m_rcmap_channels_info.rcmap_yaw = (uint16_t)rcmap - 1;
 
         m_rcmap_channels_info.is_valid = true;
     }
@@ -1468,17 +1603,21 @@ void CFCBMain::update_rcmap_info()
     {
         m_rcmap_channels_info.is_valid = false;
 
-        mavlink_param_value_t rcmap = parameter_manager.getParameterByName("RC_MAP_PITCH");
-        m_rcmap_channels_info.rcmap_pitch = (uint16_t)rcmap.param_value == 0 ? 2 : (uint16_t)rcmap.param_value - 1;
+        int32_t rcmap = 0;
+        parameter_manager.getParameterValue("RC_MAP_PITCH", rcmap);
+        m_rcmap_channels_info.rcmap_pitch = (uint16_t)rcmap == 0 ? 2 : (uint16_t)rcmap - 1;
 
-        rcmap = parameter_manager.getParameterByName("RC_MAP_ROLL");
-        m_rcmap_channels_info.rcmap_roll = (uint16_t)rcmap.param_value == 0 ? 0 : (uint16_t)rcmap.param_value - 1;
+        rcmap = 0;
+        parameter_manager.getParameterValue("RC_MAP_ROLL", rcmap);
+        m_rcmap_channels_info.rcmap_roll = (uint16_t)rcmap == 0 ? 0 : (uint16_t)rcmap - 1;
 
-        rcmap = parameter_manager.getParameterByName("RC_MAP_THROTTLE");
-        m_rcmap_channels_info.rcmap_throttle = (uint16_t)rcmap.param_value == 0 ? 1 : (uint16_t)rcmap.param_value - 1;
+        rcmap = 0;
+        parameter_manager.getParameterValue("RC_MAP_THROTTLE", rcmap);
+        m_rcmap_channels_info.rcmap_throttle = (uint16_t)rcmap == 0 ? 1 : (uint16_t)rcmap - 1;
 
-        rcmap = parameter_manager.getParameterByName("RC_MAP_YAW");
-        m_rcmap_channels_info.rcmap_yaw = (uint16_t)rcmap.param_value == 0 ? 3 : (uint16_t)rcmap.param_value - 1;
+        rcmap = 0;
+        parameter_manager.getParameterValue("RC_MAP_YAW", rcmap);
+        m_rcmap_channels_info.rcmap_yaw = (uint16_t)rcmap == 0 ? 3 : (uint16_t)rcmap - 1;
 
         m_rcmap_channels_info.is_valid = true;
     }
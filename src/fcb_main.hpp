@@ -14,6 +14,7 @@
 #include "./udp_proxy/udpProxy.hpp"
 #include "./mission/missions.hpp"
 #include "fcb_traffic_optimizer.hpp"
+#include "fcb_telemetry_emitter.hpp"
 #include "./de_common/de_databus/de_common_callback.hpp"
 
 #include "./de_common/helpers/json_nlohmann.hpp"
@@ -108,6 +109,15 @@ namespace fcb
                 return m_andruav_vehicle_info;
             }
 
+            /**
+             * @brief folder of onboard logs downloaded on GCS request. Empty if not enabled.
+             *
+             */
+            const std::string& getLogDownloadFolder () const
+            {
+                return m_log_download_folder;
+            }
+
             
             
 
@@ -212,6 +222,7 @@ namespace fcb
             void OnWaypointReached(const int& seq) override;
             void OnWayPointReceived(const mavlink_mission_item_int_t& mission_item_int) override;
             void OnWayPointsLoadingCompleted ();
+            void OnWayPointsLoadingFailed () override;
             void OnMissionSaveFinished (const int& result, const int& mission_type, const std::string& result_msg) override;            
             void OnMissionCurrentChanged (const mavlink_mission_current_t& mission_current) override;
             void OnParamReceived(const std::string& param_name, const mavlink_param_value_t& param_message, const bool& changed, const bool &load_parameters_1st_iteration) override;
@@ -238,6 +249,7 @@ namespace fcb
             mavlinksdk::CMavlinkSDK& m_mavlink_sdk = mavlinksdk::CMavlinkSDK::getInstance();
             de::fcb::CFCBFacade& m_fcb_facade = de::fcb::CFCBFacade::getInstance();
             de::fcb::CMavlinkTrafficOptimizer& m_mavlink_optimizer = de::fcb::CMavlinkTrafficOptimizer::getInstance();
+            de::fcb::CTelemetryEmitter& m_telemetry_emitter = de::fcb::CTelemetryEmitter::getInstance();
             
         private:
             int getConnectionType () const; 
@@ -253,6 +265,12 @@ namespace fcb
              */
             void heartbeatCamera ();
 
+            /**
+             * @brief sends telemetry products that changed or exceeded their max interval.
+             *
+             */
+            void sendChangedTelemetry ();
+
         private:
             Json_de m_jsonConfig;
             int m_connection_type;
@@ -280,6 +298,7 @@ namespace fcb
             uint16_t m_udp_telemetry_fixed_port = 0;
             uint64_t m_last_access_telemetry = 0;
             ANDRUAV_UDP_PROXY m_udp_proxy;
+            std::string m_log_download_folder;
 
 
             mavlinksdk::CVehicle &m_vehicle = mavlinksdk::CVehicle::getInstance();
@@ -0,0 +1,226 @@
+#include <math.h>
+
+#include <mavlink_waypoint_manager.h>
+
+#include "./de_common/helpers/helpers.hpp"
+#include "./helpers/gps.hpp"
+#include "fcb_telemetry_emitter.hpp"
+
+
+using namespace de::fcb;
+
+
+#define DEG_TO_RAD  (M_PI / 180.0)
+
+
+/**
+ * @brief smallest difference between two angles in radians.
+ *
+ */
+static inline double angleDifference (const double angle1, const double angle2)
+{
+    double diff = fmod(fabs(angle1 - angle2), 2.0 * M_PI);
+    if (diff > M_PI) diff = 2.0 * M_PI - diff;
+    return diff;
+}
+
+
+CTelemetryEmitter::CTelemetryEmitter()
+{
+    // defaults are used when config.json does not have "telemetry_emission" section.
+    // location: reaches GCS as soon as vehicle moves, keep alive each second.
+    T_TelemetryEmissionCard& location = m_card[TELEMETRY_PRODUCT_LOCATION];
+    location.min_interval           = 100000;
+    location.max_interval           = 1000000;
+    location.deadband_horizontal    = 0.5;
+    location.deadband_altitude      = 0.3;
+
+    T_TelemetryEmissionCard& nav = m_card[TELEMETRY_PRODUCT_NAV];
+    nav.min_interval                = 200000;
+    nav.max_interval                = 1000000;
+    nav.deadband_altitude           = 0.3;
+    nav.deadband_attitude           = 2.0 * DEG_TO_RAD;
+    nav.deadband_speed              = 0.3;
+
+    T_TelemetryEmissionCard& gps = m_card[TELEMETRY_PRODUCT_GPS];
+    gps.min_interval                = 500000;
+    gps.max_interval                = 2000000;
+    gps.deadband_horizontal         = 1.0;
+    gps.deadband_altitude           = 1.0;
+
+    // mission: distance to current item changes continuously so it is sent at low rate.
+    T_TelemetryEmissionCard& mission = m_card[TELEMETRY_PRODUCT_MISSION];
+    mission.min_interval            = 1000000;
+    mission.max_interval            = 5000000;
+    mission.deadband_horizontal     = 5.0;
+}
+
+
+void CTelemetryEmitter::loadCard (const Json_de &product_config, T_TelemetryEmissionCard& card)
+{
+    // intervals are in msec in config file. values <= 0 keep defaults.
+    if (product_config.contains("min_interval"))
+    {
+        const int min_interval = product_config["min_interval"].get<int>();
+        if (min_interval > 0) card.min_interval = (std::uint64_t) min_interval * 1000;
+    }
+    if (product_config.contains("max_interval"))
+    {
+        const int max_interval = product_config["max_interval"].get<int>();
+        if (max_interval > 0) card.max_interval = (std::uint64_t) max_interval * 1000;
+    }
+    if (product_config.contains("deadband_horizontal"))    card.deadband_horizontal = product_config["deadband_horizontal"].get<double>();
+    if (product_config.contains("deadband_altitude"))      card.deadband_altitude = product_config["deadband_altitude"].get<double>();
+    // attitude in degrees in config file.
+    if (product_config.contains("deadband_attitude"))      card.deadband_attitude = product_config["deadband_attitude"].get<double>() * DEG_TO_RAD;
+    if (product_config.contains("deadband_speed"))         card.deadband_speed = product_config["deadband_speed"].get<double>();
+
+    if (card.max_interval < card.min_interval)
+    {
+        card.max_interval = card.min_interval;
+    }
+}
+
+
+void CTelemetryEmitter::init(const Json_de &telemetry_emission_config)
+{
+    if (!telemetry_emission_config.is_object()) return ;
+
+    const std::lock_guard<std::mutex> lock(m_lock);
+
+    if (telemetry_emission_config.contains("location"))  loadCard(telemetry_emission_config["location"], m_card[TELEMETRY_PRODUCT_LOCATION]);
+    if (telemetry_emission_config.contains("nav"))       loadCard(telemetry_emission_config["nav"], m_card[TELEMETRY_PRODUCT_NAV]);
+    if (telemetry_emission_config.contains("gps"))       loadCard(telemetry_emission_config["gps"], m_card[TELEMETRY_PRODUCT_GPS]);
+    if (telemetry_emission_config.contains("mission"))   loadCard(telemetry_emission_config["mission"], m_card[TELEMETRY_PRODUCT_MISSION]);
+}
+
+
+/**
+ * @brief applies min & max intervals.
+ * Caller should hold m_lock.
+ *
+ * @param card
+ * @param changed true if source values exceeded any deadband.
+ * @return true if product should be sent now.
+ */
+bool CTelemetryEmitter::shouldSend (T_TelemetryEmissionCard& card, const bool changed)
+{
+    const std::uint64_t now = get_time_usec();
+    const std::uint64_t elapsed = now - card.time_of_last_sent_message;
+
+    if ((elapsed >= card.max_interval) || (changed && (elapsed >= card.min_interval)))
+    {
+        card.time_of_last_sent_message = now;
+        return true;
+    }
+
+    return false;
+}
+
+
+bool CTelemetryEmitter::shouldSendLocationInfo ()
+{
+    const std::lock_guard<std::mutex> lock(m_lock);
+
+    T_TelemetryEmissionCard& card = m_card[TELEMETRY_PRODUCT_LOCATION];
+    T_TelemetrySnapshot& snapshot = m_snapshot[TELEMETRY_PRODUCT_LOCATION];
+    const mavlink_global_position_int_t& gpos = m_vehicle.getMsgGlobalPositionInt();
+
+    const bool changed =
+           (fabs((gpos.alt - snapshot.alt) / 1000.0) >= card.deadband_altitude)
+        || (calcGPSDistance(gpos.lat / 10000000.0, gpos.lon / 10000000.0, snapshot.lat / 10000000.0, snapshot.lon / 10000000.0) >= card.deadband_horizontal);
+
+    if (!shouldSend(card, changed)) return false;
+
+    snapshot.lat = gpos.lat;
+    snapshot.lon = gpos.lon;
+    snapshot.alt = gpos.alt;
+
+    return true;
+}
+
+
+bool CTelemetryEmitter::shouldSendNavInfo ()
+{
+    if (m_vehicle.getHighLatencyMode()!=0) return false;
+
+    const std::lock_guard<std::mutex> lock(m_lock);
+
+    T_TelemetryEmissionCard& card = m_card[TELEMETRY_PRODUCT_NAV];
+    T_TelemetrySnapshot& snapshot = m_snapshot[TELEMETRY_PRODUCT_NAV];
+    const mavlink_attitude_t& attitude = m_vehicle.getMsgAttitude();
+    const mavlink_vfr_hud_t& vfr_hud = m_vehicle.getMsgVFRHud();
+
+    const bool changed =
+           (angleDifference(attitude.roll, snapshot.roll) >= card.deadband_attitude)
+        || (angleDifference(attitude.pitch, snapshot.pitch) >= card.deadband_attitude)
+        || (angleDifference(attitude.yaw, snapshot.yaw) >= card.deadband_attitude)
+        || (fabs(vfr_hud.groundspeed - snapshot.groundspeed) >= card.deadband_speed)
+        || (fabs(vfr_hud.climb - snapshot.climb) >= card.deadband_speed)
+        || (fabs(vfr_hud.alt - snapshot.alt / 1000.0) >= card.deadband_altitude);
+
+    if (!shouldSend(card, changed)) return false;
+
+    snapshot.roll = attitude.roll;
+    snapshot.pitch = attitude.pitch;
+    snapshot.yaw = attitude.yaw;
+    snapshot.groundspeed = vfr_hud.groundspeed;
+    snapshot.climb = vfr_hud.climb;
+    snapshot.alt = (int32_t)(vfr_hud.alt * 1000.0);
+
+    return true;
+}
+
+
+bool CTelemetryEmitter::shouldSendGPSInfo ()
+{
+    if (m_vehicle.getHighLatencyMode()!=0) return false;
+
+    const std::lock_guard<std::mutex> lock(m_lock);
+
+    T_TelemetryEmissionCard& card = m_card[TELEMETRY_PRODUCT_GPS];
+    T_TelemetrySnapshot& snapshot = m_snapshot[TELEMETRY_PRODUCT_GPS];
+    const mavlink_gps_raw_int_t& gps = m_vehicle.getMSGGPSRaw();
+
+    // fix type & satellite count changes are always important.
+    const bool changed =
+           (gps.fix_type != snapshot.fix_type)
+        || (gps.satellites_visible != snapshot.satellites_visible)
+        || (fabs((gps.alt - snapshot.alt) / 1000.0) >= card.deadband_altitude)
+        || (calcGPSDistance(gps.lat / 10000000.0, gps.lon / 10000000.0, snapshot.lat / 10000000.0, snapshot.lon / 10000000.0) >= card.deadband_horizontal);
+
+    if (!shouldSend(card, changed)) return false;
+
+    snapshot.lat = gps.lat;
+    snapshot.lon = gps.lon;
+    snapshot.alt = gps.alt;
+    snapshot.fix_type = gps.fix_type;
+    snapshot.satellites_visible = gps.satellites_visible;
+
+    return true;
+}
+
+
+bool CTelemetryEmitter::shouldSendMissionProgress ()
+{
+    if (m_vehicle.getHighLatencyMode()!=0) return false;
+
+    const std::lock_guard<std::mutex> lock(m_lock);
+
+    T_TelemetryEmissionCard& card = m_card[TELEMETRY_PRODUCT_MISSION];
+    T_TelemetrySnapshot& snapshot = m_snapshot[TELEMETRY_PRODUCT_MISSION];
+    const mavlink_nav_controller_output_t& nav_controller = m_vehicle.getMsgNavController();
+    const uint16_t mission_seq = mavlinksdk::CMavlinkWayPointManager::getInstance().getMissionCurrent().seq;
+
+    // new current item is always important.
+    const bool changed =
+           (mission_seq != snapshot.mission_seq)
+        || (fabs((double) nav_controller.wp_dist - snapshot.wp_dist) >= card.deadband_horizontal);
+
+    if (!shouldSend(card, changed)) return false;
+
+    snapshot.mission_seq = mission_seq;
+    snapshot.wp_dist = nav_controller.wp_dist;
+
+    return true;
+}
@@ -0,0 +1,162 @@
+#ifndef FCB_TELEMETRY_EMITTER_H_
+#define FCB_TELEMETRY_EMITTER_H_
+
+#include <mutex>
+
+#include "./de_common/helpers/json_nlohmann.hpp"
+using Json_de = nlohmann::json;
+
+#include <all/mavlink.h>
+#include <vehicle.h>
+
+
+
+namespace de
+{
+namespace fcb
+{
+
+    typedef enum ENUM_TELEMETRY_PRODUCT
+    {
+        TELEMETRY_PRODUCT_LOCATION   = 0,   // sendLocationInfo
+        TELEMETRY_PRODUCT_NAV        = 1,   // sendNavInfo
+        TELEMETRY_PRODUCT_GPS        = 2,   // sendGPSInfo
+        TELEMETRY_PRODUCT_MISSION    = 3,   // sendMissionProgress
+        TELEMETRY_PRODUCT_COUNT      = 4
+    } ENUM_TELEMETRY_PRODUCT;
+
+
+    /**
+     * @brief emission policy of a telemetry product.
+     * A product is sent when its source changed more than one of its deadbands
+     * and at least min_interval passed since last send.
+     * It is always sent if max_interval passed regardless of changes (keep alive).
+     *
+     */
+    typedef struct T_TelemetryEmissionCard
+    {
+        std::uint64_t min_interval          = 0;    // in usec
+        std::uint64_t max_interval          = 0;    // in usec
+        double deadband_horizontal          = 0.0;  // meters
+        double deadband_altitude            = 0.0;  // meters
+        double deadband_attitude            = 0.0;  // radians
+        double deadband_speed               = 0.0;  // m/s
+        std::uint64_t time_of_last_sent_message = 0;
+    } T_TelemetryEmissionCard;
+
+
+    /**
+     * @brief values of the last sent telemetry used to measure changes against deadbands.
+     *
+     */
+    typedef struct T_TelemetrySnapshot
+    {
+        int32_t lat         = 0;    // [degE7]
+        int32_t lon         = 0;    // [degE7]
+        int32_t alt         = 0;    // [mm]
+        float roll          = 0.0f; // [rad]
+        float pitch         = 0.0f; // [rad]
+        float yaw           = 0.0f; // [rad]
+        float groundspeed   = 0.0f; // [m/s]
+        float climb         = 0.0f; // [m/s]
+        uint8_t fix_type    = 0;
+        uint8_t satellites_visible = 0;
+        uint16_t mission_seq = 0;
+        uint16_t wp_dist    = 0;    // [m]
+    } T_TelemetrySnapshot;
+
+
+    /**
+     * @brief Decides when telemetry products are sent to GCS.
+     * Instead of sending on fixed timers, products are checked when their source mavlink message arrives
+     * and sent only if values changed meaningfully. Scheduler calls the same checks to enforce max_interval.
+     * Settings are stored in config.json file under "telemetry_emission" and are optional.
+     *
+     */
+    class CTelemetryEmitter
+    {
+
+        public:
+            //https://stackoverflow.com/questions/1008019/c-singleton-design-pattern
+            static CTelemetryEmitter& getInstance()
+            {
+                static CTelemetryEmitter instance;
+
+                return instance;
+            }
+
+            CTelemetryEmitter(CTelemetryEmitter const&)                 = delete;
+            void operator=(CTelemetryEmitter const&)                    = delete;
+
+        private:
+
+            CTelemetryEmitter();
+
+        public:
+
+            ~CTelemetryEmitter()
+            {
+
+            }
+
+
+        public:
+
+            void init(const Json_de &telemetry_emission_config);
+
+            /**
+             * @details Returns true if location info should be sent now.
+             * Source: GLOBAL_POSITION_INT
+             */
+            bool shouldSendLocationInfo ();
+
+            /**
+             * @details Returns true if nav info should be sent now.
+             * Source: ATTITUDE, VFR_HUD
+             */
+            bool shouldSendNavInfo ();
+
+            /**
+             * @details Returns true if GPS info should be sent now.
+             * Source: GPS_RAW_INT
+             */
+            bool shouldSendGPSInfo ();
+
+            /**
+             * @details Returns true if mission progress should be sent now.
+             * Source: MISSION_CURRENT, NAV_CONTROLLER_OUTPUT
+             */
+            bool shouldSendMissionProgress ();
+
+            /**
+             * @brief Reset time_of_last_sent_message of all products so that they are sent on next check.
+             *
+             */
+            void reset_timestamps()
+            {
+                const std::lock_guard<std::mutex> lock(m_lock);
+
+                for (int i=0; i<TELEMETRY_PRODUCT_COUNT; ++i)
+                {
+                    m_card[i].time_of_last_sent_message = 0;
+                }
+            }
+
+        private:
+
+            void loadCard (const Json_de &product_config, T_TelemetryEmissionCard& card);
+            bool shouldSend (T_TelemetryEmissionCard& card, const bool changed);
+
+        private:
+
+            T_TelemetryEmissionCard m_card[TELEMETRY_PRODUCT_COUNT];
+            T_TelemetrySnapshot m_snapshot[TELEMETRY_PRODUCT_COUNT];
+
+            std::mutex m_lock;
+
+            mavlinksdk::CVehicle &m_vehicle = mavlinksdk::CVehicle::getInstance();
+    };
+
+}
+}
+#endif
@@ -1,7 +1,10 @@
 #include <iostream>
+#include <cmath>
+#include <algorithm>
 
 #include "../de_common/helpers/colors.hpp"
 #include "../helpers/gps.hpp"
+#include "../helpers/gps_geodesy.hpp"
 #include "../geofence/fcb_geo_fence_base.hpp"
 
 
@@ -11,6 +14,57 @@
 using namespace de::fcb::geofence;
 
 
+/**
+ * @brief bounding box of points expanded by margin in meters.
+ * 
+ */
+static T_GEO_BOUNDING_BOX getBoundingBoxOf (const std::vector<POINT_3D>& points, const double margin)
+{
+    T_GEO_BOUNDING_BOX box;
+    if (points.empty()) return box;
+
+    box.min_latitude = box.max_latitude = points[0].latitude;
+    box.min_longitude = box.max_longitude = points[0].longitude;
+    for (const POINT_3D& point : points)
+    {
+        box.min_latitude = std::min(box.min_latitude, point.latitude);
+        box.max_latitude = std::max(box.max_latitude, point.latitude);
+        box.min_longitude = std::min(box.min_longitude, point.longitude);
+        box.max_longitude = std::max(box.max_longitude, point.longitude);
+    }
+
+    // 111320 meters per degree of latitude.
+    const double margin_latitude = margin / 111320.0;
+    const double max_abs_latitude = std::min(89.0, std::max(fabs(box.min_latitude), fabs(box.max_latitude)) + margin_latitude);
+    const double margin_longitude = margin / (111320.0 * cos(max_abs_latitude * M_PI / 180.0));
+    box.min_latitude -= margin_latitude;
+    box.max_latitude += margin_latitude;
+    box.min_longitude -= margin_longitude;
+    box.max_longitude += margin_longitude;
+
+    return box;
+}
+
+
+/**
+ * @brief project vertices on a plane tangent at first vertex.
+ * 
+ * @param frame [out] plane of first vertex. Used later to project tested points.
+ */
+static void getLocalVertices (const std::vector<POINT_3D>& vertices, CLocalFrame& frame, std::vector<POINT_LOCAL>& local_vertices)
+{
+    local_vertices.clear();
+    if (vertices.empty()) return ;
+
+    frame.setReference(vertices[0].latitude, vertices[0].longitude);
+    local_vertices.reserve(vertices.size());
+    for (const POINT_3D& vertex : vertices)
+    {
+        local_vertices.push_back(frame.toLocal(vertex.latitude, vertex.longitude));
+    }
+}
+
+
 CGeoFenceBase::CGeoFenceBase() 
 {
 
@@ -27,8 +81,36 @@ void CGeoFenceBase::parse (const Json_de& message)
    m_should_keep_outside = message["o"].get<int>()==1; 
    m_hard_fence_action = message["a"].get<int>();
 
+   // optional altitude band. "lf" floor & "lc" ceiling in meters above home.
+   m_has_altitude_limits = message.contains("lf") || message.contains("lc");
+   m_altitude_floor = message.contains("lf") ? message["lf"].get<double>() : -INFINITY;
+   m_altitude_ceiling = message.contains("lc") ? message["lc"].get<double>() : INFINITY;
+
    m_message = message;
 }
+
+
+/**
+ * @brief inside volume if inside area and between floor & ceiling.
+ * Outside distance is the distance to nearest point of volume.
+ * 
+ */
+double CGeoFenceBase::applyAltitudeLimits (const double horizontal_distance, const double alt) const
+{
+    if (!m_has_altitude_limits) return horizontal_distance;
+
+    // <= 0 if between floor & ceiling.
+    const double vertical_distance = std::max(m_altitude_floor - alt, alt - m_altitude_ceiling);
+    if ((horizontal_distance <= 0) && (vertical_distance <= 0))
+    {
+        return std::max(horizontal_distance, vertical_distance);
+    }
+
+    const double horizontal = std::max(horizontal_distance, 0.0);
+    const double vertical = std::max(vertical_distance, 0.0);
+    
+    return sqrt(horizontal * horizontal + vertical * vertical);
+}
             
 
 Json_de CGeoFenceBase::getMessage()
@@ -66,6 +148,12 @@ void CGeoFenceCylinder::parse (const Json_de& message)
         m_altitude = 0;
     }
     m_radius = message["r"].get<int>();
+
+    POINT_3D center;
+    center.latitude = m_latitude;
+    center.longitude = m_longitude;
+    m_bounding_box = getBoundingBoxOf(std::vector<POINT_3D>(1, center), m_radius);
+    m_local_frame.setReference(m_latitude, m_longitude);
 }
 
 
@@ -90,7 +178,44 @@ double CGeoFenceCylinder::isInside(double lat, double lng, double alt) const
     std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: lat " << std::to_string(lat) << " lng " << std::to_string(lng) << " alt " << std::to_string(alt) << " distance: " << std::to_string(distance) << _NORMAL_CONSOLE_TEXT_ << std::endl;
     #endif
 
-    return distance - m_radius;
+    return applyAltitudeLimits(distance - m_radius, alt);
+}
+
+
+bool CGeoFenceCylinder::getMavlinkFenceItems (std::vector<mavlink_mission_item_int_t>& mission_items) const
+{
+    // FCB fences have no altitude band.
+    if (m_has_altitude_limits) return false;
+
+    mavlink_mission_item_int_t mission_item_int = {0};
+    mission_item_int.mission_type = MAV_MISSION_TYPE_FENCE;
+    mission_item_int.frame = MAV_FRAME_GLOBAL;
+    mission_item_int.command = m_should_keep_outside ? MAV_CMD_NAV_FENCE_CIRCLE_EXCLUSION : MAV_CMD_NAV_FENCE_CIRCLE_INCLUSION;
+    mission_item_int.param1 = m_radius;
+    mission_item_int.x = (int32_t) (m_latitude * 10000000.0);
+    mission_item_int.y = (int32_t) (m_longitude * 10000000.0);
+    
+    mission_items.push_back(mission_item_int);
+    
+    return true;
+}
+
+
+
+/**
+ * @brief circle is convex so segment is inside if both ends are inside.
+ * 
+ */
+bool CGeoFenceCylinder::testSegment (const double lat1, const double lng1, const double lat2, const double lng2, double& distance, bool& fully_inside) const
+{
+    const POINT_LOCAL center = {0, 0};
+    const POINT_LOCAL p1 = m_local_frame.toLocal(lat1, lng1);
+    const POINT_LOCAL p2 = m_local_frame.toLocal(lat2, lng2);
+
+    distance = findDistanceToLocalSegment(center, p1, p2) - m_radius;
+    fully_inside = (sqrt(p1.x * p1.x + p1.y * p1.y) <= m_radius) && (sqrt(p2.x * p2.x + p2.y * p2.y) <= m_radius);
+
+    return true;
 }
 
 
@@ -131,8 +256,12 @@ void CGeoFencePolygon::parse (const Json_de& message)
         {
             alt = 0;
         }
-        m_vertex[0].altitude = alt;
+        m_vertex[i].altitude = alt;
     }
+
+    m_bounding_box = getBoundingBoxOf(m_vertex, 0);
+    getLocalVertices(m_vertex, m_local_frame, m_vertex_local);
+    buildLocalEdges(m_vertex_local, true, m_edges);
 }
   
 Json_de CGeoFencePolygon::getMessage() 
@@ -141,7 +270,7 @@ Json_de CGeoFencePolygon::getMessage()
 }
 
 /**
- * @brief return 0 if inside or distance to center if outside.
+ * @brief return 0 if inside or distance to nearest edge if outside.
  * 
  * @param lat 
  * @param lng 
@@ -154,15 +283,90 @@ double CGeoFencePolygon::isInside(double lat, double lng, double alt) const
     std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: lat " << std::to_string(lat) << " lng " << std::to_string(lng) << " alt " << std::to_string(alt) << _NORMAL_CONSOLE_TEXT_ << std::endl;
     #endif
     
-    if (inPolygon (lat, lng, m_vertex) == 1)
+    const std::size_t vertex_count = m_vertex_local.size();
+    if (vertex_count < 3) return 9999999;
+
+    const POINT_LOCAL point = m_local_frame.toLocal(lat, lng);
+    int crossings;
+    const double min_distance = findDistanceToLocalEdges(point, m_edges, crossings);
+    if ((crossings & 1) == 1)
+    {
+        return applyAltitudeLimits(0, alt); //
+    }
+    
+    return applyAltitudeLimits(min_distance, alt);
+}
+
+
+/**
+ * @brief a vertex item per point. param1 of each item is number of vertices.
+ * 
+ */
+bool CGeoFencePolygon::getMavlinkFenceItems (std::vector<mavlink_mission_item_int_t>& mission_items) const
+{
+    const std::size_t vertex_count = m_vertex.size();
+    if (vertex_count < 3) return false;
+    
+    // FCB fences have no altitude band.
+    if (m_has_altitude_limits) return false;
+
+    for (const POINT_3D& vertex : m_vertex)
+    {
+        mavlink_mission_item_int_t mission_item_int = {0};
+        mission_item_int.mission_type = MAV_MISSION_TYPE_FENCE;
+        mission_item_int.frame = MAV_FRAME_GLOBAL;
+        mission_item_int.command = m_should_keep_outside ? MAV_CMD_NAV_FENCE_POLYGON_VERTEX_EXCLUSION : MAV_CMD_NAV_FENCE_POLYGON_VERTEX_INCLUSION;
+        mission_item_int.param1 = vertex_count;
+        mission_item_int.x = (int32_t) (vertex.latitude * 10000000.0);
+        mission_item_int.y = (int32_t) (vertex.longitude * 10000000.0);
+    
+        mission_items.push_back(mission_item_int);
+    }
+    
+    return true;
+}
+
+/**
+ * @brief segment enters polygon if an end is inside or it crosses an edge.
+ * If it enters, distance is minus depth of the deepest end.
+ * 
+ */
+bool CGeoFencePolygon::testSegment (const double lat1, const double lng1, const double lat2, const double lng2, double& distance, bool& fully_inside) const
+{
+    const std::size_t vertex_count = m_vertex_local.size();
+    if (vertex_count < 3) return false;
+
+    const POINT_LOCAL p1 = m_local_frame.toLocal(lat1, lng1);
+    const POINT_LOCAL p2 = m_local_frame.toLocal(lat2, lng2);
+
+    double min_distance = INFINITY;
+    for (std::size_t i = 0, j = vertex_count - 1; i < vertex_count; j = i++)
+    {
+        min_distance = std::min(min_distance, findDistanceBetweenLocalSegments(p1, p2, m_vertex_local[j], m_vertex_local[i]));
+    }
+
+    int crossings1, crossings2;
+    const double depth1 = findDistanceToLocalEdges(p1, m_edges, crossings1);
+    const double depth2 = findDistanceToLocalEdges(p2, m_edges, crossings2);
+    const bool inside1 = ((crossings1 & 1) == 1);
+    const bool inside2 = ((crossings2 & 1) == 1);
+    const bool crossing = (min_distance == 0);
+
+    if (inside1 || inside2 || crossing)
     {
-        return 0; //
+        distance = -std::max(inside1 ? depth1 : 0.0, inside2 ? depth2 : 0.0);
+    }
+    else
+    {
+        distance = min_distance;
     }
-     
     
-    return  calcGPSDistance (m_latitude , m_longitude , lat , lng );
+    fully_inside = inside1 && inside2 && !crossing;
+
+    return true;
 }
 
+
 //**************************** CGeoFenceLine
 
 CGeoFenceLine::CGeoFenceLine() 
@@ -200,10 +404,14 @@ void CGeoFenceLine::parse (const Json_de& message)
         {
             alt = 0;
         }
-        m_vertex[0].altitude = alt;
+        m_vertex[i].altitude = alt;
     }
 
     m_width = message["r"].get<int>();
+
+    m_bounding_box = getBoundingBoxOf(m_vertex, m_width);
+    getLocalVertices(m_vertex, m_local_frame, m_vertex_local);
+    buildLocalEdges(m_vertex_local, false, m_edges);
 }
             
 Json_de CGeoFenceLine::getMessage() 
@@ -216,20 +424,47 @@ double CGeoFenceLine::isInside(double lat, double lng, double alt) const
     #ifdef DDEBUG
     std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: lat " << std::to_string(lat) << " lng " << std::to_string(lng) << " alt " << std::to_string(alt) << _NORMAL_CONSOLE_TEXT_ << std::endl;
     #endif
-    const std::size_t size = m_vertex.size();
+    const std::size_t size = m_vertex_local.size();
     double total_distance = 9999999;
-    for(int i = 0; i < size -1 ; i++)
+    if (size < 2) return (total_distance - m_width);
+
+    const POINT_LOCAL point = m_local_frame.toLocal(lat, lng);
+    int crossings;
+    total_distance = findDistanceToLocalEdges(point, m_edges, crossings);
+    
+    return applyAltitudeLimits(total_distance - m_width, alt);
+}
+
+
+/**
+ * @brief corridor around polyline. fully_inside checks ends and middle of the segment
+ * as corridor is not convex.
+ * 
+ */
+bool CGeoFenceLine::testSegment (const double lat1, const double lng1, const double lat2, const double lng2, double& distance, bool& fully_inside) const
+{
+    const std::size_t vertex_count = m_vertex_local.size();
+    if (vertex_count < 2) return false;
+
+    const POINT_LOCAL p1 = m_local_frame.toLocal(lat1, lng1);
+    const POINT_LOCAL p2 = m_local_frame.toLocal(lat2, lng2);
+    const POINT_LOCAL middle = {(p1.x + p2.x) / 2, (p1.y + p2.y) / 2};
+
+    double min_distance = INFINITY;
+    for (std::size_t i = 0; i < vertex_count - 1; ++i)
     {
-        const double distance = findDistanceToSegment (lat , lng, 
-                            m_vertex[i].latitude, m_vertex[i].longitude,
-                            m_vertex[i+1].latitude, m_vertex[i+1].longitude);
-        if (distance < total_distance)
-        {
-            total_distance = distance;
-        }
+        min_distance = std::min(min_distance, findDistanceBetweenLocalSegments(p1, p2, m_vertex_local[i], m_vertex_local[i+1]));
     }
-    
-    return (total_distance - m_width);
+
+    int crossings;
+    const double distance1 = findDistanceToLocalEdges(p1, m_edges, crossings);
+    const double distance2 = findDistanceToLocalEdges(p2, m_edges, crossings);
+    const double distance_middle = findDistanceToLocalEdges(middle, m_edges, crossings);
+
+    distance = min_distance - m_width;
+    fully_inside = (distance1 <= m_width) && (distance2 <= m_width) && (distance_middle <= m_width);
+
+    return true;
 }
 
 
@@ -2,7 +2,13 @@
 #define FCB_GEO_FENCE_BASE_H_
 
 
+#include <vector>
+#include <cmath>
+#include <all/mavlink.h>
+
 #include "../helpers/gps.hpp"
+#include "../helpers/gps_edges.hpp"
+#include "../helpers/gps_geodesy.hpp"
 
 
 #include "../de_common/helpers/json_nlohmann.hpp"
@@ -25,6 +31,31 @@ namespace geofence
         CylindersFence  = 3
     };
 
+    /**
+     * @brief in degrees
+     * 
+     */
+    typedef struct T_GEO_BOUNDING_BOX
+    {
+        double min_latitude     = 0;
+        double min_longitude    = 0;
+        double max_latitude     = 0;
+        double max_longitude    = 0;
+
+        inline bool intersects (const T_GEO_BOUNDING_BOX& other) const
+        {
+            return (min_latitude <= other.max_latitude) && (other.min_latitude <= max_latitude)
+                && (min_longitude <= other.max_longitude) && (other.min_longitude <= max_longitude);
+        }
+
+        inline bool contains (const T_GEO_BOUNDING_BOX& other) const
+        {
+            return (min_latitude <= other.min_latitude) && (other.max_latitude <= max_latitude)
+                && (min_longitude <= other.min_longitude) && (other.max_longitude <= max_longitude);
+        }
+    } T_GEO_BOUNDING_BOX;
+
+
     class CGeoFenceBase
     {
         public:
@@ -41,6 +72,43 @@ namespace geofence
                 return 0.0;
             }
             
+            /**
+             * @brief fence as MAV_MISSION_TYPE_FENCE items so that FCB can enforce it.
+             * Items seq is set by caller.
+             * 
+             * @return false if fence cannot be represented by FCB fence items.
+             */
+            virtual bool getMavlinkFenceItems (std::vector<mavlink_mission_item_int_t>& mission_items) const
+            {
+                return false;
+            }
+
+            /**
+             * @brief test a path segment against fence area. Used to validate mission legs before flight.
+             * 
+             * @param distance [out] distance between segment and fence area in meters. <= 0 if segment enters fence.
+             * @param fully_inside [out] true if whole segment is inside fence.
+             * @return false if fence type does not support segment test.
+             */
+            virtual bool testSegment (const double lat1, const double lng1, const double lat2, const double lng2, double& distance, bool& fully_inside) const
+            {
+                return false;
+            }
+
+            /**
+             * @brief altitude band of fence. Fence applies only between floor & ceiling.
+             * 
+             * @param floor [out] meters above home. -INFINITY if fence has ceiling only.
+             * @param ceiling [out] meters above home. INFINITY if fence has floor only.
+             * @return false if fence has no altitude limits.
+             */
+            virtual bool getAltitudeLimits (double& floor, double& ceiling) const
+            {
+                floor = m_altitude_floor;
+                ceiling = m_altitude_ceiling;
+                return m_has_altitude_limits;
+            }
+            
         public:
 
             virtual Json_de getMessage();
@@ -65,6 +133,15 @@ namespace geofence
                 return m_geofence_type;
             }
 
+            /**
+             * @brief area covered by fence including radius or width. Calculated by parse.
+             * 
+             */
+            inline const T_GEO_BOUNDING_BOX& getBoundingBox() const
+            {
+                return m_bounding_box;
+            }
+
             
 
         protected:
@@ -98,6 +175,32 @@ namespace geofence
              * 
              */
             Json_de m_message;
+
+            T_GEO_BOUNDING_BOX m_bounding_box;
+
+            /**
+             * @brief optional altitude band in meters above home. 
+             * 
+             */
+            bool m_has_altitude_limits = false;
+            double m_altitude_floor = -INFINITY;
+            double m_altitude_ceiling = INFINITY;
+
+            /**
+             * @brief plane tangent at center or first vertex. Set by parse.
+             * 
+             */
+            CLocalFrame m_local_frame;
+
+        protected:
+
+            /**
+             * @brief combines horizontal distance with altitude band into distance from fence volume.
+             * 
+             * @param horizontal_distance <= 0 if inside fence area.
+             * @param alt meters above home.
+             */
+            double applyAltitudeLimits (const double horizontal_distance, const double alt) const;
             
     };
 
@@ -113,6 +216,8 @@ namespace geofence
         
             void parse (const Json_de& message)override;
             double isInside(double lat, double lng, double alt) const override;
+            bool getMavlinkFenceItems (std::vector<mavlink_mission_item_int_t>& mission_items) const override;
+            bool testSegment (const double lat1, const double lng1, const double lat2, const double lng2, double& distance, bool& fully_inside) const override;
             Json_de getMessage() override;
             
             inline void getLocation (double& lat, double& lng, double& alt) const
@@ -148,10 +253,19 @@ namespace geofence
         
             void parse (const Json_de& message)override;
             double isInside(double lat, double lng, double alt) const override;
+            bool getMavlinkFenceItems (std::vector<mavlink_mission_item_int_t>& mission_items) const override;
+            bool testSegment (const double lat1, const double lng1, const double lat2, const double lng2, double& distance, bool& fully_inside) const override;
             Json_de getMessage() override;
         
         protected:
             std::vector<POINT_3D> m_vertex;
+
+            /**
+             * @brief vertices in meters relative to m_vertex[0]. Calculated by parse.
+             * 
+             */
+            std::vector<POINT_LOCAL> m_vertex_local;
+            LOCAL_EDGES m_edges;
     };
 
 
@@ -166,10 +280,18 @@ namespace geofence
         
             void parse (const Json_de& message)override;
             double isInside(double lat, double lng, double alt) const override;
+            bool testSegment (const double lat1, const double lng1, const double lat2, const double lng2, double& distance, bool& fully_inside) const override;
             Json_de getMessage() override;
 
         protected:
             std::vector<POINT_3D> m_vertex;
+
+            /**
+             * @brief vertices in meters relative to m_vertex[0]. Calculated by parse.
+             * 
+             */
+            std::vector<POINT_LOCAL> m_vertex_local;
+            LOCAL_EDGES m_edges;
             /**
              * @brief in meters
              * 
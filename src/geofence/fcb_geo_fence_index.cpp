@@ -0,0 +1,125 @@
+#include <cmath>
+#include <algorithm>
+
+#include "../geofence/fcb_geo_fence_index.hpp"
+
+
+using namespace de::fcb::geofence;
+
+
+void CGeoFenceGridIndex::clear ()
+{
+    m_boxes.clear();
+    m_cells.clear();
+    m_large_boxes.clear();
+    m_query_stamps.clear();
+    m_query_stamp = 0;
+    m_cell_size = GEO_FENCE_INDEX_MAX_CELL_SIZE;
+}
+
+
+void CGeoFenceGridIndex::build (const std::vector<T_GEO_BOUNDING_BOX>& boxes)
+{
+    clear();
+
+    m_boxes = boxes;
+    if (m_boxes.empty()) return ;
+
+    m_query_stamps.assign(m_boxes.size(), 0);
+
+    double total_size = 0;
+    for (const T_GEO_BOUNDING_BOX& box : m_boxes)
+    {
+        total_size += std::max(box.max_latitude - box.min_latitude, box.max_longitude - box.min_longitude);
+    }
+    m_cell_size = std::min(GEO_FENCE_INDEX_MAX_CELL_SIZE, std::max(GEO_FENCE_INDEX_MIN_CELL_SIZE, total_size / m_boxes.size()));
+
+    const int count = m_boxes.size();
+    for (int i = 0; i < count; ++i)
+    {
+        const T_GEO_BOUNDING_BOX& box = m_boxes[i];
+        const int32_t min_lat_cell = getCell(box.min_latitude);
+        const int32_t max_lat_cell = getCell(box.max_latitude);
+        const int32_t min_lng_cell = getCell(box.min_longitude);
+        const int32_t max_lng_cell = getCell(box.max_longitude);
+
+        if ((int64_t) (max_lat_cell - min_lat_cell + 1) * (max_lng_cell - min_lng_cell + 1) > GEO_FENCE_INDEX_MAX_CELLS)
+        {
+            m_large_boxes.push_back(i);
+            continue;
+        }
+
+        for (int32_t lat_cell = min_lat_cell; lat_cell <= max_lat_cell; ++lat_cell)
+        {
+            for (int32_t lng_cell = min_lng_cell; lng_cell <= max_lng_cell; ++lng_cell)
+            {
+                m_cells[getKey(lat_cell, lng_cell)].push_back(i);
+            }
+        }
+    }
+}
+
+
+void CGeoFenceGridIndex::query (const double lat, const double lng, std::vector<int>& candidates) const
+{
+    candidates.clear();
+
+    T_GEO_BOUNDING_BOX point;
+    point.min_latitude = point.max_latitude = lat;
+    point.min_longitude = point.max_longitude = lng;
+
+    const auto cell = m_cells.find(getKey(getCell(lat), getCell(lng)));
+    if (cell != m_cells.end())
+    {
+        for (const int i : cell->second)
+        {
+            if (m_boxes[i].contains(point)) candidates.push_back(i);
+        }
+    }
+
+    for (const int i : m_large_boxes)
+    {
+        if (m_boxes[i].contains(point)) candidates.push_back(i);
+    }
+}
+
+
+void CGeoFenceGridIndex::query (const T_GEO_BOUNDING_BOX& box, std::vector<int>& candidates) const
+{
+    candidates.clear();
+    if (m_boxes.empty()) return ;
+
+    const int32_t min_lat_cell = getCell(box.min_latitude);
+    const int32_t max_lat_cell = getCell(box.max_latitude);
+    const int32_t min_lng_cell = getCell(box.min_longitude);
+    const int32_t max_lng_cell = getCell(box.max_longitude);
+
+    // a box is listed in each cell it covers.
+    if (++m_query_stamp == 0)
+    {
+        std::fill(m_query_stamps.begin(), m_query_stamps.end(), 0);
+        m_query_stamp = 1;
+    }
+
+    for (int32_t lat_cell = min_lat_cell; lat_cell <= max_lat_cell; ++lat_cell)
+    {
+        for (int32_t lng_cell = min_lng_cell; lng_cell <= max_lng_cell; ++lng_cell)
+        {
+            const auto cell = m_cells.find(getKey(lat_cell, lng_cell));
+            if (cell == m_cells.end()) continue;
+
+            for (const int i : cell->second)
+            {
+                if (m_query_stamps[i] == m_query_stamp) continue;
+
+                m_query_stamps[i] = m_query_stamp;
+                if (m_boxes[i].intersects(box)) candidates.push_back(i);
+            }
+        }
+    }
+
+    for (const int i : m_large_boxes)
+    {
+        if (m_boxes[i].intersects(box)) candidates.push_back(i);
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef FCB_GEO_FENCE_INDEX_H_
+#define FCB_GEO_FENCE_INDEX_H_
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cmath>
+
+#include "../geofence/fcb_geo_fence_base.hpp"
+
+
+// min & max grid cell size in degrees.
+#define GEO_FENCE_INDEX_MIN_CELL_SIZE   0.001
+#define GEO_FENCE_INDEX_MAX_CELL_SIZE   1.0
+// fences covering more cells are tested on every query instead.
+#define GEO_FENCE_INDEX_MAX_CELLS       64
+
+namespace de
+{
+namespace fcb
+{
+namespace geofence
+{
+
+    /**
+     * @brief uniform lat/lng grid of fence bounding boxes.
+     * @details Each fence is listed in every cell its bounding box covers.
+     * A query returns only fences whose bounding box contains the point so that
+     * isInside() is called for nearby fences only.
+     * Cell size is the mean fence size so a fence covers few cells.
+     *
+     */
+    class CGeoFenceGridIndex
+    {
+        public:
+
+            void build (const std::vector<T_GEO_BOUNDING_BOX>& boxes);
+            void clear ();
+
+            /**
+             * @brief indices of boxes that contain point.
+             *
+             */
+            void query (const double lat, const double lng, std::vector<int>& candidates) const;
+
+            /**
+             * @brief indices of boxes that intersect box.
+             * Not reentrant as it marks found boxes in m_query_stamps.
+             *
+             */
+            void query (const T_GEO_BOUNDING_BOX& box, std::vector<int>& candidates) const;
+
+        protected:
+
+            inline int32_t getCell (const double degrees) const
+            {
+                return (int32_t) floor(degrees / m_cell_size);
+            }
+
+            inline static int64_t getKey (const int32_t lat_cell, const int32_t lng_cell)
+            {
+                return ((int64_t) lat_cell << 32) | (uint32_t) lng_cell;
+            }
+
+        private:
+
+            std::vector<T_GEO_BOUNDING_BOX> m_boxes;
+            std::unordered_map<int64_t, std::vector<int>> m_cells;
+
+            /**
+             * @brief boxes that cover more than GEO_FENCE_INDEX_MAX_CELLS cells.
+             *
+             */
+            std::vector<int> m_large_boxes;
+
+            /**
+             * @brief box is already found by current query if its stamp equals m_query_stamp.
+             * Boxes listed in several cells are added once without allocating a set per query.
+             *
+             */
+            mutable std::vector<uint32_t> m_query_stamps;
+            mutable uint32_t m_query_stamp = 0;
+
+            double m_cell_size = GEO_FENCE_INDEX_MAX_CELL_SIZE;
+    };
+
+}
+}
+}
+
+#endif
@@ -1,3 +1,6 @@
+#include <cmath>
+#include <algorithm>
+
 #include "../de_common/helpers/colors.hpp"
 #include "../de_common/helpers/helpers.hpp"
 
@@ -7,9 +10,13 @@
 #include "../geofence/fcb_geo_fence_manager.hpp"
 #include "../fcb_traffic_optimizer.hpp"
 #include "../mission/missions.hpp"
+#include "../mission/mission_manager.hpp"
 #include "../fcb_facade.hpp"
 #include "../fcb_main.hpp"
 
+#include <mavlink_waypoint_manager.h>
+#include <mavlink_parameter_manager.h>
+
 
 using namespace de::fcb::geofence;
 
@@ -50,6 +57,7 @@ void CGeoFenceManager::attachToGeoFence (const std::string party_id, GEO_FENCE_S
     geo_fence_party_status.get()->party_id = party_id;
     geo_fence_struct->parties.push_back(std::move(geo_fence_party_status));
     geo_fence_struct->local_index = getIndexOfPartyInGeoFence(m_fcbMain.getAndruavVehicleInfo().party_id, geo_fence_struct);
+    invalidateGeoFenceIndex();
     //TODO: Test if inzone or violates 
     //TODO: send fence
     //TODO: send Hit Status
@@ -77,6 +85,7 @@ void CGeoFenceManager::detachFromGeoFence (const std::string& party_id, GEO_FENC
         {
             geo_fence_struct->parties.erase(geo_fence_struct->parties.begin() + i);
             geo_fence_struct->local_index = getIndexOfPartyInGeoFence(m_fcbMain.getAndruavVehicleInfo().party_id, geo_fence_struct);
+            invalidateGeoFenceIndex();
             return ;
         }
     }
@@ -189,6 +198,12 @@ void CGeoFenceManager::clearGeoFences (const std::string& geo_fence_name)
         // otherwise remove all
         m_geo_fences.get()->clear();
     }
+
+    invalidateGeoFenceIndex();
+
+    uploadFencesToFCB();
+
+    validateMission();
 }
 
 
@@ -218,6 +233,8 @@ void CGeoFenceManager::uploadFencesIntoSystem (const Json_de& plan_object)
                     std::cout << m_fcbMain.getAndruavVehicleInfo().party_id << std::endl;
                     attachToGeoFence(m_fcbMain.getAndruavVehicleInfo().party_id, json_fence["n"].get<std::string>());
                 }
+
+                uploadFencesToFCB();
             }
        }
     }
@@ -228,10 +245,192 @@ void CGeoFenceManager::uploadFencesIntoSystem (const Json_de& plan_object)
 }
 
 
+void CGeoFenceManager::uploadFencesToFCB ()
+{
+    // fences stay checked by DE.
+    if (!m_fcb_fence_upload_enabled) return ;
+
+    std::map <int, mavlink_mission_item_int_t> mavlink_fence;
+    std::vector<std::string> fence_names;
+
+    std::vector<geofence::GEO_FENCE_STRUCT*> geo_fence_struct_list = getFencesOfParty(m_fcbMain.getAndruavVehicleInfo().party_id);
+    for (geofence::GEO_FENCE_STRUCT* geo_fence_struct : geo_fence_struct_list)
+    {
+        geo_fence_struct->fcb_enforced = false;
+        
+        de::fcb::geofence::CGeoFenceBase * geo_fence = geo_fence_struct->geoFence.get();
+        // FCB takes its own FENCE_ACTION on breach so soft fences stay here.
+        if (geo_fence->hardFenceAction() == CONST_FENCE_ACTION_SOFT) continue;
+
+        std::vector<mavlink_mission_item_int_t> mission_items;
+        if (!geo_fence->getMavlinkFenceItems(mission_items)) continue;
+
+        for (mavlink_mission_item_int_t& mission_item_int : mission_items)
+        {
+            mission_item_int.seq = mavlink_fence.size();
+            mavlink_fence.insert(std::make_pair(mission_item_int.seq, mission_item_int));
+        }
+        fence_names.push_back(geo_fence->getName());
+    }
+
+    // nothing to add or remove.
+    if (mavlink_fence.empty() && !m_fcb_fence_uploaded) return ;
+
+    m_fcb_fence_names = fence_names;
+    m_fcb_fence_items = mavlink_fence;
+    m_fcb_fence_uploaded = !mavlink_fence.empty();
+
+    std::cout << _INFO_CONSOLE_BOLD_TEXT << "Upload fences to FCB: " << std::to_string(fence_names.size()) << " fences " << std::to_string(mavlink_fence.size()) << " items" << _NORMAL_CONSOLE_TEXT_ << std::endl;
+
+    mavlinksdk::CMavlinkWayPointManager::getInstance().saveWayPoints(mavlink_fence, MAV_MISSION_TYPE_FENCE, 
+        [this](const int result, const std::map <int, mavlink_mission_item_int_t>& fence_items)
+        {
+            onFCBFencesUploaded(result, fence_items);
+        });
+}
+
+
+void CGeoFenceManager::onFCBFencesUploaded (const int result, const std::map <int, mavlink_mission_item_int_t>& mavlink_fence)
+{
+    if (result != MAV_MISSION_ACCEPTED)
+    {
+        m_fcb_fence_names.clear();
+        m_fcb_fence_items.clear();
+        m_fcb_fence_uploaded = true; // state of FCB fence is unknown.
+        m_fcb_facade.sendErrorMessage(std::string(ANDRUAV_PROTOCOL_SENDER_ALL_GCS), 0, ERROR_GEO_FENCE_ERROR, NOTIFICATION_TYPE_WARNING, "FCB rejected fences. Fences are checked by DE.");
+        return ;
+    }
+
+    if (mavlink_fence.empty()) return ;
+
+    // read back to make sure FCB stores what has been sent.
+    mavlinksdk::CMavlinkWayPointManager::getInstance().readWayPoints(MAV_MISSION_TYPE_FENCE, 
+        [this](const int result, const std::map <int, mavlink_mission_item_int_t>& fence_items)
+        {
+            onFCBFencesVerified(result, fence_items);
+        });
+}
+
+
+void CGeoFenceManager::onFCBFencesVerified (const int result, const std::map <int, mavlink_mission_item_int_t>& mavlink_fence)
+{
+    if ((result != MAV_MISSION_ACCEPTED) || (mavlink_fence.size() != m_fcb_fence_items.size())) return ;
+
+    auto fcb_item = mavlink_fence.cbegin();
+    for (auto item = m_fcb_fence_items.cbegin(); item != m_fcb_fence_items.cend(); ++item, ++fcb_item)
+    {
+        if (!mavlinksdk::CMavlinkWayPointManager::isSameMissionItem(item->second, fcb_item->second)) return ;
+    }
+
+    for (const std::string& fence_name : m_fcb_fence_names)
+    {
+        GEO_FENCE_STRUCT * geo_fence_struct = getFenceByName(fence_name);
+        if (geo_fence_struct == nullptr) continue;
+        geo_fence_struct->fcb_enforced = true;
+    }
+
+    std::cout << _SUCCESS_CONSOLE_BOLD_TEXT_ << "Fences verified on FCB: " << std::to_string(m_fcb_fence_names.size()) << _NORMAL_CONSOLE_TEXT_ << std::endl;
+}
+
+
+/**
+ * @brief mission legs are tested against my fences once per mission or fence change.
+ * Only first violations are listed to GCS followed by a summary.
+ * 
+ */
+void CGeoFenceManager::validateMission ()
+{
+    const std::shared_ptr<const de::fcb::mission::CMissionGeometry> mission_geometry = de::fcb::mission::CMissionManager::getInstance().getMissionGeometry();
+    const std::vector<de::fcb::mission::T_MISSION_LEG>& legs = mission_geometry->getLegs();
+    
+    std::vector<CGeoFenceBase*> fences;
+    const std::vector<GEO_FENCE_STRUCT*> fence_structs = getFencesOfParty(m_fcbMain.getAndruavVehicleInfo().party_id);
+    fences.reserve(fence_structs.size());
+    for (GEO_FENCE_STRUCT* geo_fence_struct : fence_structs)
+    {
+        if (geo_fence_struct->geoFence) fences.push_back(geo_fence_struct->geoFence.get());
+    }
+
+    CGeoFenceMissionValidator validator;
+    validator.validate(legs, fences, m_mission_violations);
+
+    #ifdef DEBUG
+        std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: validateMission legs:" << std::to_string(legs.size()) << " fences:" << std::to_string(fences.size()) << " violations:" << std::to_string(m_mission_violations.size()) << _NORMAL_CONSOLE_TEXT_ << std::endl;
+    #endif
+
+    if (m_mission_violations.empty()) return ;
+
+    const std::size_t max_reported = std::min<std::size_t>(m_mission_violations.size(), MAX_REPORTED_MISSION_VIOLATIONS);
+    for (std::size_t i = 0; i < max_reported; ++i)
+    {
+        const T_MISSION_FENCE_VIOLATION& violation = m_mission_violations[i];
+        std::string error_str = "mission item " + std::to_string(violation.seq);
+        if (violation.altitude)
+        {
+            error_str += " out of altitude of fence " + violation.fence_name;
+        }
+        else if (violation.distance <= 0)
+        {
+            error_str += " enters fence " + violation.fence_name;
+        }
+        else
+        {
+            error_str += " is " + std::to_string((int) violation.distance) + "m outside fence " + violation.fence_name;
+        }
+        m_fcb_facade.sendErrorMessage(std::string(ANDRUAV_PROTOCOL_SENDER_ALL_GCS), 0, ERROR_GEO_FENCE_ERROR, NOTIFICATION_TYPE_WARNING, error_str);
+    }
+
+    if (m_mission_violations.size() > max_reported)
+    {
+        m_fcb_facade.sendErrorMessage(std::string(ANDRUAV_PROTOCOL_SENDER_ALL_GCS), 0, ERROR_GEO_FENCE_ERROR, NOTIFICATION_TYPE_WARNING, "mission has " + std::to_string(m_mission_violations.size()) + " fence violations");
+    }
+}
+
+
+/**
+ * @brief FCB enforces polygon & circle fences only when FENCE_ENABLE is set and FENCE_TYPE includes polygon.
+ * 
+ */
+bool CGeoFenceManager::isFCBFenceEnabled () const
+{
+    const mavlinksdk::CMavlinkParameterManager& parameter_manager = mavlinksdk::CMavlinkParameterManager::getInstance();
+    int32_t fence_enable, fence_type;
+    if (!parameter_manager.getParameterValue("FENCE_ENABLE", fence_enable)) return false;
+    if (!parameter_manager.getParameterValue("FENCE_TYPE", fence_type)) return false;
+
+    return (fence_enable == 1) && ((fence_type & 4) == 4);
+}
+
+
+void CGeoFenceManager::updateGeoFenceIndex ()
+{
+    const std::string& party_id = m_fcbMain.getAndruavVehicleInfo().party_id;
+    if (m_fence_index_valid && (m_indexed_party_id == party_id)) return ;
+
+    m_indexed_fences = getFencesOfParty(party_id);
+    m_indexed_party_id = party_id;
+    m_fence_index_valid = true;
+
+    const std::size_t size = m_indexed_fences.size();
+    std::vector<T_GEO_BOUNDING_BOX> boxes;
+    boxes.reserve(size);
+    m_active_fences.clear();
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        boxes.push_back(m_indexed_fences[i]->geoFence->getBoundingBox());
+        // test all fences once after change.
+        m_active_fences.push_back(i);
+    }
+    m_fence_index.build(boxes);
+    m_fence_tested.assign(size, false);
+}
+
+
 /**
  * @brief review status of each attached geo fence
  * 
- * @details each attached geo fence is called isInside() and based on result global fence status is calculated.
+ * @details isInside() is called for fences whose bounding box contains vehicle and fences that vehicle was inside.
+ * Other fences are outside and their status has not changed. Based on result global fence status is calculated.
  * also status is sent to other parties using update hit status. Actions is taken when hard fences are violated.
  * 
  */
@@ -244,22 +443,64 @@ void CGeoFenceManager::updateGeoFenceHitStatus()
 	*/
 	int total_violation = 0b000;
 
-    std::vector<geofence::GEO_FENCE_STRUCT*> geo_fence_struct_list = geofence::CGeoFenceManager::getInstance().getFencesOfParty(m_fcbMain.getAndruavVehicleInfo().party_id);
-        
-    const std::size_t size = geo_fence_struct_list.size();
+    updateGeoFenceIndex();
 
     mavlinksdk::CVehicle&  vehicle =  mavlinksdk::CVehicle::getInstance();
 
     const mavlink_global_position_int_t&  gpos = vehicle.getMsgGlobalPositionInt();
+    const double lat = gpos.lat / 10000000.0;
+    const double lng = gpos.lon / 10000000.0;
+    // fence altitude limits are above home.
+    const double alt = gpos.relative_alt / 1000.0;
+
+    // ground velocity. vx is north & vy is east in cm/s.
+    const double speed = sqrt((double) gpos.vx * gpos.vx + (double) gpos.vy * gpos.vy) / 100.0;
+    const double bearing = getBearingOfVector(gpos.vx, gpos.vy);
+    const bool predict = (speed >= GEO_FENCE_BREACH_MIN_SPEED);
+
+    const bool fcb_fence_enabled = isFCBFenceEnabled();
+
+    // fences that vehicle can reach within GEO_FENCE_BREACH_HORIZON and fences I was inside.
+    T_GEO_BOUNDING_BOX reach_box;
+    reach_box.min_latitude = reach_box.max_latitude = lat;
+    reach_box.min_longitude = reach_box.max_longitude = lng;
+    if (predict)
+    {
+        const POINT_2D horizon = get_point_at_bearing(lat, lng, bearing, speed * GEO_FENCE_BREACH_HORIZON);
+        reach_box.min_latitude = std::min(lat, horizon.latitude);
+        reach_box.max_latitude = std::max(lat, horizon.latitude);
+        reach_box.min_longitude = std::min(lng, horizon.longitude);
+        reach_box.max_longitude = std::max(lng, horizon.longitude);
+    }
+    m_fence_index.query(reach_box, m_candidate_fences);
+    m_candidate_fences.insert(m_candidate_fences.end(), m_active_fences.begin(), m_active_fences.end());
+    m_active_fences.clear();
 
-    // test each fence and check if inside or not.
-    for(int i = 0; i < size; i++)
+    // test each candidate fence and check if inside or not.
+    for (const int i : m_candidate_fences)
     {
-        de::fcb::geofence::GEO_FENCE_STRUCT * g = geo_fence_struct_list[i];
+        if (m_fence_tested[i]) continue;
+        m_fence_tested[i] = true;
+
+        de::fcb::geofence::GEO_FENCE_STRUCT * g = m_indexed_fences[i];
+        // breach is detected & handled by FCB.
+        // kept active to be tested if FCB fence is disabled.
+        if (fcb_fence_enabled && g->fcb_enforced)
+        {
+            m_active_fences.push_back(i);
+            continue;
+        }
+        
         de::fcb::geofence::CGeoFenceBase * geo_fence = g->geoFence.get();
-        const int local_index = geo_fence_struct_list[i]->local_index;
-        double current_position_in_zone = geo_fence->isInside(gpos.lat / 10000000.0f, gpos.lon / 10000000.0f, gpos.alt);
+        const int local_index = g->local_index;
+        double current_position_in_zone = geo_fence->isInside(lat, lng, alt);
         double previous_position_in_zone = g->parties[local_index].get()->in_zone;
+        GEO_FENCE_PARTY_STATUS * party_status = g->parties[local_index].get();
+
+        if ((current_position_in_zone <= 0) || (party_status->breach_level != BREACH_NONE))
+        {
+            m_active_fences.push_back(i);
+        }
         
         if ((previous_position_in_zone == -INFINITY) || (signum(current_position_in_zone) != signum(previous_position_in_zone)))
         {
@@ -297,9 +538,137 @@ void CGeoFenceManager::updateGeoFenceHitStatus()
                                         geo_fence->shouldKeepOutside());
         }
 
+        // predict crossing into a keep-outside fence or out of a keep-inside fence.
+        // prediction is horizontal so vehicle should be within fence altitude band.
+        double floor, ceiling;
+        const bool out_of_band = geo_fence->getAltitudeLimits(floor, ceiling) && ((alt < floor) || (alt > ceiling));
+        double time_to_breach = INFINITY;
+        if (predict && !out_of_band && (geo_fence->shouldKeepOutside() == (current_position_in_zone > 0)))
+        {
+            time_to_breach = predictTimeToBreach(geo_fence, lat, lng, bearing, speed);
+        }
+        handleFenceBreachPrediction(geo_fence, party_status, time_to_breach);
+    }
+
+    for (const int i : m_candidate_fences)
+    {
+        m_fence_tested[i] = false;
+    }
+}
+
+void CGeoFenceManager::onPositionUpdated ()
+{
+    updateGeoFenceHitStatusAfter(GEO_FENCE_MIN_UPDATE_INTERVAL);
+}
+
+
+void CGeoFenceManager::onSchedulerUpdate ()
+{
+    // last known position is evaluated when FCB stops sending GLOBAL_POSITION_INT.
+    updateGeoFenceHitStatusAfter(GEO_FENCE_MAX_UPDATE_INTERVAL);
+}
+
+
+void CGeoFenceManager::updateGeoFenceHitStatusAfter (const uint64_t interval)
+{
+    const std::lock_guard<std::mutex> lock(m_hit_update_lock);
+
+    const uint64_t now = get_time_usec();
+    if ((now - m_last_hit_update_time) < interval) return ;
+
+    m_last_hit_update_time = now;
+    
+    updateGeoFenceHitStatus();
+}
+
+
+/**
+ * @brief seconds before vehicle crosses fence boundary if it keeps its bearing & speed.
+ * @details path from current position is a segment that grows with time so once it crosses boundary
+ * it remains crossing. Time is found by bisection of path length.
+ * 
+ * @return time in seconds or INFINITY if no crossing within GEO_FENCE_BREACH_HORIZON.
+ */
+double CGeoFenceManager::predictTimeToBreach (geofence::CGeoFenceBase* geo_fence, const double lat, const double lng, const double bearing, const double speed) const
+{
+    const bool keep_outside = geo_fence->shouldKeepOutside();
+
+    auto isBreached = [&](const double time)
+    {
+        const POINT_2D point = get_point_at_bearing(lat, lng, bearing, speed * time);
+        double distance;
+        bool fully_inside;
+        if (!geo_fence->testSegment(lat, lng, point.latitude, point.longitude, distance, fully_inside)) return false;
+
+        return keep_outside ? (distance <= 0) : !fully_inside;
+    };
+
+    if (!isBreached(GEO_FENCE_BREACH_HORIZON)) return INFINITY;
+
+    double time_safe = 0;
+    double time_breached = GEO_FENCE_BREACH_HORIZON;
+    for (int i = 0; i < GEO_FENCE_BREACH_ITERATIONS; ++i)
+    {
+        const double time = (time_safe + time_breached) / 2;
+        if (isBreached(time))
+        {
+            time_breached = time;
+        }
+        else
+        {
+            time_safe = time;
+        }
+    }
+
+    return time_breached;
+}
+
+
+/**
+ * @brief warns GCS each time predicted breach gets nearer to a higher level.
+ * 
+ */
+void CGeoFenceManager::handleFenceBreachPrediction (geofence::CGeoFenceBase* geo_fence, GEO_FENCE_PARTY_STATUS* party_status, const double time_to_breach)
+{
+    ENUM_GEO_FENCE_BREACH_LEVEL breach_level = BREACH_NONE;
+    if (time_to_breach <= GEO_FENCE_BREACH_IMMINENT_TIME)
+    {
+        breach_level = BREACH_IMMINENT;
+    }
+    else if (time_to_breach <= GEO_FENCE_BREACH_WARNING_TIME)
+    {
+        breach_level = BREACH_NEAR;
     }
+    else if (time_to_breach <= GEO_FENCE_BREACH_HORIZON)
+    {
+        breach_level = BREACH_PREDICTED;
+    }
+
+    const ENUM_GEO_FENCE_BREACH_LEVEL previous_level = party_status->breach_level;
+    party_status->time_to_breach = time_to_breach;
+    party_status->breach_level = breach_level;
+
+    if (breach_level <= previous_level) return ;
+
+    int notification_type;
+    switch (breach_level)
+    {
+        case BREACH_IMMINENT:
+            notification_type = NOTIFICATION_TYPE_ERROR;
+            break;
+        case BREACH_NEAR:
+            notification_type = NOTIFICATION_TYPE_WARNING;
+            break;
+        default:
+            notification_type = NOTIFICATION_TYPE_NOTICE;
+            break;
+    }
+
+    std::string error_str = "fence " + std::string(geo_fence->getName()) + " breach in " + std::to_string((int) ceil(time_to_breach)) + "s";
+    m_fcb_facade.sendErrorMessage(std::string(ANDRUAV_PROTOCOL_SENDER_ALL_GCS), 0, ERROR_GEO_FENCE_ERROR, notification_type, error_str);
 }
 
+
 void CGeoFenceManager::handleFenceViolation(geofence::CGeoFenceBase* geo_fence) {
     std::string error_str = "violate fence " + std::string(geo_fence->getName());
     m_fcb_facade.sendErrorMessage(std::string(ANDRUAV_PROTOCOL_SENDER_ALL_GCS), 0, ERROR_GEO_FENCE_ERROR, NOTIFICATION_TYPE_ERROR, error_str);
@@ -4,9 +4,25 @@
 
 #include <map>
 #include <vector>
+#include <mutex>
 #include <mavlink_sdk.h>
 
 #include "../geofence/fcb_geo_fence_base.hpp"
+#include "../geofence/fcb_geo_fence_mission_validator.hpp"
+#include "../geofence/fcb_geo_fence_index.hpp"
+
+// min interval between fence evaluations triggered by position messages [us]
+#define GEO_FENCE_MIN_UPDATE_INTERVAL   100000
+// fences are evaluated by scheduler if no position message arrived for this interval [us]
+#define GEO_FENCE_MAX_UPDATE_INTERVAL   1000000
+// vehicle position is projected along its velocity up to this time [s]
+#define GEO_FENCE_BREACH_HORIZON        30.0
+#define GEO_FENCE_BREACH_WARNING_TIME   10.0
+#define GEO_FENCE_BREACH_IMMINENT_TIME  3.0
+// no prediction below this ground speed [m/s]
+#define GEO_FENCE_BREACH_MIN_SPEED      0.5
+// bisection steps of time to breach. resolution is GEO_FENCE_BREACH_HORIZON / 2^steps
+#define GEO_FENCE_BREACH_ITERATIONS     8
 
 namespace de
 {
@@ -14,6 +30,14 @@ namespace fcb
 {
 namespace geofence
 {
+    typedef enum ENUM_GEO_FENCE_BREACH_LEVEL
+    {
+        BREACH_NONE         = 0,
+        BREACH_PREDICTED    = 1,    // within GEO_FENCE_BREACH_HORIZON
+        BREACH_NEAR         = 2,    // within GEO_FENCE_BREACH_WARNING_TIME
+        BREACH_IMMINENT     = 3     // within GEO_FENCE_BREACH_IMMINENT_TIME
+    } ENUM_GEO_FENCE_BREACH_LEVEL;
+
     /**
      * @brief Attached unit status
      * 
@@ -27,6 +51,11 @@ namespace geofence
          */
         double in_zone=-INFINITY; 
         bool violation = false;
+        /**
+         * @brief predicted seconds before vehicle crosses fence. INFINITY if no crossing is predicted.
+         */
+        double time_to_breach = INFINITY;
+        ENUM_GEO_FENCE_BREACH_LEVEL breach_level = BREACH_NONE;
     } GEO_FENCE_PARTY_STATUS;
 
     /**
@@ -38,6 +67,11 @@ namespace geofence
         std::unique_ptr<de::fcb::geofence::CGeoFenceBase> geoFence;
         std::vector<std::unique_ptr<GEO_FENCE_PARTY_STATUS>> parties;
         int local_index;
+        /**
+         * @brief fence is uploaded to FCB as fence items and verified. 
+         * FCB checks it at its loop rate so it is not polled.
+         */
+        bool fcb_enforced = false;
     } GEO_FENCE_STRUCT;
 
     class CGeoFenceManager
@@ -91,9 +125,63 @@ namespace geofence
                 void uploadFencesIntoSystem (const Json_de& plan_object);
                 
                 void updateGeoFenceHitStatus();
+
+                /**
+                 * @brief called on each GLOBAL_POSITION_INT. Fences are evaluated at most every GEO_FENCE_MIN_UPDATE_INTERVAL.
+                 * 
+                 */
+                void onPositionUpdated ();
+
+                /**
+                 * @brief called by scheduler. Fences are evaluated if no position update arrived for GEO_FENCE_MAX_UPDATE_INTERVAL.
+                 * 
+                 */
+                void onSchedulerUpdate ();
+
+                /**
+                 * @brief compile my hard fences into MAV_MISSION_TYPE_FENCE items, upload them to FCB and read them back to verify.
+                 * Does nothing unless enabled by enableFCBFenceUpload, as it replaces fences stored on FCB.
+                 * 
+                 */
+                void uploadFencesToFCB ();
+
+                inline void enableFCBFenceUpload (const bool enable)
+                {
+                    m_fcb_fence_upload_enabled = enable;
+                }
+
+                /**
+                 * @brief check current mission legs against my fences and warn GCS of legs that cross them.
+                 * 
+                 */
+                void validateMission ();
+
+                inline const std::vector<T_MISSION_FENCE_VIOLATION>& getMissionViolations () const
+                {
+                    return m_mission_violations;
+                }
                 
             protected:
 
+                bool isFCBFenceEnabled () const;
+
+                /**
+                 * @brief rebuild index of my fences if fences or party changed.
+                 * 
+                 */
+                void updateGeoFenceIndex ();
+                
+                inline void invalidateGeoFenceIndex ()
+                {
+                    m_fence_index_valid = false;
+                }
+
+                void onFCBFencesUploaded (const int result, const std::map <int, mavlink_mission_item_int_t>& mavlink_fence);
+                void onFCBFencesVerified (const int result, const std::map <int, mavlink_mission_item_int_t>& mavlink_fence);
+
+                double predictTimeToBreach (geofence::CGeoFenceBase* geo_fence, const double lat, const double lng, const double bearing, const double speed) const;
+                void handleFenceBreachPrediction (geofence::CGeoFenceBase* geo_fence, GEO_FENCE_PARTY_STATUS* party_status, const double time_to_breach);
+
                 void handleFenceViolation(geofence::CGeoFenceBase* geo_fence);
                 void handleFenceEntry(geofence::CGeoFenceBase* geo_fence);
                 void takeActionOnFenceViolation(de::fcb::geofence::CGeoFenceBase * geo_fence);
@@ -102,6 +190,45 @@ namespace geofence
             protected:
 
                 std::unique_ptr <std::map<std::string,std::unique_ptr<GEO_FENCE_STRUCT>>>  m_geo_fences;
+
+                /**
+                 * @brief fences & items of last upload to FCB.
+                 * 
+                 */
+                std::vector<std::string> m_fcb_fence_names;
+                std::map <int, mavlink_mission_item_int_t> m_fcb_fence_items;
+                bool m_fcb_fence_uploaded = false;
+                bool m_fcb_fence_upload_enabled = false;
+
+                /**
+                 * @brief result of last validateMission.
+                 * 
+                 */
+                std::vector<T_MISSION_FENCE_VIOLATION> m_mission_violations;
+
+                /**
+                 * @brief my fences and a grid of their bounding boxes used by updateGeoFenceHitStatus.
+                 * 
+                 */
+                std::vector<GEO_FENCE_STRUCT*> m_indexed_fences;
+                CGeoFenceGridIndex m_fence_index;
+                std::string m_indexed_party_id;
+                bool m_fence_index_valid = false;
+
+                /**
+                 * @brief indices in m_indexed_fences of fences that vehicle is inside or not tested yet.
+                 * They are tested even if vehicle is out of their bounding box to detect exit.
+                 * 
+                 */
+                std::vector<int> m_active_fences;
+                std::vector<int> m_candidate_fences;
+                std::vector<bool> m_fence_tested;
+
+                void updateGeoFenceHitStatusAfter (const uint64_t interval);
+
+                // position updates & scheduler evaluate fences from different threads.
+                std::mutex m_hit_update_lock;
+                uint64_t m_last_hit_update_time = 0;
     };
 }
 }
@@ -0,0 +1,154 @@
+#include <cmath>
+#include <algorithm>
+
+#include "../de_common/de_databus/messages.hpp"
+#include "../geofence/fcb_geo_fence_mission_validator.hpp"
+
+
+using namespace de::fcb::geofence;
+
+
+typedef struct T_VALIDATION_FENCE
+{
+    CGeoFenceBase* fence;
+    T_GEO_BOUNDING_BOX box;
+    bool has_altitude_limits;
+    double floor;
+    double ceiling;
+} T_VALIDATION_FENCE;
+
+
+static T_VALIDATION_FENCE getValidationFence (CGeoFenceBase* fence)
+{
+    T_VALIDATION_FENCE validation_fence;
+    validation_fence.fence = fence;
+    validation_fence.box = fence->getBoundingBox();
+    validation_fence.has_altitude_limits = fence->getAltitudeLimits(validation_fence.floor, validation_fence.ceiling);
+
+    return validation_fence;
+}
+
+
+void CGeoFenceMissionValidator::validate (const std::vector<de::fcb::mission::T_MISSION_LEG>& legs, const std::vector<CGeoFenceBase*>& fences, std::vector<T_MISSION_FENCE_VIOLATION>& violations) const
+{
+    violations.clear();
+
+    std::vector<T_VALIDATION_FENCE> exclusion_fences;
+    std::vector<T_VALIDATION_FENCE> inclusion_fences;
+    for (CGeoFenceBase* fence : fences)
+    {
+        if (fence == nullptr) continue;
+
+        if (fence->shouldKeepOutside())
+        {
+            exclusion_fences.push_back(getValidationFence(fence));
+        }
+        else
+        {
+            inclusion_fences.push_back(getValidationFence(fence));
+        }
+    }
+
+    // sorted by min latitude so fences north of a leg are never visited.
+    std::sort(exclusion_fences.begin(), exclusion_fences.end(), [](const T_VALIDATION_FENCE& a, const T_VALIDATION_FENCE& b)
+    {
+        return a.box.min_latitude < b.box.min_latitude;
+    });
+
+    const std::size_t leg_count = legs.size();
+    for (std::size_t i = 0; i < leg_count; ++i)
+    {
+        // first item is a point. its leg starts & ends at it.
+        const de::fcb::mission::T_MISSION_LEG& from = legs[(i == 0) ? 0 : i - 1];
+        const de::fcb::mission::T_MISSION_LEG& to = legs[i];
+
+        T_GEO_BOUNDING_BOX leg_box;
+        leg_box.min_latitude = std::min(from.latitude, to.latitude);
+        leg_box.max_latitude = std::max(from.latitude, to.latitude);
+        leg_box.min_longitude = std::min(from.longitude, to.longitude);
+        leg_box.max_longitude = std::max(from.longitude, to.longitude);
+        // leg & fence altitudes are meters above home. band is not checked if leg altitude is not known.
+        const bool has_altitude = !std::isnan(from.altitude) && !std::isnan(to.altitude);
+        const double min_altitude = std::min(from.altitude, to.altitude);
+        const double max_altitude = std::max(from.altitude, to.altitude);
+
+        double distance;
+        bool fully_inside;
+
+        // exclusion fences.
+        for (const T_VALIDATION_FENCE& validation_fence : exclusion_fences)
+        {
+            if (validation_fence.box.min_latitude > leg_box.max_latitude) break;
+            if (!validation_fence.box.intersects(leg_box)) continue;
+
+            if (has_altitude && validation_fence.has_altitude_limits
+                && ((max_altitude < validation_fence.floor) || (min_altitude > validation_fence.ceiling))) continue;
+
+            if (!validation_fence.fence->testSegment(from.latitude, from.longitude, to.latitude, to.longitude, distance, fully_inside)) continue;
+            if (distance > 0) continue;
+
+            T_MISSION_FENCE_VIOLATION violation;
+            violation.seq = to.seq;
+            violation.fence_name = validation_fence.fence->getName();
+            violation.distance = distance;
+            violation.altitude = false;
+            violations.push_back(violation);
+        }
+
+        // inclusion fences. leg should be inside any of them.
+        if (inclusion_fences.empty()) continue;
+
+        bool contained = false;
+        const T_VALIDATION_FENCE* altitude_fence = nullptr;
+        for (const T_VALIDATION_FENCE& validation_fence : inclusion_fences)
+        {
+            if (!validation_fence.box.contains(leg_box)) continue;
+            if (!validation_fence.fence->testSegment(from.latitude, from.longitude, to.latitude, to.longitude, distance, fully_inside)) continue;
+            if (!fully_inside) continue;
+
+            if (has_altitude && validation_fence.has_altitude_limits
+                && ((min_altitude < validation_fence.floor) || (max_altitude > validation_fence.ceiling)))
+            {
+                altitude_fence = &validation_fence;
+                continue;
+            }
+
+            contained = true;
+            break;
+        }
+
+        if (contained) continue;
+
+        T_MISSION_FENCE_VIOLATION violation;
+        violation.seq = to.seq;
+
+        if (altitude_fence != nullptr)
+        {
+            violation.fence_name = altitude_fence->fence->getName();
+            violation.distance = 0;
+            violation.altitude = true;
+            violations.push_back(violation);
+            continue;
+        }
+
+        // report nearest inclusion fence.
+        violation.distance = INFINITY;
+        violation.altitude = false;
+        for (const T_VALIDATION_FENCE& validation_fence : inclusion_fences)
+        {
+            if (!validation_fence.fence->testSegment(from.latitude, from.longitude, to.latitude, to.longitude, distance, fully_inside)) continue;
+
+            distance = std::max(distance, 0.0);
+            if (distance < violation.distance)
+            {
+                violation.distance = distance;
+                violation.fence_name = validation_fence.fence->getName();
+            }
+        }
+
+        if (violation.distance != INFINITY)
+        {
+            violations.push_back(violation);
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef FCB_GEO_FENCE_MISSION_VALIDATOR_H_
+#define FCB_GEO_FENCE_MISSION_VALIDATOR_H_
+
+#include <vector>
+#include <string>
+
+#include "../geofence/fcb_geo_fence_base.hpp"
+#include "../mission/mission_geometry.hpp"
+
+namespace de
+{
+namespace fcb
+{
+namespace geofence
+{
+
+    /**
+     * @brief mission leg that violates a fence.
+     *
+     */
+    typedef struct T_MISSION_FENCE_VIOLATION
+    {
+        int seq;                    // mission item at end of leg.
+        std::string fence_name;     // fence entered, or nearest inclusion fence if leg is not inside any of them.
+        double distance;            // [m] <= 0 depth into exclusion fence. >= 0 distance outside inclusion fences.
+        bool altitude;              // leg is inside fence area but outside its altitude limits.
+    } T_MISSION_FENCE_VIOLATION;
+
+
+    /**
+     * @brief checks mission legs against fences before flight.
+     * @details A leg violates an exclusion fence if it enters the fence area within fence altitude limits.
+     * A leg violates inclusion fences if no inclusion fence contains the whole leg.
+     * Leg altitudes are meters above home as fence altitude limits. Legs of unknown altitude
+     * e.g. terrain frames are tested as if they were within altitude limits.
+     * Fences are culled by bounding box and exclusion fences are sorted by latitude
+     * so each leg is tested only against fences around it.
+     *
+     */
+    class CGeoFenceMissionValidator
+    {
+        public:
+
+            void validate (const std::vector<de::fcb::mission::T_MISSION_LEG>& legs, const std::vector<CGeoFenceBase*>& fences, std::vector<T_MISSION_FENCE_VIOLATION>& violations) const;
+    };
+
+}
+}
+}
+
+#endif
@@ -5,6 +5,7 @@
 #include <algorithm>
 
 #include "gps.hpp"
+#include "gps_geodesy.hpp"
 
 #define PI 3.1415926535897932384626433832795
 #define RADIO_TERRESTRE 6372797.56085
@@ -139,7 +140,7 @@ double calculateBearing(const double& lat1, const double& lon1, const double& la
 
 
 
-double inPolygon(const double&  lat1, const double&  lon1, const std::vector<POINT_3D> points)
+double inPolygon(const double&  lat1, const double&  lon1, const std::vector<POINT_3D>& points)
 {
     const int nvert= points.size();
     int i, j, c = 0;
@@ -202,4 +203,91 @@ double findDistanceToSegment(const double& ptx, const double& pty, const double&
 {
     POINT_2D  closest = findIntersectionPoint(ptx, pty, p1x,p1y,p2x,p2y);
     return calcGPSDistance(ptx,pty,closest.latitude,closest.longitude);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief project point on a plane tangent at reference point (equirectangular).
+ * Accurate for distances of few kilometers which is the scale of fences & mission legs.
+ * 
+ * @return POINT_LOCAL x east & y north in meters.
+ */
+POINT_LOCAL toLocalPoint(const double& lat, const double& lon, const double& ref_lat, const double& ref_lon)
+{
+    POINT_LOCAL point;
+    point.x = calcLongitudeDifference(ref_lon, lon) * GRADOS_RADIANES * cos(ref_lat * GRADOS_RADIANES) * RADIO_TERRESTRE;
+    point.y = (lat - ref_lat) * GRADOS_RADIANES * RADIO_TERRESTRE;
+
+    return point;
+}
+
+
+double findDistanceToLocalSegment(const POINT_LOCAL& pt, const POINT_LOCAL& p1, const POINT_LOCAL& p2)
+{
+    const double dx = p2.x - p1.x;
+    const double dy = p2.y - p1.y;
+    const double length_sq = dx * dx + dy * dy;
+    
+    double t = 0;
+    if (length_sq > 0)
+    {
+        t = ((pt.x - p1.x) * dx + (pt.y - p1.y) * dy) / length_sq;
+        t = std::max(0.0, std::min(1.0, t));
+    }
+
+    const double ex = p1.x + t * dx - pt.x;
+    const double ey = p1.y + t * dy - pt.y;
+    
+    return sqrt(ex * ex + ey * ey);
+}
+
+
+static inline double cross(const POINT_LOCAL& o, const POINT_LOCAL& a, const POINT_LOCAL& b)
+{
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+
+bool doLocalSegmentsIntersect(const POINT_LOCAL& a1, const POINT_LOCAL& a2, const POINT_LOCAL& b1, const POINT_LOCAL& b2)
+{
+    const double d1 = cross(b1, b2, a1);
+    const double d2 = cross(b1, b2, a2);
+    const double d3 = cross(a1, a2, b1);
+    const double d4 = cross(a1, a2, b2);
+
+    if ((((d1 > 0) && (d2 < 0)) || ((d1 < 0) && (d2 > 0)))
+        && (((d3 > 0) && (d4 < 0)) || ((d3 < 0) && (d4 > 0))))
+    {
+        return true;
+    }
+
+    // touching or collinear segments.
+    return (findDistanceToLocalSegment(a1, b1, b2) == 0) || (findDistanceToLocalSegment(a2, b1, b2) == 0)
+        || (findDistanceToLocalSegment(b1, a1, a2) == 0) || (findDistanceToLocalSegment(b2, a1, a2) == 0);
+}
+
+
+double findDistanceBetweenLocalSegments(const POINT_LOCAL& a1, const POINT_LOCAL& a2, const POINT_LOCAL& b1, const POINT_LOCAL& b2)
+{
+    if (doLocalSegmentsIntersect(a1, a2, b1, b2)) return 0;
+
+    return std::min(std::min(findDistanceToLocalSegment(a1, b1, b2), findDistanceToLocalSegment(a2, b1, b2)),
+                    std::min(findDistanceToLocalSegment(b1, a1, a2), findDistanceToLocalSegment(b2, a1, a2)));
+}
+
+
+bool inLocalPolygon(const POINT_LOCAL& pt, const std::vector<POINT_LOCAL>& points)
+{
+    const int nvert = points.size();
+    bool c = false;
+    for (int i = 0, j = nvert-1; i < nvert; j = i++) {
+        if ((points[i].y > pt.y) != (points[j].y > pt.y))
+        {
+            if (pt.x < (points[j].x - points[i].x) * (pt.y - points[i].y) / (points[j].y - points[i].y) + points[i].x)
+            {
+                c = !c;
+            }
+        }
+    }
+    
+    return c;
+}
@@ -18,13 +18,31 @@ typedef struct :POINT_2D{
 
     } POINT_3D;
 
+
+/**
+ * @brief point on a local tangent plane in meters.
+ * 
+ */
+typedef struct {
+        
+        double x;   // east
+        double y;   // north
+        
+    } POINT_LOCAL;
+
 POINT_2D get_point_at_bearing(const double&  lat1, const double&  lon1, const double&  bearing_deg, const double&  distance_m);
 
 double calcGPSDistance(const double& latitude_new, const double& longitude_new, const double& latitude_old, const double& longitude_old);
-double inPolygon(const double&  lat1, const double&  lon1, const std::vector<POINT_3D> points);
+double inPolygon(const double&  lat1, const double&  lon1, const std::vector<POINT_3D>& points);
 POINT_2D findIntersectionPoint(const double& ptx, const double& pty, const double& p1x, const double& p1y, const double& p2x, const double& p2y);
 double findDistanceToSegment(const double& ptx, const double& pty, const double& p1x, const double& p1y, const double& p2x, const double& p2y);
 
+POINT_LOCAL toLocalPoint(const double& lat, const double& lon, const double& ref_lat, const double& ref_lon);
+double findDistanceToLocalSegment(const POINT_LOCAL& pt, const POINT_LOCAL& p1, const POINT_LOCAL& p2);
+double findDistanceBetweenLocalSegments(const POINT_LOCAL& a1, const POINT_LOCAL& a2, const POINT_LOCAL& b1, const POINT_LOCAL& b2);
+bool doLocalSegmentsIntersect(const POINT_LOCAL& a1, const POINT_LOCAL& a2, const POINT_LOCAL& b1, const POINT_LOCAL& b2);
+bool inLocalPolygon(const POINT_LOCAL& pt, const std::vector<POINT_LOCAL>& points);
+
 double calculateBearing(const double& lat1, const double& lon1, const double& lat2, const double& lon2);
 double getBearingOfVector(double velocityX, double velocityY);
 
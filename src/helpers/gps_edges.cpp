@@ -0,0 +1,88 @@
+#include <cmath>
+#include <cfloat>
+
+#include "gps_edges.hpp"
+
+
+/**
+ * @brief split points into edges.
+ *
+ * @param closed true for polygons where last point connects to first one.
+ */
+void buildLocalEdges(const std::vector<POINT_LOCAL>& points, const bool closed, LOCAL_EDGES& edges)
+{
+    const std::size_t point_count = points.size();
+    const std::size_t edge_count = (point_count < 2) ? 0 : (closed ? point_count : point_count - 1);
+
+    edges.x.resize(edge_count);
+    edges.y.resize(edge_count);
+    edges.dx.resize(edge_count);
+    edges.dy.resize(edge_count);
+    edges.inv_length_sq.resize(edge_count);
+    edges.slope.resize(edge_count);
+
+    for (std::size_t i = 0; i < edge_count; ++i)
+    {
+        const POINT_LOCAL& p1 = points[i];
+        const POINT_LOCAL& p2 = points[(i + 1) % point_count];
+        const double dx = p2.x - p1.x;
+        const double dy = p2.y - p1.y;
+        const double length_sq = dx * dx + dy * dy;
+
+        edges.x[i] = p1.x;
+        edges.y[i] = p1.y;
+        edges.dx[i] = dx;
+        edges.dy[i] = dy;
+        edges.inv_length_sq[i] = (length_sq > 0) ? 1.0 / length_sq : 0.0;
+        edges.slope[i] = (dy != 0) ? dx / dy : 0.0;
+    }
+}
+
+
+/**
+ * @brief distance from point to nearest edge and number of edges crossed by a ray from point to east.
+ * Point is inside a polygon if crossings is odd.
+ * @details Loop has no branches so that compiler vectorizes it [see gps_edges.cpp flags in CMakeLists.txt]
+ *
+ * @return distance in meters. DBL_MAX if there are no edges.
+ */
+double findDistanceToLocalEdges(const POINT_LOCAL& pt, const LOCAL_EDGES& edges, int& crossings)
+{
+    const std::size_t edge_count = edges.x.size();
+    const double* __restrict x = edges.x.data();
+    const double* __restrict y = edges.y.data();
+    const double* __restrict dx = edges.dx.data();
+    const double* __restrict dy = edges.dy.data();
+    const double* __restrict inv_length_sq = edges.inv_length_sq.data();
+    const double* __restrict slope = edges.slope.data();
+
+    const double ptx = pt.x;
+    const double pty = pt.y;
+    double min_distance_sq = DBL_MAX;
+    double crossing_count = 0;
+
+    for (std::size_t i = 0; i < edge_count; ++i)
+    {
+        const double px = ptx - x[i];
+        const double py = pty - y[i];
+
+        // nearest point of edge.
+        double t = (px * dx[i] + py * dy[i]) * inv_length_sq[i];
+        t = (t < 0.0) ? 0.0 : t;
+        t = (t > 1.0) ? 1.0 : t;
+        const double ex = px - t * dx[i];
+        const double ey = py - t * dy[i];
+        const double distance_sq = ex * ex + ey * ey;
+        min_distance_sq = (distance_sq < min_distance_sq) ? distance_sq : min_distance_sq;
+
+        // edge start & end are on different sides of point and edge is east of point.
+        const double start_north = (py < 0.0) ? 1.0 : 0.0;
+        const double end_north = (py < dy[i]) ? 1.0 : 0.0;
+        const double east = (px < py * slope[i]) ? 1.0 : 0.0;
+        crossing_count += (start_north - end_north) * (start_north - end_north) * east;
+    }
+
+    crossings = (int) crossing_count;
+
+    return (edge_count == 0) ? DBL_MAX : sqrt(min_distance_sq);
+}
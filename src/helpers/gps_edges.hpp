@@ -0,0 +1,29 @@
+#ifndef GPS_EDGES_H_
+#define GPS_EDGES_H_
+
+#include <vector>
+
+#include "gps.hpp"
+
+
+/**
+ * @brief edges of a polygon or polyline in local meters as structure of arrays.
+ * Built once per fence so that a point is tested against all edges in one vectorized loop.
+ *
+ */
+typedef struct {
+
+        std::vector<double> x;              // edge start
+        std::vector<double> y;
+        std::vector<double> dx;             // edge end - edge start
+        std::vector<double> dy;
+        std::vector<double> inv_length_sq;  // 1 / |edge|^2. 0 for zero length edges.
+        std::vector<double> slope;          // dx / dy. 0 for east-west edges.
+
+    } LOCAL_EDGES;
+
+
+void buildLocalEdges(const std::vector<POINT_LOCAL>& points, const bool closed, LOCAL_EDGES& edges);
+double findDistanceToLocalEdges(const POINT_LOCAL& pt, const LOCAL_EDGES& edges, int& crossings);
+
+#endif
@@ -0,0 +1,325 @@
+#include <cmath>
+
+#include "gps_geodesy.hpp"
+
+// same sphere as gps.cpp
+#define EARTH_RADIUS            6372797.56085
+#define DEGREES_TO_RADIANS      (M_PI / 180.0)
+
+// WGS84
+#define WGS84_A                 6378137.0
+#define WGS84_F                 (1 / 298.257223563)
+#define WGS84_B                 (WGS84_A * (1 - WGS84_F))
+
+#define VINCENTY_MAX_ITERATIONS 100
+#define VINCENTY_TOLERANCE      1e-12
+
+// recent references kept by getLocalFrame
+#define LOCAL_FRAME_CACHE_SIZE  8
+
+
+CLocalFrame::CLocalFrame ()
+{
+    setReference(0, 0);
+}
+
+
+CLocalFrame::CLocalFrame (const double ref_lat, const double ref_lng)
+{
+    setReference(ref_lat, ref_lng);
+}
+
+
+void CLocalFrame::setReference (const double ref_lat, const double ref_lng)
+{
+    m_ref_lat = ref_lat;
+    m_ref_lng = ref_lng;
+    m_meters_per_degree_lat = DEGREES_TO_RADIANS * EARTH_RADIUS;
+    m_meters_per_degree_lng = DEGREES_TO_RADIANS * cos(ref_lat * DEGREES_TO_RADIANS) * EARTH_RADIUS;
+}
+
+
+void CLocalFrame::toLocal (const POINT_2D* points, const std::size_t count, POINT_LOCAL* local_points) const
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        local_points[i] = toLocal(points[i].latitude, points[i].longitude);
+    }
+}
+
+
+const CLocalFrame& getLocalFrame (const double ref_lat, const double ref_lng)
+{
+    static thread_local CLocalFrame frames[LOCAL_FRAME_CACHE_SIZE];
+    static thread_local bool used[LOCAL_FRAME_CACHE_SIZE] = {false};
+    static thread_local int next = 0;
+
+    for (int i = 0; i < LOCAL_FRAME_CACHE_SIZE; ++i)
+    {
+        if (used[i] && frames[i].isReference(ref_lat, ref_lng)) return frames[i];
+    }
+
+    // replace oldest.
+    const int i = next;
+    next = (next + 1) % LOCAL_FRAME_CACHE_SIZE;
+    frames[i].setReference(ref_lat, ref_lng);
+    used[i] = true;
+
+    return frames[i];
+}
+
+
+static inline double calcEquirectangularDistance (const double lat1, const double lng1, const double lat2, const double lng2)
+{
+    const double x = calcLongitudeDifference(lng1, lng2) * cos((lat1 + lat2) * 0.5 * DEGREES_TO_RADIANS);
+    const double y = lat2 - lat1;
+
+    return sqrt(x * x + y * y) * DEGREES_TO_RADIANS * EARTH_RADIUS;
+}
+
+
+static inline double calcEquirectangularBearing (const double lat1, const double lng1, const double lat2, const double lng2)
+{
+    const double x = calcLongitudeDifference(lng1, lng2) * cos((lat1 + lat2) * 0.5 * DEGREES_TO_RADIANS);
+    const double y = lat2 - lat1;
+
+    return atan2(x, y);
+}
+
+
+/**
+ * @brief inverse Vincenty on WGS84 ellipsoid.
+ * Falls back to haversine for nearly antipodal points where it does not converge.
+ *
+ * @param bearing [out] optional initial bearing in radians.
+ * @return distance in meters.
+ */
+double calcVincentyDistance (const double& lat1, const double& lng1, const double& lat2, const double& lng2, double* bearing)
+{
+    const double L = (lng2 - lng1) * DEGREES_TO_RADIANS;
+    const double U1 = atan((1 - WGS84_F) * tan(lat1 * DEGREES_TO_RADIANS));
+    const double U2 = atan((1 - WGS84_F) * tan(lat2 * DEGREES_TO_RADIANS));
+    const double sin_U1 = sin(U1), cos_U1 = cos(U1);
+    const double sin_U2 = sin(U2), cos_U2 = cos(U2);
+
+    double lambda = L;
+    double sin_sigma = 0, cos_sigma = 1, sigma = 0, cos_sq_alpha = 1, cos_2sigma_m = 0;
+    double sin_lambda = 0, cos_lambda = 1;
+    int i = 0;
+    for (; i < VINCENTY_MAX_ITERATIONS; ++i)
+    {
+        sin_lambda = sin(lambda);
+        cos_lambda = cos(lambda);
+        const double a = cos_U2 * sin_lambda;
+        const double b = cos_U1 * sin_U2 - sin_U1 * cos_U2 * cos_lambda;
+        sin_sigma = sqrt(a * a + b * b);
+        if (sin_sigma == 0)
+        {
+            // same point.
+            if (bearing != nullptr) *bearing = 0;
+            return 0;
+        }
+
+        cos_sigma = sin_U1 * sin_U2 + cos_U1 * cos_U2 * cos_lambda;
+        sigma = atan2(sin_sigma, cos_sigma);
+        const double sin_alpha = cos_U1 * cos_U2 * sin_lambda / sin_sigma;
+        cos_sq_alpha = 1 - sin_alpha * sin_alpha;
+        // equatorial line.
+        cos_2sigma_m = (cos_sq_alpha != 0) ? cos_sigma - 2 * sin_U1 * sin_U2 / cos_sq_alpha : 0;
+
+        const double C = WGS84_F / 16 * cos_sq_alpha * (4 + WGS84_F * (4 - 3 * cos_sq_alpha));
+        const double lambda_previous = lambda;
+        lambda = L + (1 - C) * WGS84_F * sin_alpha
+                * (sigma + C * sin_sigma * (cos_2sigma_m + C * cos_sigma * (-1 + 2 * cos_2sigma_m * cos_2sigma_m)));
+
+        if (fabs(lambda - lambda_previous) < VINCENTY_TOLERANCE) break;
+    }
+
+    if (i == VINCENTY_MAX_ITERATIONS)
+    {
+        if (bearing != nullptr) *bearing = calculateBearing(lat1, lng1, lat2, lng2);
+        return calcGPSDistance(lat1, lng1, lat2, lng2);
+    }
+
+    const double u_sq = cos_sq_alpha * (WGS84_A * WGS84_A - WGS84_B * WGS84_B) / (WGS84_B * WGS84_B);
+    const double A = 1 + u_sq / 16384 * (4096 + u_sq * (-768 + u_sq * (320 - 175 * u_sq)));
+    const double B = u_sq / 1024 * (256 + u_sq * (-128 + u_sq * (74 - 47 * u_sq)));
+    const double delta_sigma = B * sin_sigma * (cos_2sigma_m + B / 4 * (cos_sigma * (-1 + 2 * cos_2sigma_m * cos_2sigma_m)
+                - B / 6 * cos_2sigma_m * (-3 + 4 * sin_sigma * sin_sigma) * (-3 + 4 * cos_2sigma_m * cos_2sigma_m)));
+
+    if (bearing != nullptr)
+    {
+        *bearing = atan2(cos_U2 * sin_lambda, cos_U1 * sin_U2 - sin_U1 * cos_U2 * cos_lambda);
+    }
+
+    return WGS84_B * A * (sigma - delta_sigma);
+}
+
+
+double calcGPSDistance (const double& lat1, const double& lng1, const double& lat2, const double& lng2, const ENUM_GEO_PRECISION precision)
+{
+    switch (precision)
+    {
+        case GEO_PRECISION_LOCAL_ENU:
+        {
+            const POINT_LOCAL point = getLocalFrame(lat1, lng1).toLocal(lat2, lng2);
+            return sqrt(point.x * point.x + point.y * point.y);
+        }
+
+        case GEO_PRECISION_EQUIRECTANGULAR:
+            return calcEquirectangularDistance(lat1, lng1, lat2, lng2);
+
+        case GEO_PRECISION_VINCENTY:
+            return calcVincentyDistance(lat1, lng1, lat2, lng2);
+
+        case GEO_PRECISION_HAVERSINE:
+        default:
+            return calcGPSDistance(lat1, lng1, lat2, lng2);
+    }
+}
+
+
+double calculateBearing (const double& lat1, const double& lng1, const double& lat2, const double& lng2, const ENUM_GEO_PRECISION precision)
+{
+    switch (precision)
+    {
+        case GEO_PRECISION_LOCAL_ENU:
+        {
+            const POINT_LOCAL point = getLocalFrame(lat1, lng1).toLocal(lat2, lng2);
+            return atan2(point.x, point.y);
+        }
+
+        case GEO_PRECISION_EQUIRECTANGULAR:
+            return calcEquirectangularBearing(lat1, lng1, lat2, lng2);
+
+        case GEO_PRECISION_VINCENTY:
+        {
+            double bearing;
+            calcVincentyDistance(lat1, lng1, lat2, lng2, &bearing);
+            return bearing;
+        }
+
+        case GEO_PRECISION_HAVERSINE:
+        default:
+            return calculateBearing(lat1, lng1, lat2, lng2);
+    }
+}
+
+
+void calcGPSDistances (const double ref_lat, const double ref_lng, const POINT_2D* points, const std::size_t count, double* distances, const ENUM_GEO_PRECISION precision)
+{
+    switch (precision)
+    {
+        case GEO_PRECISION_LOCAL_ENU:
+        {
+            const CLocalFrame& frame = getLocalFrame(ref_lat, ref_lng);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const POINT_LOCAL point = frame.toLocal(points[i].latitude, points[i].longitude);
+                distances[i] = sqrt(point.x * point.x + point.y * point.y);
+            }
+        }
+        break;
+
+        case GEO_PRECISION_EQUIRECTANGULAR:
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                distances[i] = calcEquirectangularDistance(ref_lat, ref_lng, points[i].latitude, points[i].longitude);
+            }
+        break;
+
+        case GEO_PRECISION_VINCENTY:
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                distances[i] = calcVincentyDistance(ref_lat, ref_lng, points[i].latitude, points[i].longitude);
+            }
+        break;
+
+        case GEO_PRECISION_HAVERSINE:
+        default:
+        {
+            // reference terms are calculated once.
+            const double cos_ref_lat = cos(ref_lat * DEGREES_TO_RADIANS);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const double sin_lat_diff = sin((points[i].latitude - ref_lat) * DEGREES_TO_RADIANS / 2);
+                const double sin_lng_diff = sin((points[i].longitude - ref_lng) * DEGREES_TO_RADIANS / 2);
+                const double a = sin_lat_diff * sin_lat_diff
+                        + cos_ref_lat * cos(points[i].latitude * DEGREES_TO_RADIANS) * sin_lng_diff * sin_lng_diff;
+                distances[i] = EARTH_RADIUS * 2 * atan2(sqrt(a), sqrt(1 - a));
+            }
+        }
+        break;
+    }
+}
+
+
+void calcGPSDistances (const POINT_2D* from, const POINT_2D* to, const std::size_t count, double* distances, const ENUM_GEO_PRECISION precision)
+{
+    if (count == 0) return ;
+
+    switch (precision)
+    {
+        case GEO_PRECISION_LOCAL_ENU:
+        {
+            const CLocalFrame& frame = getLocalFrame(from[0].latitude, from[0].longitude);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const POINT_LOCAL p1 = frame.toLocal(from[i].latitude, from[i].longitude);
+                const POINT_LOCAL p2 = frame.toLocal(to[i].latitude, to[i].longitude);
+                const double dx = p2.x - p1.x;
+                const double dy = p2.y - p1.y;
+                distances[i] = sqrt(dx * dx + dy * dy);
+            }
+        }
+        break;
+
+        default:
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                distances[i] = calcGPSDistance(from[i].latitude, from[i].longitude, to[i].latitude, to[i].longitude, precision);
+            }
+        break;
+    }
+}
+
+
+void calculateBearings (const double ref_lat, const double ref_lng, const POINT_2D* points, const std::size_t count, double* bearings, const ENUM_GEO_PRECISION precision)
+{
+    switch (precision)
+    {
+        case GEO_PRECISION_LOCAL_ENU:
+        {
+            const CLocalFrame& frame = getLocalFrame(ref_lat, ref_lng);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const POINT_LOCAL point = frame.toLocal(points[i].latitude, points[i].longitude);
+                bearings[i] = atan2(point.x, point.y);
+            }
+        }
+        break;
+
+        case GEO_PRECISION_HAVERSINE:
+        {
+            // reference terms are calculated once.
+            const double sin_ref_lat = sin(ref_lat * DEGREES_TO_RADIANS);
+            const double cos_ref_lat = cos(ref_lat * DEGREES_TO_RADIANS);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const double lat = points[i].latitude * DEGREES_TO_RADIANS;
+                const double lng_diff = (points[i].longitude - ref_lng) * DEGREES_TO_RADIANS;
+                const double y = sin(lng_diff) * cos(lat);
+                const double x = cos_ref_lat * sin(lat) - sin_ref_lat * cos(lat) * cos(lng_diff);
+                bearings[i] = atan2(y, x);
+            }
+        }
+        break;
+
+        default:
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                bearings[i] = calculateBearing(ref_lat, ref_lng, points[i].latitude, points[i].longitude, precision);
+            }
+        break;
+    }
+}
@@ -0,0 +1,121 @@
+#ifndef GPS_GEODESY_H_
+#define GPS_GEODESY_H_
+
+#include <cstddef>
+
+#include "gps.hpp"
+
+
+/**
+ * @brief accuracy of distance & bearing calculations. Cheaper first.
+ *
+ * Error against Vincenty [measured at 30 & 60 deg latitude]. Sphere model alone is ~0.34%.
+ * * GEO_PRECISION_LOCAL_ENU: 0.36% up to 10 km, 0.8% at 100 km, 6% at 1000 km. ~3 ns per point in batch.
+ * * GEO_PRECISION_EQUIRECTANGULAR: 0.4% up to 1000 km. ~16 ns.
+ * * GEO_PRECISION_HAVERSINE: 0.4% at any distance. Same as calcGPSDistance(). ~60 ns.
+ * * GEO_PRECISION_VINCENTY: mm level on WGS84 ellipsoid. Iterative. ~410 ns.
+ */
+typedef enum ENUM_GEO_PRECISION
+{
+    GEO_PRECISION_LOCAL_ENU         = 0,    // plane tangent at reference point. Scale is cached per reference.
+    GEO_PRECISION_EQUIRECTANGULAR   = 1,    // plane scaled at mean latitude of each pair.
+    GEO_PRECISION_HAVERSINE         = 2,
+    GEO_PRECISION_VINCENTY          = 3
+} ENUM_GEO_PRECISION;
+
+
+/**
+ * @brief lng2 - lng1 in [-180, 180] so points across the antimeridian are near.
+ *
+ */
+inline double calcLongitudeDifference (const double lng1, const double lng2)
+{
+    double difference = lng2 - lng1;
+    if (difference > 180.0) difference -= 360.0;
+    else if (difference < -180.0) difference += 360.0;
+
+    return difference;
+}
+
+
+/**
+ * @brief east-north plane tangent at a reference point.
+ * @details Scale of longitude is calculated once per reference so converting a point
+ * costs two multiplications. Same projection as toLocalPoint().
+ *
+ */
+class CLocalFrame
+{
+    public:
+
+        CLocalFrame ();
+        CLocalFrame (const double ref_lat, const double ref_lng);
+
+    public:
+
+        void setReference (const double ref_lat, const double ref_lng);
+
+        inline bool isReference (const double ref_lat, const double ref_lng) const
+        {
+            return (m_ref_lat == ref_lat) && (m_ref_lng == ref_lng);
+        }
+
+        inline POINT_LOCAL toLocal (const double lat, const double lng) const
+        {
+            POINT_LOCAL point;
+            point.x = calcLongitudeDifference(m_ref_lng, lng) * m_meters_per_degree_lng;
+            point.y = (lat - m_ref_lat) * m_meters_per_degree_lat;
+
+            return point;
+        }
+
+        inline POINT_2D toGlobal (const POINT_LOCAL& point) const
+        {
+            POINT_2D global;
+            global.latitude = m_ref_lat + point.y / m_meters_per_degree_lat;
+            global.longitude = m_ref_lng + point.x / m_meters_per_degree_lng;
+            if (global.longitude > 180.0) global.longitude -= 360.0;
+            else if (global.longitude < -180.0) global.longitude += 360.0;
+
+            return global;
+        }
+
+        void toLocal (const POINT_2D* points, const std::size_t count, POINT_LOCAL* local_points) const;
+
+    private:
+
+        double m_ref_lat = 0;
+        double m_ref_lng = 0;
+        double m_meters_per_degree_lat = 0;
+        double m_meters_per_degree_lng = 0;
+};
+
+
+/**
+ * @brief frame of a reference point from a small per thread cache of recent references.
+ *
+ */
+const CLocalFrame& getLocalFrame (const double ref_lat, const double ref_lng);
+
+double calcGPSDistance (const double& lat1, const double& lng1, const double& lat2, const double& lng2, const ENUM_GEO_PRECISION precision);
+double calculateBearing (const double& lat1, const double& lng1, const double& lat2, const double& lng2, const ENUM_GEO_PRECISION precision);
+double calcVincentyDistance (const double& lat1, const double& lng1, const double& lat2, const double& lng2, double* bearing = nullptr);
+
+/**
+ * @brief distances in meters from a reference point to each point.
+ * GEO_PRECISION_LOCAL_ENU uses frame of reference point.
+ */
+void calcGPSDistances (const double ref_lat, const double ref_lng, const POINT_2D* points, const std::size_t count, double* distances, const ENUM_GEO_PRECISION precision);
+
+/**
+ * @brief distances in meters between from[i] & to[i].
+ * GEO_PRECISION_LOCAL_ENU uses frame of from[0] so points should be within few kilometers of it.
+ */
+void calcGPSDistances (const POINT_2D* from, const POINT_2D* to, const std::size_t count, double* distances, const ENUM_GEO_PRECISION precision);
+
+/**
+ * @brief bearings in radians from a reference point to each point.
+ */
+void calculateBearings (const double ref_lat, const double ref_lng, const POINT_2D* points, const std::size_t count, double* bearings, const ENUM_GEO_PRECISION precision);
+
+#endif
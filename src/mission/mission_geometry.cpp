@@ -0,0 +1,182 @@
+#include <cmath>
+#include <all/mavlink.h>
+
+#include "../de_common/de_databus/messages.hpp"
+#include "../helpers/gps.hpp"
+#include "mission_geometry.hpp"
+
+
+using namespace de::fcb::mission;
+
+
+/**
+ * @brief true if command flies to latitude & longitude of the item.
+ *
+ */
+static bool hasPosition (const mavlink_mission_item_int_t& mission_item)
+{
+    switch (mission_item.command)
+    {
+        case MAV_CMD_NAV_WAYPOINT:
+        case MAV_CMD_NAV_LOITER_UNLIM:
+        case MAV_CMD_NAV_LOITER_TURNS:
+        case MAV_CMD_NAV_LOITER_TIME:
+        case MAV_CMD_NAV_LOITER_TO_ALT:
+        case MAV_CMD_NAV_LAND:
+        case MAV_CMD_NAV_SPLINE_WAYPOINT:
+        case MAV_CMD_NAV_VTOL_LAND:
+        case MAV_CMD_NAV_PAYLOAD_PLACE:
+            // zero means current location.
+            return (mission_item.x != 0) || (mission_item.y != 0);
+
+        default:
+            return false;
+    }
+}
+
+
+/**
+ * @brief altitude of item in meters above home.
+ *
+ * @param home_altitude home altitude [m] above mean sea level. NAN if not known.
+ * @return NAN for terrain frames and for AMSL frames if home altitude is not known.
+ */
+static double getRelativeAltitude (const mavlink_mission_item_int_t& mission_item, const double home_altitude)
+{
+    switch (mission_item.frame)
+    {
+        case MAV_FRAME_GLOBAL_RELATIVE_ALT:
+        case MAV_FRAME_GLOBAL_RELATIVE_ALT_INT:
+            return mission_item.z;
+
+        case MAV_FRAME_GLOBAL:
+        case MAV_FRAME_GLOBAL_INT:
+            return mission_item.z - home_altitude;
+
+        default:
+            // terrain frames follow ground so height above home is not known.
+            return NAN;
+    }
+}
+
+
+void CMissionGeometry::clear ()
+{
+    m_legs.clear();
+    m_cumulative_distance.clear();
+    m_leg_of_seq.clear();
+    m_valid = false;
+}
+
+
+/**
+ * @brief compute legs between positional items. Item zero is home and starts the first leg.
+ * RTL adds a leg back to home. Altitudes are converted to meters above home using frame of each item.
+ *
+ */
+void CMissionGeometry::build (const ANDRUAV_UNIT_MISSION& andruav_mission)
+{
+    clear();
+
+    m_version = andruav_mission.version;
+    m_valid = true;
+
+    const std::map <int, std::unique_ptr<CMissionItem>>& mission_items = andruav_mission.mission_items;
+    if (mission_items.empty()) return ;
+
+    const int max_seq = mission_items.rbegin()->first;
+    if (max_seq < 0) return ;
+
+    m_legs.reserve(mission_items.size());
+    m_cumulative_distance.reserve(mission_items.size());
+    m_leg_of_seq.assign(max_seq + 1, -1);
+
+    bool has_home = false;
+    T_MISSION_LEG home = T_MISSION_LEG();
+    // AMSL altitude of home is known only if item zero is in global frame.
+    double home_altitude = NAN;
+
+    for (const auto& pair : mission_items)
+    {
+        const mavlink_mission_item_int_t& mission_item = pair.second->m_original_mission;
+
+        T_MISSION_LEG leg;
+        if ((pair.first == 0) && hasPosition(mission_item))
+        {
+            leg.latitude = mission_item.x / 10000000.0;
+            leg.longitude = mission_item.y / 10000000.0;
+            leg.altitude = 0.0;
+            if ((mission_item.frame == MAV_FRAME_GLOBAL) || (mission_item.frame == MAV_FRAME_GLOBAL_INT))
+            {
+                home_altitude = mission_item.z;
+            }
+        }
+        else if (hasPosition(mission_item))
+        {
+            leg.latitude = mission_item.x / 10000000.0;
+            leg.longitude = mission_item.y / 10000000.0;
+            leg.altitude = getRelativeAltitude(mission_item, home_altitude);
+        }
+        else if ((mission_item.command == MAV_CMD_NAV_RETURN_TO_LAUNCH) && has_home)
+        {
+            leg.latitude = home.latitude;
+            leg.longitude = home.longitude;
+            leg.altitude = home.altitude;
+        }
+        else
+        {
+            continue;
+        }
+
+        leg.seq = pair.first;
+
+        if (m_legs.empty())
+        {
+            // first point has no leg before it.
+            leg.length = 0.0;
+            leg.bearing = 0.0;
+            leg.altitude_change = 0.0;
+            m_cumulative_distance.push_back(0.0);
+        }
+        else
+        {
+            const T_MISSION_LEG& last_leg = m_legs.back();
+            leg.length = calcGPSDistance(leg.latitude, leg.longitude, last_leg.latitude, last_leg.longitude);
+            leg.bearing = calculateBearing(last_leg.latitude, last_leg.longitude, leg.latitude, leg.longitude);
+            leg.altitude_change = leg.altitude - last_leg.altitude;
+            m_cumulative_distance.push_back(m_cumulative_distance.back() + leg.length);
+        }
+
+        if (!has_home)
+        {
+            home = leg;
+            has_home = true;
+        }
+
+        m_legs.push_back(leg);
+    }
+
+    // items without position belong to the next leg.
+    int leg_index = -1;
+    for (int seq = max_seq, i = (int) m_legs.size() - 1; seq >= 0; --seq)
+    {
+        while ((i >= 0) && (m_legs[i].seq >= seq))
+        {
+            leg_index = i;
+            --i;
+        }
+        m_leg_of_seq[seq] = leg_index;
+    }
+}
+
+
+double CMissionGeometry::getRemainingDistance (const int current_seq, const double distance_to_current, const int target_seq) const
+{
+    const int current_leg = getLegIndex(current_seq);
+    if (current_leg < 0) return -1;
+
+    const int target_leg = (target_seq < 0) ? (int) m_legs.size() - 1 : getLegIndex(target_seq);
+    if ((target_leg < 0) || (target_leg < current_leg)) return -1;
+
+    return distance_to_current + (m_cumulative_distance[target_leg] - m_cumulative_distance[current_leg]);
+}
@@ -0,0 +1,113 @@
+#ifndef MISSION_GEOMETRY_H_
+#define MISSION_GEOMETRY_H_
+
+#include <vector>
+
+#include "missions.hpp"
+
+namespace de
+{
+namespace fcb
+{
+namespace mission
+{
+
+/**
+ * @brief leg that ends at a positional mission item.
+ *
+ */
+typedef struct T_MISSION_LEG
+{
+    int seq;                    // seq of mission item at the end of the leg.
+    double latitude;            // end point [deg]
+    double longitude;           // end point [deg]
+    double altitude;            // end point [m] above home. NAN if not known e.g. terrain frames.
+    double length;              // horizontal length [m]
+    double bearing;             // [rad]
+    double altitude_change;     // [m] NAN if altitude of either end is not known.
+} T_MISSION_LEG;
+
+
+/**
+ * @brief leg geometry of a mission and prefix sum of leg lengths.
+ * @details Geometry is built once per mission version. Remaining distance from any mission item
+ * to any later item is then a difference of two prefix sums.
+ * Items without position (DO_ and CONDITION_ commands) belong to the next positional item.
+ *
+ */
+class CMissionGeometry
+{
+    public:
+
+        void build (const ANDRUAV_UNIT_MISSION& andruav_mission);
+
+        bool isBuiltFor (const uint32_t version) const
+        {
+            return m_valid && (m_version == version);
+        }
+
+        void clear ();
+
+    public:
+
+        inline const std::vector<T_MISSION_LEG>& getLegs () const
+        {
+            return m_legs;
+        }
+
+        /**
+         * @brief total horizontal length of mission [m]
+         *
+         */
+        inline double getTotalDistance () const
+        {
+            return m_cumulative_distance.empty() ? 0.0 : m_cumulative_distance.back();
+        }
+
+        /**
+         * @brief remaining distance when vehicle is flying to mission item current_seq.
+         *
+         * @param current_seq MISSION_CURRENT seq.
+         * @param distance_to_current distance to target of current_seq e.g. NAV_CONTROLLER_OUTPUT.wp_dist [m]
+         * @param target_seq item to measure distance to. -1 means end of mission.
+         * @return distance [m] or -1 if seq is out of mission.
+         */
+        double getRemainingDistance (const int current_seq, const double distance_to_current, const int target_seq = -1) const;
+
+    protected:
+
+        /**
+         * @brief index of leg that ends at seq or the first leg after it. -1 if none.
+         *
+         */
+        inline int getLegIndex (const int seq) const
+        {
+            if ((seq < 0) || (seq >= (int) m_leg_of_seq.size())) return -1;
+            return m_leg_of_seq[seq];
+        }
+
+    private:
+
+        std::vector<T_MISSION_LEG> m_legs;
+
+        /**
+         * @brief m_cumulative_distance[i] is length from first positional item to end of leg i.
+         *
+         */
+        std::vector<double> m_cumulative_distance;
+
+        /**
+         * @brief seq -> index in m_legs.
+         *
+         */
+        std::vector<int> m_leg_of_seq;
+
+        uint32_t m_version = 0;
+        bool m_valid = false;
+};
+
+}
+}
+}
+
+#endif
@@ -1,5 +1,6 @@
 
 #include <vector>
+#include <algorithm>
 
 #include <all/mavlink.h>
 
@@ -22,6 +23,7 @@ using namespace de::fcb::mission;
 
 /**
  * @brief only Mavlink Mission Upload for Mission Planner & QGC files.
+ * Translated items are uploaded as they are. Andruav mission items are only built for GCS & events.
  * 
  * @param plan_text 
  */
@@ -29,29 +31,32 @@ void CMissionManager::uploadMissionIntoSystem(const std::string& plan_text)
 {
     CMissionTranslator cMissionTranslator;
 
-    std::unique_ptr<std::map <int, std::unique_ptr<mission::CMissionItem>>> new_mission_items = cMissionTranslator.translateMissionText(plan_text);
-    
-    if (new_mission_items == std::nullptr_t())
+    std::vector<mavlink_mission_item_int_t> mavlink_items;
+    if (!cMissionTranslator.translateMissionText(plan_text, mavlink_items))
     {
         CFCBFacade::getInstance().sendErrorMessage(std::string(), 0, ERROR_3DR, NOTIFICATION_TYPE_ERROR, "Bad input plan file");
         return ;
     }
     
-    clearWayPoints();
+    // mission on FCB is not cleared so that saveWayPoints can write changed items only.
+    clearMissionItems();
+    m_andruav_missions.clear();
     mission::ANDRUAV_UNIT_MISSION& andruav_missions = de::fcb::mission::CMissionManager::getInstance().getAndruavMission();                
                 
-             
-    std::map<int, std::unique_ptr<mission::CMissionItem>>::iterator it;
-    for (it = new_mission_items->begin(); it != new_mission_items->end(); it++)
+    // items are sorted by seq so each insert is at end.
+    std::map<int, mavlink_mission_item_int_t> mavlink_mission;
+    for (const mavlink_mission_item_int_t& mavlink_mission_item : mavlink_items)
     {
-        int seq = it->first;
-                    
-        andruav_missions.mission_items.insert(std::make_pair( seq, std::move(it->second)));
+        de::fcb::mission::CMissionItem *mission_item = de::fcb::mission::CMissionItemBuilder::getClassByMavlinkCMD(mavlink_mission_item);
+        mission_item->decodeMavlink (mavlink_mission_item);
+        andruav_missions.addMissionItem(mavlink_mission_item.seq, std::unique_ptr<de::fcb::mission::CMissionItem>(mission_item));
+
+        mavlink_mission.emplace_hint(mavlink_mission.end(), mavlink_mission_item.seq, mavlink_mission_item);
     }
 
-    new_mission_items->clear();
-                
-    saveWayPointsToFCB();                
+    mavlinksdk::CMavlinkWayPointManager::getInstance().saveWayPoints(mavlink_mission, MAV_MISSION_TYPE_MISSION);
+
+    geofence::CGeoFenceManager::getInstance().validateMission();
 }
 
 
@@ -76,7 +81,7 @@ void CMissionManager::clearWayPoints()
  */
 void CMissionManager::clearMissionItems ()
 {
-    m_event_waiting_for = "";
+    m_event_waiting_for = AP_EVENT_DISABLED;
     m_event_waiting_for_has_processed = true;
     m_mavlink_event_waiting_for = 0;
     m_mavlink_mission_item_last_seq =0;
@@ -121,10 +126,12 @@ void CMissionManager::uploadMissionIntoSystem2(const Json_de& plan)
     {
         int seq = it->first;
                     
-        andruav_missions.mission_items.insert(std::make_pair( seq, std::move(it->second)));
+        andruav_missions.addMissionItem(seq, std::move(it->second));
     }
 
     saveWayPointsToFCB();       
+
+    geofence::CGeoFenceManager::getInstance().validateMission();
 }
 
 void CMissionManager::extractPlanMavlinkMission (const Json_de& plan)
@@ -246,11 +253,16 @@ void CMissionManager::extractPlanModule (const Json_de& plan)
  */
 void CMissionManager::deEventFiredExternally(const std::string de_event_sid) 
 {
-    //TODO:: In future you may determine if the event will be used or not, so unneeded events dont need to be stored.
-    if (std::find(m_event_received_from_others.begin(), m_event_received_from_others.end(), de_event_sid) == m_event_received_from_others.end())
+    int de_event_id;
+    if (!toEventID(de_event_sid, de_event_id))
     {
-        m_event_received_from_others.push_back(de_event_sid);
+        std::cout << _ERROR_CONSOLE_TEXT_ << "Invalid event: " << de_event_sid << _NORMAL_CONSOLE_TEXT_ << std::endl;
+        return ;
+    }
 
+    //TODO:: In future you may determine if the event will be used or not, so unneeded events dont need to be stored.
+    if (m_event_received_from_others.insert(de_event_id).second)
+    {
         std::cout << _INFO_CONSOLE_TEXT << "Event Received (new): " << de_event_sid << _NORMAL_CONSOLE_TEXT_ << std::endl;
     }
 
@@ -263,74 +275,77 @@ void CMissionManager::deEventFiredInternally(const std::string de_event_sid)
 }
 
 
+/**
+ * @brief index DO_SET_SERVO items of wait channel by the event they wait for.
+ * Mission items are scanned once per mission version not per SERVO_OUTPUT_RAW.
+ * 
+ */
+void CMissionManager::updateWaitingEventIndex()
+{
+    const uint32_t version = m_andruav_missions.version;
+    if (m_waiting_event_index_valid && (m_waiting_event_index_version == version)) return ;
+
+    m_waiting_event_index.clear();
+    
+    // map is ordered so seq in each list are sorted.
+    for (const auto& pair : m_andruav_missions.mission_items) {
+        const CMissionItem* item = pair.second.get();
+        if (item->m_mission_command != MAV_CMD_DO_SET_SERVO) continue;
+
+        const mavlink_mission_item_int_t cmd = item->getArdupilotMission();
+        if ((int) cmd.param1 != m_event_wait_channel) continue; // Not a SYNC Event
+
+        m_waiting_event_index[(int) cmd.param2].push_back(pair.first);
+    }
+
+    m_waiting_event_index_version = version;
+    m_waiting_event_index_valid = true;
+}
+
 
 /**
  * @brief checks if there is an action depends on an event and resumes it.
  *  This is the executor function where a waiting mission way-point resumes.
+ *  It is called with every SERVO_OUTPUT_RAW so it only uses indexed lookups.
  * 
  */
 void CMissionManager::processMyWaitingEvent()
 {
     if (m_event_waiting_for_has_processed) return ;
 
-    std::vector<std::string>::iterator it = std::find(m_event_received_from_others.begin(), m_event_received_from_others.end(), m_event_waiting_for);
+    std::unordered_set<int>::iterator it = m_event_received_from_others.find(m_event_waiting_for);
 
-    if (it != m_event_received_from_others.end())
-    { // event that is [m_event_waiting_for] is fired by another unit or module found 
-        
-        std::cout << "event: " << m_event_waiting_for << " : found" << std::endl;
-
-        if (de::fcb::CFCBMain::getInstance().getAndruavVehicleInfo().flying_mode == VEHICLE_MODE_AUTO)
-        {
-            // +3 because setServo & Delay does not appear in Mission Item Reached
-            //      - SetServo (WAIT FOR EVENT)
-            //      - MAV_CMD_NAV_DELAY()
-            //      - Next Mission.
-            // TODO: replace with break mode unless delay is used for timeout.
-            const ANDRUAV_VEHICLE_INFO& andruav_vehicle_info = de::fcb::CFCBMain::getInstance().getAndruavVehicleInfo();
-            
-            // Iterating using range-based for loop
-            for (const auto& pair : m_andruav_missions.mission_items) {
-                const int key = pair.first;
-                
-                // Skip early missions.
-                // remember the logic is: we are waiting for a single event to continue... 
-                // .. not trigerringdifferent missions based on events.
-                if (key < andruav_vehicle_info.current_waypoint) continue;
-                
-                const CMissionItem* item = pair.second.get();
-                
-                if (item->m_mission_command == MAV_CMD_DO_SET_SERVO)
-                {
-                    mavlink_mission_item_int_t cmd = item->getArdupilotMission();
-                    if (cmd.param1 !=  m_event_wait_channel) 
-                    {
-                        // Not a SYNC Event
-                        continue;
-                    }
-                    
-                    if (cmd.param2 !=  std::stof(m_event_waiting_for)) 
-                    {   // not the event we are looking for.
-                        continue;
-                    }
-                    
-                    m_event_waiting_for_has_processed = true;
-                
-                    mavlinksdk::CMavlinkCommand::getInstance().setCurrentMission(item->m_sequence+2);
-                    
-                    std::cout << "Continue from task Key: " << key << std::endl ;
+    if (it == m_event_received_from_others.end()) return ;
+    
+    // event that is [m_event_waiting_for] is fired by another unit or module found 
+    const ANDRUAV_VEHICLE_INFO& andruav_vehicle_info = de::fcb::CFCBMain::getInstance().getAndruavVehicleInfo();
+    if (andruav_vehicle_info.flying_mode != VEHICLE_MODE_AUTO) return ;
+
+    updateWaitingEventIndex();
+
+    const auto waiting_items = m_waiting_event_index.find(m_event_waiting_for);
+    if (waiting_items == m_waiting_event_index.end()) return ;
+
+    // Skip early missions.
+    // remember the logic is: we are waiting for a single event to continue... 
+    // .. not trigerringdifferent missions based on events.
+    const std::vector<int>& sequences = waiting_items->second;
+    const auto seq = std::lower_bound(sequences.begin(), sequences.end(), andruav_vehicle_info.current_waypoint);
+    if (seq == sequences.end()) return ;
+
+    // +2 because setServo & Delay does not appear in Mission Item Reached
+    //      - SetServo (WAIT FOR EVENT)
+    //      - MAV_CMD_NAV_DELAY()
+    //      - Next Mission.
+    // TODO: replace with break mode unless delay is used for timeout.
+    m_event_waiting_for_has_processed = true;
 
-                    // erase it 
-                    m_event_received_from_others.erase(it);
+    mavlinksdk::CMavlinkCommand::getInstance().setCurrentMission(*seq + 2);
+    
+    std::cout << "event: " << m_event_waiting_for << " : found. Continue from task Key: " << *seq << std::endl ;
 
-                    return;
-                }
-                
-                std::cout << "mission3: skip" << key << std::endl;
-                
-            }
-        }
-    }
+    // erase it 
+    m_event_received_from_others.erase(it);
 }
 
 
@@ -434,7 +449,7 @@ void CMissionManager::readWaitingEventFromFCB(const mavlink_servo_output_raw_t &
     if (m_mavlink_event_waiting_for != event_value)
     {   // new event has been fired.
         m_mavlink_event_waiting_for = event_value;
-        de::fcb::mission::CMissionManager::getInstance().setCurrentWaitingEvent(std::to_string(event_value));
+        de::fcb::mission::CMissionManager::getInstance().setCurrentWaitingEvent(event_value);
         CFCBFacade::getInstance().sendErrorMessage(std::string(ANDRUAV_PROTOCOL_SENDER_ALL_GCS), 0, ERROR_TYPE_LO7ETTA7AKOM, NOTIFICATION_TYPE_WARNING, std::string("Wait Event:") + std::to_string(m_mavlink_event_waiting_for));
     }
     
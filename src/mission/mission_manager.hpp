@@ -2,12 +2,17 @@
 #define MISSION_MANAGER_H_
 
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <mavlink_command.h>
 #include <mavlink_sdk.h>
 
 #include "missions.hpp"
+#include "mission_geometry.hpp"
 #include "../de_general_mission_planner/mission_manager_base.hpp"
 
 #define AP_EVENT_DISABLED 0
@@ -79,7 +84,7 @@ namespace mission
 
             public:
 
-                inline void setCurrentWaitingEvent(const std::string event_id)
+                inline void setCurrentWaitingEvent(const int event_id)
                 {
                     m_event_waiting_for = event_id;
                     m_event_waiting_for_has_processed = false;
@@ -98,6 +103,7 @@ namespace mission
                 {
                     m_event_fire_channel = event_fire_channel; 
                     m_event_wait_channel = event_wait_channel;
+                    m_waiting_event_index_valid = false;
                 }
                 
 
@@ -106,6 +112,24 @@ namespace mission
                     return m_andruav_missions;      
                 } 
 
+                /**
+                * @brief leg geometry of current mission. It is rebuilt only when mission changes.
+                * Callers on other threads keep their copy while a newer one is built.
+                * 
+                */
+                inline std::shared_ptr<const CMissionGeometry> getMissionGeometry()
+                {
+                    const std::lock_guard<std::mutex> lock(m_mission_geometry_lock);
+                    if ((m_mission_geometry == nullptr) || (!m_mission_geometry->isBuiltFor(m_andruav_missions.version)))
+                    {
+                        std::shared_ptr<CMissionGeometry> mission_geometry = std::make_shared<CMissionGeometry>();
+                        mission_geometry->build(m_andruav_missions);
+                        m_mission_geometry = mission_geometry;
+                    }
+                    
+                    return m_mission_geometry;
+                }
+
             protected:
 
                 inline void addMissionItem(int id, std::unique_ptr<CMissionItem> item) {
@@ -113,16 +137,29 @@ namespace mission
                     m_mission_items[id] = std::move(item);
                 }
 
+                void updateWaitingEventIndex ();
+
         
             private:
 
-                std::string m_event_waiting_for;
+                int m_event_waiting_for;
                 bool m_event_waiting_for_has_processed;
                 std::map <int, std::unique_ptr<CMissionItem>> m_mission_items;
                 de::fcb::mission::ANDRUAV_UNIT_MISSION m_andruav_missions;      
+                std::shared_ptr<const CMissionGeometry> m_mission_geometry;
+                std::mutex m_mission_geometry_lock;
 
                 
-                std::vector<std::string>  m_event_received_from_others;
+                std::unordered_set<int>  m_event_received_from_others;
+
+                /**
+                * @brief event id -> sorted seq of DO_SET_SERVO items on wait channel that wait for it.
+                * Rebuilt only when mission version changes.
+                * 
+                */
+                std::unordered_map<int, std::vector<int>> m_waiting_event_index;
+                uint32_t m_waiting_event_index_version = 0;
+                bool m_waiting_event_index_valid = false;
             
                 //event sent from Ardupilot-Board (RCOUT) to indicate that it is waiting for it.
                 int m_mavlink_event_waiting_for;
@@ -1,4 +1,6 @@
 #include <vector>
+#include <cstring>
+#include <cstdlib>
 
 #include <all/mavlink.h>
 
@@ -11,116 +13,361 @@ using Json_de = nlohmann::json;
 
 #include <all/mavlink.h>
 #include "mission_translator.hpp"
-extern std::vector<std::string> split_string_by_newline(const std::string& str);
-extern std::vector<std::string> split_string_by_delimeter(const std::string& str, const char& delimeter);
 
 using namespace de::fcb::mission;
 
-std::unique_ptr<std::map <int, std::unique_ptr<CMissionItem>>>   CMissionTranslator::translateQGCFormat (const std::string& mission_text)
+
+/**
+ * @brief SAX handler of QGC plan files.
+ * @details Only root "fileType", "mission.plannedHomePosition" and items of "mission.items" are read.
+ * Complex items (surveys, corridor scans) are expanded into the simple items QGC saved in
+ * "TransectStyleComplexItem.Items". A complex item without them (e.g. structure scan) makes the plan invalid.
+ * Every other value is skipped while being parsed. Each item is written to the output array once its object is closed.
+ *
+ */
+class CQGCPlanSaxReader
 {
-    try
-    {
-        std::unique_ptr<std::map <int, std::unique_ptr<CMissionItem>>> mission_items = std::unique_ptr<std::map <int, std::unique_ptr<CMissionItem>>> (new std::map <int, std::unique_ptr<CMissionItem>>);
-        //std::unique_ptr <de::fcb::mission::ANDRUAV_UNIT_MISSION> andruav_mission = std::unique_ptr<de::fcb::mission::ANDRUAV_UNIT_MISSION> ();
+    public:
 
-        Json_de mission = Json_de::parse(mission_text);
-        if (std::string(mission["fileType"]).find("Plan") != std::string::npos)
+        CQGCPlanSaxReader (std::vector<mavlink_mission_item_int_t>& mavlink_mission)
+        : m_mavlink_mission(mavlink_mission)
         {
-            if ((mission.contains("mission") != true) || (mission["mission"].type() != Json_de::value_t::object))
-            {
-                return std::nullptr_t();
-            }
-            
-            Json_de  homePosition = mission["mission"]["plannedHomePosition"]; 
-            Json_de  missionlist  = mission["mission"]["items"];
-            const int mission_item_count = missionlist.size();
-            if (mission_item_count == 0)
-            {
-                return std::nullptr_t();
-            }
+            m_context.reserve(16);
+        }
+
+    public:
+
+        bool isValid () const
+        {
+            return m_is_plan && m_has_home && !m_has_unsupported_item;
+        }
 
-            // mission zero is home position
-            mavlink_mission_item_int_t mavlink_mission_item;
+        void buildHome (mavlink_mission_item_int_t& mavlink_mission_item) const
+        {
             mavlink_mission_item.seq = 0; // message zero is home
             mavlink_mission_item.frame = MAV_FRAME_GLOBAL_RELATIVE_ALT;
             mavlink_mission_item.autocontinue = 1;
             mavlink_mission_item.current = false;
             mavlink_mission_item.command = MAV_CMD_NAV_WAYPOINT;
-            mavlink_mission_item.param1 = 0;
-            mavlink_mission_item.param2 = 0;
-            mavlink_mission_item.param3 = 0;
-            mavlink_mission_item.param4 = 0;
-            mavlink_mission_item.x = homePosition[0].get<double>() * 10000000;
-            mavlink_mission_item.y = homePosition[1].get<double>() * 10000000;
-            mavlink_mission_item.z = homePosition[2].get<int>();
+            mavlink_mission_item.x = m_home[0] * 10000000;
+            mavlink_mission_item.y = m_home[1] * 10000000;
+            mavlink_mission_item.z = (int) m_home[2];
+            mavlink_mission_item.mission_type = MAV_MISSION_TYPE_MISSION;
+        }
+
+    public:
+
+        // nlohmann SAX interface.
+
+        bool null ()
+        {
+            return value(0.0);
+        }
+
+        bool boolean (bool val)
+        {
+            if ((top() == CONTEXT_ITEM) && (m_key == "autoContinue"))
+            {
+                m_item.autocontinue = val ? 1 : 0;
+            }
+            return true;
+        }
+
+        bool number_integer (Json_de::number_integer_t val)
+        {
+            return value((double) val);
+        }
+
+        bool number_unsigned (Json_de::number_unsigned_t val)
+        {
+            return value((double) val);
+        }
+
+        bool number_float (Json_de::number_float_t val, const Json_de::string_t& s)
+        {
+            return value(val);
+        }
+
+        bool string (Json_de::string_t& val)
+        {
+            if ((top() == CONTEXT_ROOT) && (m_key == "fileType"))
+            {
+                m_is_plan = (val.find("Plan") != std::string::npos);
+            }
+            else if ((top() == CONTEXT_ITEM) && (m_key == "type") && (val == "ComplexItem"))
+            {
+                m_is_complex_item = true;
+            }
+            return true;
+        }
+
+        template <typename BINARY>
+        bool binary (BINARY& val)
+        {
+            return true;
+        }
 
-            de::fcb::mission::CMissionItem *mission_item = de::fcb::mission::CMissionItemBuilder::getClassByMavlinkCMD(mavlink_mission_item);
-            if (mission_item != nullptr)
+        bool start_object (std::size_t elements)
+        {
+            const CONTEXT parent = top();
+            if (m_context.empty())
+            {
+                m_context.push_back(CONTEXT_ROOT);
+            }
+            else if ((parent == CONTEXT_ROOT) && (m_key == "mission"))
             {
-                mission_item->decodeMavlink (mavlink_mission_item);
-                mission_items.get()->insert(std::make_pair( mavlink_mission_item.seq, std::unique_ptr<de::fcb::mission::CMissionItem>(mission_item)));
+                m_context.push_back(CONTEXT_MISSION);
             }
+            else if ((parent == CONTEXT_ITEMS) || (parent == CONTEXT_COMPLEX_ITEMS))
+            {
+                if (parent == CONTEXT_ITEMS)
+                {
+                    // item of plan. Items of a complex item are added after this index.
+                    m_is_complex_item = false;
+                    m_item_first_seq = m_mavlink_mission.size();
+                }
 
-            // remaining messages
-            for (int i=0; i< mission_item_count; ++i)
+                m_context.push_back(CONTEXT_ITEM);
+                m_item = mavlink_mission_item_int_t();
+                m_item.autocontinue = 1;
+                m_item.mission_type = MAV_MISSION_TYPE_MISSION;
+                m_has_command = false;
+            }
+            else if ((parent == CONTEXT_ITEM) && (m_key == "TransectStyleComplexItem"))
             {
-                Json_de mission_item_element = missionlist[i];
-                std::string type = mission_item_element["type"].get<std::string>();
-                bool auto_continue = mission_item_element["autoContinue"].get<bool>();
-                int command = mission_item_element["command"].get<int>();
-                int frame = mission_item_element["frame"].get<int>();
-                double param[7];
+                m_context.push_back(CONTEXT_TRANSECT);
+            }
+            else
+            {
+                m_context.push_back(CONTEXT_OTHER);
+            }
 
-                for (int i=0; i<7; ++i)
+            return true;
+        }
+
+        bool end_object ()
+        {
+            if (top() == CONTEXT_ITEM)
+            {
+                if (m_has_command)
                 {
-                    param[i] = mission_item_element["params"][i].is_null()?0:mission_item_element["params"][i].get<double>();    
+                    // seq zero is home.
+                    m_item.seq = m_mavlink_mission.size();
+                    m_mavlink_mission.push_back(m_item);
+                    m_has_command = false;
+
+                    #ifdef DEBUG
+                        std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: translateMissionText command:" << std::to_string(m_item.command) << _NORMAL_CONSOLE_TEXT_ << std::endl;
+                    #endif
                 }
 
-                    
-                mavlink_mission_item_int_t mavlink_mission_item;
-                mavlink_mission_item.seq = i+1; // message zero is home
-                mavlink_mission_item.frame = frame;
-                mavlink_mission_item.autocontinue = auto_continue?1:0;
-                mavlink_mission_item.current = false;
-                mavlink_mission_item.command = command;
-                mavlink_mission_item.param1 = param[0];
-                mavlink_mission_item.param2 = param[1];
-                mavlink_mission_item.param3 = param[2];
-                mavlink_mission_item.param4 = param[3];
-                mavlink_mission_item.x = param[4] * 10000000;
-                mavlink_mission_item.y = param[5] * 10000000;
-                mavlink_mission_item.z = param[6];
-
-                de::fcb::mission::CMissionItem *mission_item = de::fcb::mission::CMissionItemBuilder::getClassByMavlinkCMD(mavlink_mission_item);
-                if (mission_item != nullptr)
+                if ((parent() == CONTEXT_ITEMS) && m_is_complex_item && (m_mavlink_mission.size() == m_item_first_seq))
                 {
-                    mission_item->decodeMavlink (mavlink_mission_item);
-                    mission_items.get()->insert(std::make_pair( mavlink_mission_item.seq, std::unique_ptr<de::fcb::mission::CMissionItem>(mission_item)));
+                    // complex item that has no saved simple items cannot be uploaded.
+                    m_has_unsupported_item = true;
+
+                    #ifdef DEBUG
+                        std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _ERROR_CONSOLE_TEXT_ << "DEBUG: complex item has no items" << _NORMAL_CONSOLE_TEXT_ << std::endl;
+                    #endif
                 }
-                    
-                #ifdef DEBUG
-                    std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: translateMissionText " << type << " command:" << std::to_string(command) << _NORMAL_CONSOLE_TEXT_ << std::endl;
-                #endif
             }
+
+            m_context.pop_back();
+            return true;
         }
 
-            return std::move(mission_items);
-        
+        bool start_array (std::size_t elements)
+        {
+            const CONTEXT parent = top();
+            m_index = 0;
+            if ((parent == CONTEXT_MISSION) && (m_key == "plannedHomePosition"))
+            {
+                m_context.push_back(CONTEXT_HOME);
+            }
+            else if ((parent == CONTEXT_MISSION) && (m_key == "items"))
+            {
+                m_context.push_back(CONTEXT_ITEMS);
+            }
+            else if ((parent == CONTEXT_TRANSECT) && (m_key == "Items"))
+            {
+                m_context.push_back(CONTEXT_COMPLEX_ITEMS);
+            }
+            else if ((parent == CONTEXT_ITEM) && (m_key == "params"))
+            {
+                m_context.push_back(CONTEXT_PARAMS);
+            }
+            else
+            {
+                m_context.push_back(CONTEXT_OTHER);
+            }
+
+            return true;
+        }
+
+        bool end_array ()
+        {
+            if (top() == CONTEXT_HOME)
+            {
+                m_has_home = (m_index >= 3);
+            }
+
+            m_context.pop_back();
+            return true;
+        }
+
+        bool key (Json_de::string_t& val)
+        {
+            m_key = val;
+            return true;
+        }
+
+        bool parse_error (std::size_t position, const std::string& last_token, const nlohmann::detail::exception& ex)
+        {
+            std::cerr << ex.what() << '\n';
+            return false;
+        }
+
+    protected:
+
+        typedef enum CONTEXT
+        {
+            CONTEXT_NONE        = 0,
+            CONTEXT_ROOT        = 1,
+            CONTEXT_MISSION     = 2,
+            CONTEXT_HOME        = 3,
+            CONTEXT_ITEMS       = 4,
+            CONTEXT_ITEM        = 5,
+            CONTEXT_PARAMS      = 6,
+            CONTEXT_OTHER       = 7,
+            CONTEXT_TRANSECT    = 8,    // "TransectStyleComplexItem" of a complex item.
+            CONTEXT_COMPLEX_ITEMS = 9   // "Items" array of a complex item.
+        } CONTEXT;
+
+        inline CONTEXT top () const
+        {
+            return m_context.empty() ? CONTEXT_NONE : m_context.back();
+        }
+
+        inline CONTEXT parent () const
+        {
+            return (m_context.size() < 2) ? CONTEXT_NONE : m_context[m_context.size() - 2];
+        }
+
+        bool value (const double val)
+        {
+            switch (top())
+            {
+                case CONTEXT_HOME:
+                    if (m_index < 3) m_home[m_index] = val;
+                    m_index++;
+                    break;
+
+                case CONTEXT_PARAMS:
+                    switch (m_index)
+                    {
+                        case 0: m_item.param1 = val; break;
+                        case 1: m_item.param2 = val; break;
+                        case 2: m_item.param3 = val; break;
+                        case 3: m_item.param4 = val; break;
+                        case 4: m_item.x = val * 10000000; break;
+                        case 5: m_item.y = val * 10000000; break;
+                        case 6: m_item.z = val; break;
+                        default: break;
+                    }
+                    m_index++;
+                    break;
+
+                case CONTEXT_ITEM:
+                    if (m_key == "command")
+                    {
+                        m_item.command = (uint16_t) val;
+                        m_has_command = true;
+                    }
+                    else if (m_key == "frame")
+                    {
+                        m_item.frame = (uint8_t) val;
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+
+            return true;
+        }
+
+    private:
+
+        std::vector<mavlink_mission_item_int_t>& m_mavlink_mission;
+
+        std::vector<CONTEXT> m_context;
+        std::string m_key;
+        int m_index = 0;
+
+        mavlink_mission_item_int_t m_item;
+        bool m_has_command = false;
+        bool m_is_complex_item = false;
+        std::size_t m_item_first_seq = 0;
+        bool m_has_unsupported_item = false;
+
+        double m_home[3] = {0};
+        bool m_has_home = false;
+        bool m_is_plan = false;
+};
+
+
+/**
+ * @brief counts occurrences of pattern. Used to reserve output array before parsing.
+ *
+ */
+static std::size_t countOccurrences (const std::string& text, const char* pattern)
+{
+    const std::size_t pattern_length = strlen(pattern);
+    std::size_t count = 0;
+    std::size_t position = text.find(pattern);
+    while (position != std::string::npos)
+    {
+        ++count;
+        position = text.find(pattern, position + pattern_length);
+    }
+
+    return count;
+}
+
+
+bool CMissionTranslator::translateQGCFormat (const std::string& mission_text, std::vector<mavlink_mission_item_int_t>& mavlink_mission)
+{
+    mavlink_mission.clear();
+    mavlink_mission.reserve(countOccurrences(mission_text, "\"command\"") + 1);
+
+    // item zero is home and is filled once home position is parsed.
+    mavlink_mission.push_back(mavlink_mission_item_int_t());
+
+    CQGCPlanSaxReader reader(mavlink_mission);
+
+    try
+    {
+        if (!Json_de::sax_parse(mission_text, &reader)) return false;
     }
-            
     catch(const std::exception& e)
     {
-    std::cerr << e.what() << '\n';
+        std::cerr << e.what() << '\n';
+        return false;
     }
-        
-    
+
+    if (!reader.isValid() || (mavlink_mission.size() <= 1))
+    {
+        return false;
+    }
+
+    reader.buildHome(mavlink_mission[0]);
+
+    return true;
 }
 
-std::unique_ptr<std::map <int, std::unique_ptr<CMissionItem>>>   CMissionTranslator::translateMPFormat (const std::string& mission_text)
-{
-    std::unique_ptr<std::map <int, std::unique_ptr<CMissionItem>>> mission_items = std::unique_ptr<std::map <int, std::unique_ptr<CMissionItem>>> (new std::map <int, std::unique_ptr<CMissionItem>>);
-    //std::unique_ptr <de::fcb::mission::ANDRUAV_UNIT_MISSION> andruav_mission = std::unique_ptr<de::fcb::mission::ANDRUAV_UNIT_MISSION> ();
 
+bool CMissionTranslator::translateMPFormat (const std::string& mission_text, std::vector<mavlink_mission_item_int_t>& mavlink_mission)
+{
     /**************
     // Mission Planner File Format
     // QGC WPL <VERSION>
@@ -135,89 +382,78 @@ std::unique_ptr<std::map <int, std::unique_ptr<CMissionItem>>>   CMissionTransla
                 4	0	3	16	0.000000	0.000000	0.000000	0.000000	30.164126	32.783203	100.000000	1
                 5	0	3	16	0.000000	0.000000	0.000000	0.000000	30.315988	33.178711	100.000000	1
                 6	0	3	21	0.000000	0.000000	0.000000	0.000000	30.977609	33.420410	100.000000	1
-         
+
     ***************/
 
     #ifdef DEBUG
         std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  << _LOG_CONSOLE_TEXT << "DEBUG: QGC WPL 110 " << _NORMAL_CONSOLE_TEXT_ << std::endl;
     #endif
-    
-    try
+
+    mavlink_mission.clear();
+    mavlink_mission.reserve(countOccurrences(mission_text, "\n"));
+
+    // fields are parsed in place. A field that would be read from the next line marks a short line.
+    const char* text = mission_text.c_str();
+    const char* const text_end = text + mission_text.size();
+
+    // skip header "QGC WPL 110"
+    const char* line = static_cast<const char*>(memchr(text, '\n', text_end - text));
+    if (line == nullptr) return false;
+    ++line;
+
+    while (line < text_end)
     {
-        /* code */
-
-        std::vector<std::string> v = split_string_by_newline(mission_text);
-        const int length = v.size();
-        if (length <= 1) 
-        {
-            // only QGC WPL 110 or empty
-            return  std::nullptr_t();
-        }
-            
-        for (int i=1; i < length; ++i)
-        {
-            std::vector<std::string> task = split_string_by_delimeter (v[i],'\t');
-            if (task.size()<11) continue ; // extra line
-            #ifdef DEBUG
-                std::cout <<__FILE__ << "." << __FUNCTION__ << " line:" << __LINE__ << "  "  
-                << _LOG_CONSOLE_TEXT << "Line " << task.size() << _NORMAL_CONSOLE_TEXT_ << std::endl;
-            #endif
-
-            mavlink_mission_item_int_t mavlink_mission_item;
-            mavlink_mission_item.seq = stoi(task[0]); //i-1; // message zero is home
-            mavlink_mission_item.frame = stoi(task[2]);
-            mavlink_mission_item.autocontinue = stoi(task[11]);
-            mavlink_mission_item.current = stoi(task[1]);
-            mavlink_mission_item.command = stoi(task[3]);
-            mavlink_mission_item.param1 = std::stod(task[4]);
-            mavlink_mission_item.param2 = std::stod(task[5]);
-            mavlink_mission_item.param3 = std::stod(task[6]);
-            mavlink_mission_item.param4 = std::stod(task[7]);
-            mavlink_mission_item.x = std::stod(task[8]) * 10000000;
-            mavlink_mission_item.y = std::stod(task[9]) * 10000000;
-            mavlink_mission_item.z = std::stod(task[10]);
-            mavlink_mission_item.mission_type = MAV_MISSION_TYPE_MISSION;
+        const char* line_end = static_cast<const char*>(memchr(line, '\n', text_end - line));
+        if (line_end == nullptr) line_end = text_end;
 
-            de::fcb::mission::CMissionItem *mission_item = de::fcb::mission::CMissionItemBuilder::getClassByMavlinkCMD(mavlink_mission_item);
-            if (mission_item != nullptr)
-            {
-                mission_item->decodeMavlink (mavlink_mission_item);
-                mission_items.get()->insert(std::make_pair( mavlink_mission_item.seq, std::unique_ptr<de::fcb::mission::CMissionItem>(mission_item)));
-            }
-                    
+        double field[12];
+        int field_count = 0;
+        const char* position = line;
+        while (field_count < 12)
+        {
+            char* field_end;
+            const double value = strtod(position, &field_end);
+            if ((field_end == position) || (field_end > line_end)) break;
+            field[field_count++] = value;
+            position = field_end;
         }
 
-        return std::move(mission_items);
-            
-    }
-    catch(const std::exception& e)
-    {
-        std::cerr << e.what() << '\n';
-        return std::move(mission_items);
+        line = line_end + 1;
+
+        if (field_count < 11) continue ; // extra line
+
+        mavlink_mission_item_int_t mavlink_mission_item = mavlink_mission_item_int_t();
+        mavlink_mission_item.seq = mavlink_mission.size(); // message zero is home
+        mavlink_mission_item.frame = (uint8_t) field[2];
+        mavlink_mission_item.autocontinue = (field_count > 11) ? (uint8_t) field[11] : 1;
+        mavlink_mission_item.current = (uint8_t) field[1];
+        mavlink_mission_item.command = (uint16_t) field[3];
+        mavlink_mission_item.param1 = field[4];
+        mavlink_mission_item.param2 = field[5];
+        mavlink_mission_item.param3 = field[6];
+        mavlink_mission_item.param4 = field[7];
+        mavlink_mission_item.x = field[8] * 10000000;
+        mavlink_mission_item.y = field[9] * 10000000;
+        mavlink_mission_item.z = field[10];
+        mavlink_mission_item.mission_type = MAV_MISSION_TYPE_MISSION;
+
+        mavlink_mission.push_back(mavlink_mission_item);
     }
 
+    return !mavlink_mission.empty();
 }
 
 
 
-std::unique_ptr<std::map <int, std::unique_ptr<CMissionItem>>>  CMissionTranslator::translateMissionText (const std::string& mission_text)
+bool CMissionTranslator::translateMissionText (const std::string& mission_text, std::vector<mavlink_mission_item_int_t>& mavlink_mission)
 {
-    
+
     if (mission_text.find("QGC WPL 110") != std::string::npos)
     {
-        return translateMPFormat (mission_text);
-        
+        return translateMPFormat (mission_text, mavlink_mission);
     }
-    else 
-    {
-        Json_de mission = Json_de::parse(mission_text);
-        if (validateField(mission, "fileType",Json_de::value_t::string)) 
-        {
-            return translateQGCFormat (mission_text);
-        }
-    
 
-        
-    }
+    return translateQGCFormat (mission_text, mavlink_mission);
 }
 
+
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <memory>
+#include <vector>
 
 #include "missions.hpp"
 
@@ -12,23 +13,38 @@ namespace fcb
 {
 namespace mission
 {
-    class CMissionTranslator 
+    /**
+     * @brief translates QGC plan & Mission Planner waypoint files into mavlink mission items.
+     * @details Files are parsed in a single streaming pass. QGC plans are read using SAX events so no
+     * JSON document is built, and Mission Planner files are read in place without splitting lines.
+     * Items are written into a contiguous array that is reserved once, so large surveys do not
+     * allocate per item.
+     *
+     */
+    class CMissionTranslator
     {
         public:
 
-            std::unique_ptr<std::map <int, std::unique_ptr<CMissionItem>>> translateMissionText (const std::string& mission_text);
+            /**
+             * @brief translate plan text into mavlink_mission items. Item zero is home.
+             *
+             * @param mission_text QGC plan or Mission Planner "QGC WPL 110" text.
+             * @param mavlink_mission output items. item index equals its seq.
+             * @return false if text is not a valid plan or has no items.
+             */
+            bool translateMissionText (const std::string& mission_text, std::vector<mavlink_mission_item_int_t>& mavlink_mission);
 
             void extractPlanModule (const Json_de& plan);
 
 
         protected:
 
-            std::unique_ptr<std::map <int, std::unique_ptr<CMissionItem>>> translateQGCFormat (const std::string& mission_text);
-            std::unique_ptr<std::map <int, std::unique_ptr<CMissionItem>>> translateMPFormat (const std::string& mission_text);
-            
+            bool translateQGCFormat (const std::string& mission_text, std::vector<mavlink_mission_item_int_t>& mavlink_mission);
+            bool translateMPFormat (const std::string& mission_text, std::vector<mavlink_mission_item_int_t>& mavlink_mission);
+
     };
 }
 }
 }
 
-#endif
\ No newline at end of file
+#endif
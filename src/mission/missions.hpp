@@ -3,6 +3,7 @@
 
 #include <map>
 #include <memory>
+#include <atomic>
 #include <iostream>
 #include <all/mavlink.h>
 
@@ -748,10 +749,27 @@ typedef struct ANDRUAV_UNIT_MISSION
     ANDRUAV_MISSION_TYPE mission_type;
     std::map <int, std::unique_ptr<CMissionItem>> mission_items;
 
+    /**
+     * @brief incremented whenever mission_items changes. Used to invalidate cached waypoint pages.
+     * 
+     */
+    std::atomic<uint32_t> version {0};
+
     void clear ()
     {
         mission_type = ANDRUAV_MISSION_UNKNOWN;
         mission_items.clear();
+        ++version;
+    }
+
+    /**
+     * @brief items are usually added in seq order so end is used as insert hint.
+     * 
+     */
+    void addMissionItem (const int seq, std::unique_ptr<CMissionItem> mission_item)
+    {
+        mission_items.emplace_hint(mission_items.end(), seq, std::move(mission_item));
+        ++version;
     }
 
 } ANDRUAV_UNIT_MISSION;
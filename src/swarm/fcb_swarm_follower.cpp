@@ -1,4 +1,6 @@
 
+#include <mavlink_setpoint_channel.h>
+
 #include "fcb_swarm_follower.hpp"
 #include "../fcb_facade.hpp"
 #include "../fcb_main.hpp"
@@ -67,7 +69,7 @@ void CSwarmFollower::updateFollowerInThreadFormation()
     POINT_2D p = get_point_at_bearing(leader_lat, leader_lon, bearing_with_leader, base_distance);  // getpoint using bearing and distance.
 
     // instruct follower to go to a target point.
-    mavlinksdk::CMavlinkCommand::getInstance().gotoGuidedPoint(p.latitude , p.longitude , (m_leader_gpos_new.relative_alt + (follower_index +1) * m_min_vertical_distance * 1000) / 1000.0f);
+    mavlinksdk::CMavlinkSetpointChannel::getInstance().gotoGuidedPoint(p.latitude , p.longitude , (m_leader_gpos_new.relative_alt + (follower_index +1) * m_min_vertical_distance * 1000) / 1000.0f);
 
     // broadcast target location or this follower.
     CFCBFacade::getInstance().sendFCBTargetLocation("", p.latitude , p.longitude, (double) m_leader_gpos_new.relative_alt, DESTINATION_SWARM_MY_LOCATION);
@@ -126,7 +128,7 @@ void CSwarmFollower::updateFollowerInArrowFormation()
     POINT_2D p = get_point_at_bearing(leader_lat, leader_lon, leader_velocity_vector_bearing + angle_offset, base_distance);
 
     // Instruct follower to go to the target point
-    mavlinksdk::CMavlinkCommand::getInstance().gotoGuidedPoint(p.latitude, p.longitude, (m_leader_gpos_new.relative_alt + (follower_index + 1) * m_min_vertical_distance * 1000) / 1000.0f);
+    mavlinksdk::CMavlinkSetpointChannel::getInstance().gotoGuidedPoint(p.latitude, p.longitude, (m_leader_gpos_new.relative_alt + (follower_index + 1) * m_min_vertical_distance * 1000) / 1000.0f);
 
     // Broadcast target location for this follower
     CFCBFacade::getInstance().sendFCBTargetLocation("", p.latitude, p.longitude, (double)m_leader_gpos_new.relative_alt, DESTINATION_SWARM_MY_LOCATION);
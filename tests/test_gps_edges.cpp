@@ -0,0 +1,108 @@
+/**
+ * @brief structure of arrays edge kernel against scalar geometry.
+ * @details Distances of findDistanceToLocalEdges are compared with findDistanceToLocalSegment and
+ * findDistanceToSegment over each edge, and its crossing parity with inLocalPolygon & inPolygon.
+ * gps_edges.cpp is built with the same vectorization flags as de_mavlink.
+ *
+ */
+#include <iostream>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "../src/helpers/gps.hpp"
+#include "../src/helpers/gps_edges.hpp"
+
+
+#define POLYGON_COUNT           200
+#define POINTS_PER_POLYGON      200
+#define LOCAL_TOLERANCE         1e-6        // [m] kernel against same math done edge by edge.
+#define GEODESIC_TOLERANCE      0.02        // relative difference to findDistanceToSegment.
+
+
+int main ()
+{
+    std::mt19937 random(3);
+    std::uniform_real_distribution<double> uniform(0, 1);
+
+    const double ref_lat = 30.0;
+    const double ref_lng = 31.0;
+
+    int failures = 0;
+    int tests = 0;
+    double max_local_error = 0;
+    double max_geodesic_error = 0;
+
+    for (int polygon = 0; polygon < POLYGON_COUNT; ++polygon)
+    {
+        const int count = 3 + random() % 60;
+        std::vector<POINT_3D> vertices(count);
+        std::vector<POINT_LOCAL> points(count);
+        for (int k = 0; k < count; ++k)
+        {
+            const double angle = k * 2 * M_PI / count;
+            const double radius = 0.005 + 0.01 * uniform(random);
+            vertices[k].latitude = ref_lat + radius * cos(angle);
+            vertices[k].longitude = ref_lng + radius * sin(angle);
+            vertices[k].altitude = 0;
+        }
+        // zero length edge.
+        if (polygon % 10 == 0) vertices[1] = vertices[0];
+
+        for (int k = 0; k < count; ++k)
+        {
+            points[k] = toLocalPoint(vertices[k].latitude, vertices[k].longitude, vertices[0].latitude, vertices[0].longitude);
+        }
+
+        // odd polygons are tested as open polylines.
+        const bool closed = (polygon % 2 == 0);
+        LOCAL_EDGES edges;
+        buildLocalEdges(points, closed, edges);
+
+        for (int q = 0; q < POINTS_PER_POLYGON; ++q)
+        {
+            const double lat = ref_lat - 0.03 + 0.06 * uniform(random);
+            const double lng = ref_lng - 0.03 + 0.06 * uniform(random);
+            const POINT_LOCAL point = toLocalPoint(lat, lng, vertices[0].latitude, vertices[0].longitude);
+
+            int crossings;
+            const double distance = findDistanceToLocalEdges(point, edges, crossings);
+
+            double local_distance = DBL_MAX;
+            double geodesic_distance = DBL_MAX;
+            for (int i = closed ? 0 : 1, j = closed ? count - 1 : 0; i < count; j = i++)
+            {
+                local_distance = std::min(local_distance, findDistanceToLocalSegment(point, points[j], points[i]));
+                geodesic_distance = std::min(geodesic_distance, findDistanceToSegment(lat, lng, vertices[j].latitude, vertices[j].longitude, vertices[i].latitude, vertices[i].longitude));
+            }
+
+            const double local_error = fabs(distance - local_distance);
+            const double geodesic_error = fabs(distance - geodesic_distance) / std::max(geodesic_distance, 1.0);
+            max_local_error = std::max(max_local_error, local_error);
+            max_geodesic_error = std::max(max_geodesic_error, geodesic_error);
+            tests++;
+
+            if ((local_error > LOCAL_TOLERANCE) || (geodesic_error > GEODESIC_TOLERANCE))
+            {
+                std::cout << "FAIL: polygon " << polygon << " distance " << distance << " instead of " << local_distance << " / " << geodesic_distance << std::endl;
+                failures++;
+                continue;
+            }
+
+            if (!closed) continue;
+
+            const bool inside = (crossings & 1);
+            if ((inside != inLocalPolygon(point, points)) || (inside != (inPolygon(lat, lng, vertices) == 1)))
+            {
+                std::cout << "FAIL: polygon " << polygon << " inside " << inside << " does not match scalar test" << std::endl;
+                failures++;
+            }
+        }
+    }
+
+    std::cout << "points: " << tests << " max local error: " << max_local_error << " m max geodesic difference: " << max_geodesic_error * 100 << "%" << std::endl;
+
+    return (failures == 0) ? 0 : 1;
+}